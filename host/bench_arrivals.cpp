@@ -0,0 +1,67 @@
+// Host benchmark: ArrivalModel's integer inverse-CDF sampler
+//
+// Build and run from the project root:
+//   g++ -O2 -std=c++11 -Iinclude host/bench_arrivals.cpp src/ArrivalModel.cpp -o bench_arrivals && ./bench_arrivals
+//
+// Reports cost per sample against a floating point -mean*ln(u) reference
+// (what the AVR would need soft-float log() for) and checks that the
+// samples really are exponential: mean, coefficient of variation and
+// the fraction below the mean (1 - 1/e for an exponential).
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "ArrivalModel.h"
+
+static const int ITERATIONS = 20000000;
+
+int main() {
+    const uint16_t CALLS_PER_HOUR = 720;  // 12 calls/minute -> 5000ms mean gap
+    const double expectedMean = 3600000.0 / CALLS_PER_HOUR;
+    
+    ArrivalModel model;
+    model.seed(12345, 0xFF);
+    model.setCallsPerHour(CALLS_PER_HOUR);
+    
+    // Integer table sampler
+    double sum = 0, sumSquares = 0;
+    long belowMean = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        unsigned long gap = model.sampleInterArrival();
+        sum += gap;
+        sumSquares += (double)gap * gap;
+        if (gap < expectedMean) belowMean++;
+    }
+    auto end = std::chrono::steady_clock::now();
+    double tableNs = std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+    
+    // Floating point reference using the same uniform source
+    FastRandom rng;
+    rng.seed(12345, 0xFF);
+    volatile double sink = 0;
+    double floatSum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        double u = (rng.below(0x10000UL) + 0.5) / 65536.0;
+        floatSum += -expectedMean * std::log(u);
+    }
+    end = std::chrono::steady_clock::now();
+    sink = floatSum;
+    double floatNs = std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+    
+    double mean = sum / ITERATIONS;
+    double stddev = std::sqrt(sumSquares / ITERATIONS - mean * mean);
+    double fractionBelow = (double)belowMean / ITERATIONS;
+    
+    printf("sampler cost: table %.2f ns, float log() %.2f ns\n", tableNs, floatNs);
+    printf("mean gap: %.1f ms (expected %.1f, error %+.2f%%)\n",
+           mean, expectedMean, 100.0 * (mean - expectedMean) / expectedMean);
+    printf("coefficient of variation: %.3f (exponential = 1.000)\n", stddev / mean);
+    printf("fraction below mean: %.4f (exponential = %.4f)\n", fractionBelow, 1.0 - std::exp(-1.0));
+    
+    (void)sink;
+    bool ok = std::fabs(mean - expectedMean) / expectedMean < 0.01 &&
+              std::fabs(stddev / mean - 1.0) < 0.02;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+// Host benchmark: FastRandom vs the Arduino/avr-libc random() it replaced
+//
+// Build and run from the project root:
+//   g++ -O2 -std=c++11 -Iinclude host/bench_random.cpp -o bench_random && ./bench_random
+//
+// Host timings only show the relative cost. On the AVR the gap is wider:
+// random() does a 32-bit divide and modulo per call (no hardware divider),
+// FastRandom is shifts, xors and at most one multiply.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include "FastRandom.h"
+
+// avr-libc random(): Park-Miller "minimal standard" generator
+static uint32_t avrNext = 1;
+
+static long avrRandom() {
+    long hi, lo, x;
+    x = (long)avrNext;
+    if (x == 0) x = 123459876L;
+    hi = x / 127773L;
+    lo = x % 127773L;
+    x = 16807L * lo - 2836L * hi;
+    if (x < 0) x += 0x7fffffffL;
+    avrNext = (uint32_t)x;
+    return x % ((unsigned long)0x7fffffffL + 1);
+}
+
+// Arduino core random(min, max)
+static long arduinoRandom(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    long diff = howbig - howsmall;
+    long howbigMod = avrRandom() % diff;
+    return howbigMod + howsmall;
+}
+
+static const int ITERATIONS = 20000000;
+
+// The three draw shapes TelephoneRinger uses: ring count, percent, wait time (ms)
+struct Case {
+    const char* name;
+    long minValue;
+    long maxValue;
+};
+
+static const Case CASES[] = {
+    {"ring count [1,9)", 1, 9},
+    {"percent [0,100)", 0, 100},
+    {"wait ms [5000,300001)", 5000, 300001}
+};
+
+template <typename Fn>
+static double timeNsPerCall(Fn fn, volatile long& sink) {
+    auto start = std::chrono::steady_clock::now();
+    long acc = 0;
+    for (int i = 0; i < ITERATIONS; i++) {
+        acc += fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    sink = acc;
+    return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+}
+
+int main() {
+    volatile long sink = 0;
+    FastRandom rng;
+    rng.seed(12345);
+    
+    printf("%-24s %14s %14s %8s\n", "draw", "random() ns", "FastRandom ns", "speedup");
+    for (const Case& c : CASES) {
+        double baseline = timeNsPerCall([&]() { return arduinoRandom(c.minValue, c.maxValue); }, sink);
+        double fast = timeNsPerCall([&]() { return rng.range(c.minValue, c.maxValue); }, sink);
+        printf("%-24s %14.2f %14.2f %7.2fx\n", c.name, baseline, fast, baseline / fast);
+    }
+    
+    // Bucket check: each of 8 ring counts should get ~1/8 of the draws
+    const int DRAWS = 8000000;
+    long buckets[8] = {0};
+    for (int i = 0; i < DRAWS; i++) {
+        buckets[rng.range(1, 9) - 1]++;
+    }
+    double chiSquare = 0;
+    double expected = DRAWS / 8.0;
+    for (int i = 0; i < 8; i++) {
+        double d = buckets[i] - expected;
+        chiSquare += d * d / expected;
+    }
+    printf("\nring count chi-square (7 dof, 99%% critical 18.48): %.2f\n", chiSquare);
+    
+    // Replay check: same seed and stream must give the same sequence,
+    // different streams of the same seed must not
+    FastRandom a, b, c;
+    a.seed(42, 3);
+    b.seed(42, 3);
+    c.seed(42, 4);
+    bool replayOk = true;
+    int streamCollisions = 0;
+    for (int i = 0; i < 1000; i++) {
+        uint32_t va = a.next();
+        if (va != b.next()) replayOk = false;
+        if (va == c.next()) streamCollisions++;
+    }
+    printf("replay: %s, stream collisions in 1000 draws: %d\n", replayOk ? "OK" : "FAILED", streamCollisions);
+    
+    (void)sink;
+    return replayOk && chiSquare < 18.48 ? 0 : 1;
+}
@@ -0,0 +1,348 @@
+// Host tool: Monte Carlo capacity planner running the real ringer code
+//
+// Build and run from the project root:
+//   g++ -O2 -std=gnu++11 -pthread -Iinclude -Ihost/hal host/capacity_planner.cpp host/hal/Arduino.cpp host/hal/EEPROM.cpp src/RingerManager.cpp src/TelephoneRinger.cpp src/ArrivalModel.cpp src/EventBus.cpp src/RelayEdgeEngine.cpp src/EmergencyStop.cpp src/RelayWear.cpp src/VirtualClock.cpp src/CallStats.cpp src/StringUtils.cpp -o capacity_planner
+//   ./capacity_planner --lines 8 --concurrent 4 --delay 30 --hours 100000
+//
+// Answers "what will this configuration do to the ringer supply?" without
+// weeks of watching the installation: RingerManager and TelephoneRinger
+// (compiled unchanged against the virtual HAL) are run for many independent
+// simulated hours, each on its own seed, and the report gives percentiles
+// of concurrent calls, bells ringing at once (the supply load) and calls
+// per hour, plus the bell and supply duty cycles.
+//
+// Every thread is its own virtual board (the HAL clock and the EventBus
+// queue are thread_local). Threads claim hours in small batches from one
+// atomic counter, so a thread that draws quiet hours simply takes more of
+// them, and each thread keeps private histograms that are added into the
+// shared totals with atomic adds once it runs out of work. The result for
+// a given --seed does not depend on the thread count.
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <Arduino.h>
+#include "RingerManager.h"
+#include "EventBus.h"
+
+int maxCallDelaySetting = 30;  // Read by TelephoneRinger - same for every thread
+
+static const int NUM_LINES = 8;
+static const int RELAY_PINS[NUM_LINES] = {5, 6, 7, 8, 9, 10, 11, 12};  // Same as main.cpp
+
+static const unsigned long HOUR_MS = 3600000UL;
+static const uint64_t HOURS_PER_CLAIM = 16;
+static const int CALL_BINS = 8192;     // Calls (or blocked arrivals) per hour, last bin = more
+
+struct PlanConfig {
+    int lines;
+    int maxConcurrent;
+    int callDelay;                      // Call Timing setting, seconds
+    int hangTime;                       // Ringer power hang time, seconds
+    bool arrivalMode;                   // false = every line schedules its own calls
+    uint16_t callsPerHour;              // Arrival rate derived as in main.cpp
+    unsigned long warmupMs;             // Run before each measured hour so it starts in steady state
+    uint64_t hours;
+    uint32_t seed;
+};
+
+// One thread's results - milliseconds for time shares, hours for per-hour figures
+struct Histograms {
+    uint64_t concurrentMs[NUM_LINES + 1];
+    uint64_t ringingMs[NUM_LINES + 1];
+    uint64_t supplyOnMs;
+    uint64_t peakConcurrent[NUM_LINES + 1];
+    uint64_t peakRinging[NUM_LINES + 1];
+    uint64_t callsPerHour[CALL_BINS];
+    uint64_t blockedPerHour[CALL_BINS];
+};
+
+static const size_t HISTOGRAM_WORDS = sizeof(Histograms) / sizeof(uint64_t);
+
+// Totals every thread adds into - plain atomics, no lock
+static std::atomic<uint64_t> totals[HISTOGRAM_WORDS];
+static std::atomic<uint64_t> nextHour(0);
+
+// Calls started in the measured window, counted from CALL_STARTED events
+static thread_local bool measuring = false;
+static thread_local uint32_t callsStarted = 0;
+
+static void onCallStarted(const EventBus::Event& event) {
+    (void)event;
+    if (measuring) {
+        callsStarted++;
+    }
+}
+
+// Milliseconds of [start, end) that fall inside [windowStart, windowEnd)
+static unsigned long overlap(unsigned long start, unsigned long end,
+                             unsigned long windowStart, unsigned long windowEnd) {
+    if (start < windowStart) start = windowStart;
+    if (end > windowEnd) end = windowEnd;
+    return end > start ? end - start : 0;
+}
+
+// Times below are relative to the hour's start so millis() wrapping doesn't matter
+static void simulateHour(const PlanConfig& plan, uint32_t seed, Histograms& results) {
+    HostHal::skipMillisWrap(plan.warmupMs + HOUR_MS);
+    // Start on a millisecond boundary so the hour plays out the same on any thread
+    uint32_t intoMillisecond = HostHal::getMicros() % 1000;
+    if (intoMillisecond) {
+        HostHal::advanceMicros(1000 - intoMillisecond);
+    }
+
+    RingerManager ringers;
+    ringers.seedRandom(seed);
+    ringers.initialize(RELAY_PINS, NUM_LINES, nullptr, false);
+    ringers.setActiveRelayCount(plan.lines);
+    ringers.setMaxConcurrent(plan.maxConcurrent);
+    ringers.setArrivalMode(plan.arrivalMode);
+    ringers.setCallsPerHour(plan.callsPerHour);
+
+    const unsigned long windowStart = plan.warmupMs;
+    const unsigned long windowEnd = plan.warmupMs + HOUR_MS;
+    const unsigned long start = millis();
+    unsigned long blockedAtStart = 0;
+    unsigned long lastBusyEnd = 0;          // When the last call-carrying interval ended
+    bool haveBusy = false;
+    int peakConcurrent = 0;
+    int peakRinging = 0;
+
+    measuring = false;
+    callsStarted = 0;
+
+    for (;;) {
+        unsigned long now = millis();
+        unsigned long t = now - start;
+        if (t >= windowEnd) {
+            break;
+        }
+        if (!measuring && t >= windowStart) {
+            measuring = true;
+            blockedAtStart = ringers.getBlockedArrivalCount();
+        }
+
+        ringers.step(now);
+        EventBus::dispatch();
+
+        // State holds until the next step
+        unsigned long next = ringers.getTimeToNextEvent(now);
+        if (next > windowEnd - t) {
+            next = windowEnd - t;
+        }
+        unsigned long end = t + next;
+        int concurrent = ringers.getActiveCallCount();
+        int ringing = ringers.getRingingPhoneCount();
+
+        unsigned long measured = overlap(t, end, windowStart, windowEnd);
+        if (measured > 0) {
+            results.concurrentMs[concurrent] += measured;
+            results.ringingMs[ringing] += measured;
+            if (concurrent > peakConcurrent) peakConcurrent = concurrent;
+            if (ringing > peakRinging) peakRinging = ringing;
+        }
+
+        // Ringer supply: on while any call is up, then for the hang time (as outputTask)
+        if (concurrent > 0) {
+            results.supplyOnMs += measured;
+            lastBusyEnd = end;
+            haveBusy = true;
+        } else if (haveBusy) {
+            unsigned long hangEnd = lastBusyEnd + plan.hangTime * 1000UL;
+            results.supplyOnMs += overlap(t, min(end, hangEnd), windowStart, windowEnd);
+        }
+
+        HostHal::advanceMicros(next * 1000UL);
+    }
+
+    measuring = false;
+    uint32_t blocked = ringers.getBlockedArrivalCount() - blockedAtStart;
+    results.peakConcurrent[peakConcurrent]++;
+    results.peakRinging[peakRinging]++;
+    results.callsPerHour[callsStarted < (uint32_t)CALL_BINS ? callsStarted : CALL_BINS - 1]++;
+    results.blockedPerHour[blocked < (uint32_t)CALL_BINS ? blocked : CALL_BINS - 1]++;
+}
+
+static void worker(const PlanConfig* plan) {
+    std::vector<uint64_t> storage(HISTOGRAM_WORDS, 0);
+    Histograms& results = *reinterpret_cast<Histograms*>(storage.data());
+
+    for (;;) {
+        uint64_t first = nextHour.fetch_add(HOURS_PER_CLAIM, std::memory_order_relaxed);
+        if (first >= plan->hours) {
+            break;
+        }
+        uint64_t last = min(first + HOURS_PER_CLAIM, plan->hours);
+        for (uint64_t hour = first; hour < last; hour++) {
+            // Hour index picks the seed, so results don't depend on which thread ran it
+            simulateHour(*plan, plan->seed + (uint32_t)hour * 0x9E3779B9UL, results);
+        }
+    }
+
+    for (size_t i = 0; i < HISTOGRAM_WORDS; i++) {
+        if (storage[i]) {
+            totals[i].fetch_add(storage[i], std::memory_order_relaxed);
+        }
+    }
+}
+
+// Smallest bin covering fraction p of the total weight
+static int percentile(const uint64_t* bins, int count, double p) {
+    uint64_t total = 0;
+    for (int i = 0; i < count; i++) total += bins[i];
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t target = (uint64_t)(p * total);
+    if (target >= total) target = total - 1;
+    uint64_t cumulative = 0;
+    for (int i = 0; i < count; i++) {
+        cumulative += bins[i];
+        if (cumulative > target) {
+            return i;
+        }
+    }
+    return count - 1;
+}
+
+static int highestBin(const uint64_t* bins, int count) {
+    for (int i = count - 1; i > 0; i--) {
+        if (bins[i]) return i;
+    }
+    return 0;
+}
+
+static double mean(const uint64_t* bins, int count) {
+    double sum = 0, weight = 0;
+    for (int i = 0; i < count; i++) {
+        sum += (double)i * bins[i];
+        weight += bins[i];
+    }
+    return weight > 0 ? sum / weight : 0;
+}
+
+static void printPercentiles(const char* label, const uint64_t* bins, int count) {
+    printf("  %-22s %5d %5d %5d %6d %5d   mean %.2f\n", label,
+           percentile(bins, count, 0.50), percentile(bins, count, 0.90),
+           percentile(bins, count, 0.99), percentile(bins, count, 0.999),
+           highestBin(bins, count), mean(bins, count));
+}
+
+static void printShares(const char* label, const uint64_t* bins, int count) {
+    uint64_t total = 0;
+    for (int i = 0; i < count; i++) total += bins[i];
+    printf("  %-22s", label);
+    for (int i = 0; i < count; i++) {
+        printf(" %d:%5.1f%%", i, total ? 100.0 * bins[i] / total : 0.0);
+    }
+    printf("\n");
+}
+
+static void usage() {
+    printf("usage: capacity_planner [--lines N] [--concurrent N] [--delay S] [--hang S]\n"
+           "                        [--hours N] [--threads N] [--seed N] [--warmup MIN] [--per-line]\n");
+}
+
+int main(int argc, char** argv) {
+    PlanConfig plan;
+    plan.lines = NUM_LINES;
+    plan.maxConcurrent = 4;
+    plan.callDelay = 30;
+    plan.hangTime = 2;
+    plan.arrivalMode = true;
+    plan.warmupMs = 10 * 60000UL;
+    plan.hours = 10000;
+    plan.seed = 1;
+    unsigned threads = std::thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--lines") && hasValue) {
+            plan.lines = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--concurrent") && hasValue) {
+            plan.maxConcurrent = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--delay") && hasValue) {
+            plan.callDelay = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--hang") && hasValue) {
+            plan.hangTime = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--hours") && hasValue) {
+            plan.hours = strtoull(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--threads") && hasValue) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && hasValue) {
+            plan.seed = strtoul(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--warmup") && hasValue) {
+            plan.warmupMs = strtoul(argv[++i], nullptr, 10) * 60000UL;
+        } else if (!strcmp(argv[i], "--per-line")) {
+            plan.arrivalMode = false;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    // Same ranges as the settings menu
+    plan.lines = constrain(plan.lines, 1, NUM_LINES);
+    plan.maxConcurrent = constrain(plan.maxConcurrent, 1, NUM_LINES);
+    plan.callDelay = constrain(plan.callDelay, 10, 1000);
+    plan.hangTime = constrain(plan.hangTime, 0, 60);
+    if (threads == 0) threads = 1;
+    if (plan.hours == 0) plan.hours = 1;
+    maxCallDelaySetting = plan.callDelay;
+    plan.callsPerHour = (unsigned long)plan.lines * 3600UL / (5UL + plan.callDelay);
+
+    EventBus::subscribe(EventBus::maskOf(EventBus::CALL_STARTED), onCallStarted);
+
+    printf("Capacity plan: %d lines, %d concurrent, Call Timing %d s, hang time %d s, ",
+           plan.lines, plan.maxConcurrent, plan.callDelay, plan.hangTime);
+    if (plan.arrivalMode) {
+        printf("Poisson arrivals at %u calls/hour\n", plan.callsPerHour);
+    } else {
+        printf("per-line call timing\n");
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < threads; i++) {
+        pool.push_back(std::thread(worker, &plan));
+    }
+    for (size_t i = 0; i < pool.size(); i++) {
+        pool[i].join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::vector<uint64_t> storage(HISTOGRAM_WORDS);
+    for (size_t i = 0; i < HISTOGRAM_WORDS; i++) {
+        storage[i] = totals[i].load();
+    }
+    const Histograms& h = *reinterpret_cast<const Histograms*>(storage.data());
+    const int levels = plan.lines + 1;
+
+    printf("Simulated %llu hours (%.1f years) on %u threads in %.1f s (%.0f hours/s)\n\n",
+           (unsigned long long)plan.hours, plan.hours / 8766.0, threads, seconds, plan.hours / seconds);
+
+    printf("  %-22s %5s %5s %5s %6s %5s\n", "", "p50", "p90", "p99", "p99.9", "max");
+    printf("Concurrent calls\n");
+    printPercentiles("over time", h.concurrentMs, levels);
+    printPercentiles("hourly peak", h.peakConcurrent, levels);
+    printf("Bells ringing at once (supply load)\n");
+    printPercentiles("over time", h.ringingMs, levels);
+    printPercentiles("hourly peak", h.peakRinging, levels);
+    printf("Per hour\n");
+    printPercentiles("calls", h.callsPerHour, CALL_BINS);
+    if (plan.arrivalMode) {
+        printPercentiles("blocked arrivals", h.blockedPerHour, CALL_BINS);
+    }
+
+    printf("\nShare of time\n");
+    printShares("concurrent calls", h.concurrentMs, levels);
+    printShares("bells ringing", h.ringingMs, levels);
+
+    double measuredMs = (double)plan.hours * HOUR_MS;
+    printf("\nDuty cycle: each bell %.1f%%, ringer supply on %.1f%%, at the concurrent limit %.1f%%\n",
+           100.0 * mean(h.ringingMs, levels) / plan.lines,
+           100.0 * h.supplyOnMs / measuredMs,
+           100.0 * h.concurrentMs[min(plan.maxConcurrent, plan.lines)] / measuredMs);
+    return 0;
+}
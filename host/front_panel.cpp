@@ -0,0 +1,669 @@
+// Virtual front panel: the real firmware driving an emulated 20x4 LCD
+//
+// Build and run from the project root:
+//   g++ -O2 -std=gnu++11 -Iinclude -Ihost/hal host/front_panel.cpp host/hal/*.cpp src/*.cpp -o front_panel && ./front_panel
+//
+// setup() and loop() from src/main.cpp run unmodified on the virtual board in
+// host/hal. The LCD backpack on the I2C bus is an Hd44780Emulator, Timer1's
+// relay edges follow the virtual clock, and the keyboard works the encoder
+// and pause button pins:
+//
+//   Right / d   turn clockwise          Enter / space   press
+//   Left / a    turn counter-clockwise  h               hold (long press)
+//   p           pause button            q               quit
+//   b           send 'b' on Serial (start/abort the stress test)
+//   s           send 's' on Serial (print the call statistics)
+//
+// --bench [seconds] runs a scripted session (relay count, menu with an
+// accelerated spin, save, pause/resume, maximum chaos) as fast as possible
+// and reports the I2C traffic per frame - the display throughput benchmark.
+// A frame is one pass of loop() that wrote to the LCD.
+//
+// --stress runs the firmware's own stress test (started over Serial) and
+// prints its report and summary screen.
+//
+// --estop [presses] pauses and resumes at random moments while maximum chaos
+// rings every line, every third pause landing in the chaos banner's 3 s
+// delay(). It reports how long after each press the relays and ringer power
+// were all off (the emulated pin change interrupt), whether anything came
+// back on before the main loop caught up, and how long the main loop took
+// to notice and finish pausing - the old pause latency.
+//
+// Pin changes are applied as the virtual clock passes them, mid-frame, and
+// a port C change runs the firmware's pin change handler like the PCINT1
+// interrupt would.
+//
+// Options: --bench [seconds] (default 120), --stress, --estop [presses]
+// (default 20), --seed N (analog
+// noise, so the call pattern), --serial (echo the firmware's Serial output
+// to stderr), --slow-lcd (backpack that NACKs above 100 kHz), --slow-clone
+// (controller that takes 72us per instruction), --backlight-low (backlight
+// on when P3 is low), --rw-grounded (RW tied low, so the firmware falls back
+// to hd44780_I2Cexp), --ac HZ (zero-cross detector signal, default 60;
+// 0 = no detector fitted).
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <chrono>
+#include <deque>
+#include <signal.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+#include "EmergencyStop.h"
+#include "Hd44780Emulator.h"
+#include "RelayEdgeEngine.h"
+#include "StressTest.h"
+
+// The firmware
+void setup();
+void loop();
+
+// Pins as wired in src/main.cpp
+static const uint8_t ENCODER_PIN_A = 3;
+static const uint8_t ENCODER_PIN_B = 2;
+static const uint8_t ENCODER_BUTTON = 4;
+static const uint8_t PAUSE_BUTTON = A0;
+static const uint8_t STATUS_LED = 13;
+static const uint8_t RINGER_POWER_PIN = A2;
+static const uint8_t READY_LED = A3;
+static const uint8_t FIRST_RELAY_PIN = 5;
+static const uint8_t RELAY_COUNT = 8;
+
+static const uint8_t LCD_ADDRESS = 0x27;
+
+// Input timing - each encoder contact change is held past InputDebouncer's 4ms contact debounce
+static const uint32_t CONTACT_HOLD_US = 6000;
+static const uint32_t PRESS_US = 100000;
+static const uint32_t LONG_PRESS_US = 1200000;
+static const uint32_t RELEASE_US = 60000;       // Past the ~40ms button debounce before the next press
+
+static const uint32_t FULL_REDRAW_CHARACTERS = Hd44780Emulator::COLS * Hd44780Emulator::ROWS;
+
+static Hd44780Emulator lcd;
+
+// I2C traffic, summed over frames
+struct Throughput {
+    uint32_t frames;
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t busMicros;
+    uint32_t characters;
+    uint32_t unchangedCharacters;
+    uint32_t instructions;
+    uint32_t maxTransactions;
+    uint32_t maxBytes;
+    uint32_t maxBusMicros;
+    uint32_t fullRedraws;
+    uint64_t fullRedrawMicros;
+};
+
+struct Frame {
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t busMicros;
+    uint32_t characters;
+};
+
+static Throughput throughput;
+static Frame lastFrame;
+
+// Scheduled pin changes from key presses, applied when the virtual clock reaches them
+struct PinChange {
+    uint64_t at;
+    uint8_t pin;
+    uint8_t level;
+};
+
+static std::deque<PinChange> pinChanges;
+static uint64_t inputBusyUntil = 0;
+static uint8_t encoderLevel = HIGH;     // A and B rest at the same level between detents
+static bool applyingPins = false;       // The pin change handler reads the clock too
+
+// Emergency stop timing - pause press to every relay and the ringer power off
+struct StopTiming {
+    uint32_t presses;
+    uint32_t livePresses;               // Something was on when the button went down
+    uint64_t pressedAt;
+    bool waitingForCut;
+    uint64_t cutMicros;
+    uint64_t maxCutMicros;
+    bool waitingForCatchUp;
+    uint32_t catchUps;
+    uint64_t catchUpMicros;
+    uint64_t maxCatchUpMicros;
+    uint32_t outputsBackOn;             // Clock steps with an output on while the trip is latched
+};
+
+static StopTiming stopTiming;
+
+// Relay Timer1 runs at 4us per tick
+static uint32_t timerRemainderMicros = 0;
+
+// Last few lines of Serial output
+static const uint8_t SERIAL_LINES = 4;
+static const uint8_t SERIAL_LINE_LENGTH = 60;
+static char serialLines[SERIAL_LINES][SERIAL_LINE_LENGTH + 1];
+static uint8_t serialLineCount = 0;
+static uint8_t serialColumn = 0;
+static bool echoSerial = false;
+
+static struct termios savedTerminal;
+static bool terminalRaw = false;
+
+static bool anyOutputOn() {
+    for (uint8_t i = 0; i < RELAY_COUNT; i++) {
+        if (HostHal::getOutputLevel(FIRST_RELAY_PIN + i) == LOW) {
+            return true;
+        }
+    }
+    return HostHal::getOutputLevel(RINGER_POWER_PIN) == LOW;
+}
+
+static void applyPinChanges() {
+    if (applyingPins) {
+        return;
+    }
+    applyingPins = true;
+    uint64_t now = HostHal::getMicros();
+    while (!pinChanges.empty() && pinChanges.front().at <= now) {
+        PinChange change = pinChanges.front();
+        pinChanges.pop_front();
+        if (change.pin == PAUSE_BUTTON && change.level == LOW && EmergencyStop::isArmed()) {
+            stopTiming.presses++;
+            if (anyOutputOn()) {
+                stopTiming.livePresses++;
+                stopTiming.waitingForCut = true;
+            }
+            stopTiming.pressedAt = change.at;
+            stopTiming.waitingForCatchUp = true;
+        }
+        HostHal::setInputLevel(change.pin, change.level);
+        if (change.pin >= A0 && change.pin <= A5) {
+            EmergencyStop::handlePinChange();   // PCINT1
+        }
+    }
+    if (EmergencyStop::isTripped() && !stopTiming.waitingForCut && anyOutputOn()) {
+        stopTiming.outputsBackOn++;
+    }
+    if (stopTiming.waitingForCut && !anyOutputOn()) {
+        uint64_t latency = HostHal::getMicros() - stopTiming.pressedAt;
+        stopTiming.cutMicros += latency;
+        stopTiming.maxCutMicros = max(stopTiming.maxCutMicros, latency);
+        stopTiming.waitingForCut = false;
+    }
+    if (stopTiming.waitingForCatchUp && !EmergencyStop::isTripped() && EmergencyStop::getTripCount() > 0) {
+        uint64_t latency = HostHal::getMicros() - stopTiming.pressedAt;
+        stopTiming.catchUps++;
+        stopTiming.catchUpMicros += latency;
+        stopTiming.maxCatchUpMicros = max(stopTiming.maxCatchUpMicros, latency);
+        stopTiming.waitingForCatchUp = false;
+    }
+    applyingPins = false;
+}
+
+static void onClockAdvance(uint32_t us) {
+    uint32_t total = timerRemainderMicros + us;
+    RelayEdgeEngine::emulateAdvance(total / 4);
+    timerRemainderMicros = total % 4;
+    applyPinChanges();
+}
+
+static void onSerial(char c) {
+    if (echoSerial) {
+        fputc(c, stderr);
+    }
+    if (c == '\r') {
+        return;
+    }
+    if (c == '\n') {
+        serialColumn = 0;
+        return;
+    }
+    if (serialColumn == 0) {
+        // New line - scroll when full
+        if (serialLineCount == SERIAL_LINES) {
+            memmove(serialLines[0], serialLines[1], sizeof(serialLines[0]) * (SERIAL_LINES - 1));
+            serialLineCount--;
+        }
+        serialLines[serialLineCount++][0] = '\0';
+    }
+    if (serialColumn < SERIAL_LINE_LENGTH) {
+        char* line = serialLines[serialLineCount - 1];
+        line[serialColumn++] = c;
+        line[serialColumn] = '\0';
+    }
+}
+
+static void queuePin(uint8_t pin, uint8_t level, uint32_t holdMicros) {
+    uint64_t at = max(inputBusyUntil, HostHal::getMicros());
+    PinChange change = { at, pin, level };
+    pinChanges.push_back(change);
+    inputBusyUntil = at + holdMicros;
+}
+
+// One detent. EncoderManager counts a step when A changes: clockwise if A
+// then equals B, so B moves first for clockwise and second for counter-clockwise.
+static void turnEncoder(bool clockwise) {
+    encoderLevel = !encoderLevel;
+    if (clockwise) {
+        queuePin(ENCODER_PIN_B, encoderLevel, CONTACT_HOLD_US);
+        queuePin(ENCODER_PIN_A, encoderLevel, CONTACT_HOLD_US);
+    } else {
+        queuePin(ENCODER_PIN_A, encoderLevel, CONTACT_HOLD_US);
+        queuePin(ENCODER_PIN_B, encoderLevel, CONTACT_HOLD_US);
+    }
+}
+
+static void pressButton(uint8_t pin, uint32_t holdMicros) {
+    queuePin(pin, LOW, holdMicros);
+    queuePin(pin, HIGH, RELEASE_US);
+}
+
+// Returns false for quit
+static bool handleKey(char key) {
+    switch (key) {
+        case 'd': turnEncoder(true); break;
+        case 'a': turnEncoder(false); break;
+        case ' ':
+        case '\r':
+        case '\n': pressButton(ENCODER_BUTTON, PRESS_US); break;
+        case 'h': pressButton(ENCODER_BUTTON, LONG_PRESS_US); break;
+        case 'p': pressButton(PAUSE_BUTTON, PRESS_US); break;
+        case 'b': HostHal::sendSerial('b'); break;
+        case 's': HostHal::sendSerial('s'); break;
+        case 'q': return false;
+        default: break;
+    }
+    return true;
+}
+
+// One pass of loop(), then idle to the next millisecond - every task works in whole milliseconds
+static void runFrame() {
+    applyPinChanges();
+
+    TwoWire::BusStats bus = Wire.getStats();
+    uint32_t characters = lcd.getStats().characters;
+    uint32_t unchanged = lcd.getStats().unchangedCharacters;
+    uint32_t instructions = lcd.getStats().instructions;
+
+    loop();
+
+    const TwoWire::BusStats& busAfter = Wire.getStats();
+    if (busAfter.transactions != bus.transactions) {
+        Frame frame;
+        frame.transactions = busAfter.transactions - bus.transactions;
+        frame.bytes = busAfter.bytes - bus.bytes;
+        frame.busMicros = busAfter.busMicros - bus.busMicros;
+        frame.characters = lcd.getStats().characters - characters;
+        lastFrame = frame;
+
+        throughput.frames++;
+        throughput.transactions += frame.transactions;
+        throughput.bytes += frame.bytes;
+        throughput.busMicros += frame.busMicros;
+        throughput.characters += frame.characters;
+        throughput.unchangedCharacters += lcd.getStats().unchangedCharacters - unchanged;
+        throughput.instructions += lcd.getStats().instructions - instructions;
+        throughput.maxTransactions = max(throughput.maxTransactions, frame.transactions);
+        throughput.maxBytes = max(throughput.maxBytes, frame.bytes);
+        throughput.maxBusMicros = max(throughput.maxBusMicros, frame.busMicros);
+        if (frame.characters >= FULL_REDRAW_CHARACTERS) {
+            throughput.fullRedraws++;
+            throughput.fullRedrawMicros += frame.busMicros;
+        }
+    }
+
+    uint64_t now = HostHal::getMicros();
+    HostHal::advanceMicros((uint32_t)((now / 1000 + 1) * 1000 - now));
+}
+
+// UTF-8 for one LCD cell (ROM code A00, the usual Western/Japanese set)
+static const char* cellText(uint8_t code, bool color, char* buffer) {
+    if (code < 16) {
+        // CGRAM glyph - shown as its slot number
+        snprintf(buffer, 16, color ? "\x1b[7m%u\x1b[27m" : "%u", code & 7);
+        return buffer;
+    }
+    switch (code) {
+        case 0x7E: return "→";
+        case 0x7F: return "←";
+        case 0xA5: return "·";
+        case 0xFF: return "█";
+        default: break;
+    }
+    if (code < 0x20 || code > 0x7D) {
+        return "?";
+    }
+    buffer[0] = code;
+    buffer[1] = '\0';
+    return buffer;
+}
+
+static void printScreen(FILE* out, bool color) {
+    char buffer[16];
+    fprintf(out, " ┌");
+    for (uint8_t col = 0; col < Hd44780Emulator::COLS; col++) {
+        fprintf(out, "─");
+    }
+    fprintf(out, "┐\n");
+    for (uint8_t row = 0; row < Hd44780Emulator::ROWS; row++) {
+        fprintf(out, " │");
+        if (color && lcd.isBacklightOn()) {
+            fprintf(out, "\x1b[30;42m");
+        }
+        for (uint8_t col = 0; col < Hd44780Emulator::COLS; col++) {
+            fputs(lcd.isDisplayOn() ? cellText(lcd.getCell(row, col), color, buffer) : " ", out);
+        }
+        if (color) {
+            fprintf(out, "\x1b[0m");
+        }
+        fprintf(out, "│\n");
+    }
+    fprintf(out, " └");
+    for (uint8_t col = 0; col < Hd44780Emulator::COLS; col++) {
+        fprintf(out, "─");
+    }
+    fprintf(out, "┘  backlight %s\n", lcd.isBacklightOn() ? "on" : "off");
+}
+
+// CGRAM slots as 5x8 pixel art, two pixel rows per text line
+static void printGlyphs(FILE* out) {
+    fprintf(out, " CGRAM ");
+    for (uint8_t slot = 0; slot < 8; slot++) {
+        fprintf(out, "%u      ", slot);
+    }
+    fprintf(out, "\n");
+    for (uint8_t line = 0; line < 4; line++) {
+        fprintf(out, "       ");
+        for (uint8_t slot = 0; slot < 8; slot++) {
+            const uint8_t* glyph = lcd.getGlyph(slot);
+            for (int8_t bit = 4; bit >= 0; bit--) {
+                bool top = glyph[line * 2] & (1 << bit);
+                bool bottom = glyph[line * 2 + 1] & (1 << bit);
+                fputs(top ? (bottom ? "█" : "▀") : (bottom ? "▄" : " "), out);
+            }
+            fprintf(out, "  ");
+        }
+        fprintf(out, "\n");
+    }
+}
+
+static const char* lamp(bool on) {
+    return on ? "●" : "○";
+}
+
+static void printPanel(FILE* out) {
+    uint64_t ms = HostHal::getMicros() / 1000;
+    fprintf(out, "\x1b[H CallStorm 2000 front panel    %02lu:%02lu:%02lu.%03lu\x1b[K\n\n",
+            (unsigned long)(ms / 3600000), (unsigned long)(ms / 60000 % 60),
+            (unsigned long)(ms / 1000 % 60), (unsigned long)(ms % 1000));
+    printScreen(out, true);
+    fprintf(out, "\n Relays ");
+    for (uint8_t i = 0; i < RELAY_COUNT; i++) {
+        fprintf(out, " %s", lamp(HostHal::getOutputLevel(FIRST_RELAY_PIN + i) == LOW));   // Active LOW
+    }
+    fprintf(out, "    ringer power %s  status %s  ready %s\x1b[K\n\n",
+            lamp(HostHal::getOutputLevel(RINGER_POWER_PIN) == LOW),
+            lamp(HostHal::getOutputLevel(STATUS_LED) == HIGH),
+            lamp(HostHal::getOutputLevel(READY_LED) == HIGH));
+    printGlyphs(out);
+    fprintf(out, "\n I2C last frame: %lu transactions, %lu bytes, %lu chars, %lu us\x1b[K\n",
+            (unsigned long)lastFrame.transactions, (unsigned long)lastFrame.bytes,
+            (unsigned long)lastFrame.characters, (unsigned long)lastFrame.busMicros);
+    fprintf(out, " I2C total: %lu frames, %lu transactions, %lu bytes, %lu ms on the bus\x1b[K\n\n",
+            (unsigned long)throughput.frames, (unsigned long)throughput.transactions,
+            (unsigned long)throughput.bytes, (unsigned long)(throughput.busMicros / 1000));
+    for (uint8_t i = 0; i < SERIAL_LINES; i++) {
+        fprintf(out, " %s %s\x1b[K\n", i == 0 ? "Serial" : "      ", i < serialLineCount ? serialLines[i] : "");
+    }
+    fprintf(out, "\n →/d ←/a turn  Enter press  h hold  p pause  b stress test  q quit\x1b[K\n");
+    fflush(out);
+}
+
+static void restoreTerminal() {
+    if (terminalRaw) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &savedTerminal);
+        printf("\x1b[?25h\n");
+        terminalRaw = false;
+    }
+}
+
+static void onSignal(int signal) {
+    (void)signal;
+    restoreTerminal();
+    _exit(0);
+}
+
+static void enterRawTerminal() {
+    tcgetattr(STDIN_FILENO, &savedTerminal);
+    struct termios raw = savedTerminal;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    terminalRaw = true;
+    atexit(restoreTerminal);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    printf("\x1b[2J\x1b[?25l");
+}
+
+// Keys waiting on stdin - arrow keys arrive as ESC [ C / ESC [ D
+static bool readKeys() {
+    char keys[32];
+    ssize_t count = read(STDIN_FILENO, keys, sizeof(keys));
+    for (ssize_t i = 0; i < count; i++) {
+        char key = keys[i];
+        if (key == 0x1B && i + 2 < count && keys[i + 1] == '[') {
+            key = keys[i + 2] == 'C' ? 'd' : (keys[i + 2] == 'D' ? 'a' : 0);
+            i += 2;
+        }
+        if (!handleKey(key)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void runInteractive() {
+    enterRawTerminal();
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point wallStart = Clock::now();
+    uint64_t virtualStart = HostHal::getMicros();
+    Clock::time_point lastDraw = wallStart;
+
+    while (readKeys()) {
+        // Keep the virtual clock level with the wall clock (a blocking delay() gets ahead - just wait it out)
+        uint64_t wallMicros = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - wallStart).count();
+        while (HostHal::getMicros() - virtualStart < wallMicros) {
+            runFrame();
+        }
+        if (Clock::now() - lastDraw >= std::chrono::milliseconds(50)) {
+            printPanel(stdout);
+            lastDraw = Clock::now();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+// Benchmark session - times are milliseconds after setup()
+struct ScriptStep {
+    uint32_t atMs;
+    char key;
+    uint8_t count;
+    uint16_t intervalMs;
+};
+
+static const ScriptStep BENCH_SCRIPT[] = {
+    {  5000, 'a',  1,   0 },    // One phone fewer from the status screen...
+    {  6000, 'd',  1,   0 },    // ...and back
+    { 10000, ' ',  1,   0 },    // Open the settings menu
+    { 11000, 'd',  2, 400 },    // Down to Call Timing
+    { 12000, ' ',  1,   0 },    // Adjust it
+    { 13000, 'd', 12,  20 },    // Fast spin up (accelerated steps)
+    { 15000, 'a', 12,  20 },    // and back down
+    { 17000, ' ',  1,   0 },    // Save, back to the item list
+    { 18000, 'h',  1,   0 },    // Long press - save and exit
+    { 30000, 'p',  1,   0 },    // Pause
+    { 40000, 'p',  1,   0 },    // Resume
+    { 50000, 'h',  1,   0 },    // Long press on the status screen - maximum chaos
+};
+static const uint8_t BENCH_STEP_COUNT = sizeof(BENCH_SCRIPT) / sizeof(BENCH_SCRIPT[0]);
+
+static void runBenchmark(uint32_t seconds) {
+    uint64_t start = HostHal::getMicros();
+    uint64_t end = start + (uint64_t)seconds * 1000000;
+    uint8_t step = 0;
+    uint8_t repeat = 0;
+
+    while (HostHal::getMicros() < end) {
+        while (step < BENCH_STEP_COUNT) {
+            const ScriptStep& next = BENCH_SCRIPT[step];
+            uint64_t due = start + (uint64_t)(next.atMs + repeat * next.intervalMs) * 1000;
+            if (HostHal::getMicros() < due) {
+                break;
+            }
+            handleKey(next.key);
+            if (++repeat >= next.count) {
+                repeat = 0;
+                step++;
+            }
+        }
+        runFrame();
+    }
+
+    printScreen(stdout, false);
+    double frames = throughput.frames > 0 ? throughput.frames : 1;
+    printf("\nDisplay throughput: %lu s virtual, I2C at %lu kHz\n",
+           (unsigned long)seconds, (unsigned long)(Wire.getClock() / 1000));
+    printf("  LCD frames:        %lu\n", (unsigned long)throughput.frames);
+    printf("  Transactions:      %lu (%.1f per frame, max %lu)\n", (unsigned long)throughput.transactions,
+           throughput.transactions / frames, (unsigned long)throughput.maxTransactions);
+    printf("  Payload bytes:     %lu (%.1f per frame, max %lu)\n", (unsigned long)throughput.bytes,
+           throughput.bytes / frames, (unsigned long)throughput.maxBytes);
+    printf("  Bus time:          %lu ms (%.0f us per frame, max %lu us, %.2f%% of the run)\n",
+           (unsigned long)(throughput.busMicros / 1000), throughput.busMicros / frames,
+           (unsigned long)throughput.maxBusMicros, throughput.busMicros / (seconds * 10000.0));
+    printf("  Characters:        %lu (%lu unchanged, %.1f%%)\n", (unsigned long)throughput.characters,
+           (unsigned long)throughput.unchangedCharacters,
+           throughput.characters > 0 ? 100.0 * throughput.unchangedCharacters / throughput.characters : 0.0);
+    printf("  Bytes per char:    %.2f (instructions and padding included)\n",
+           throughput.characters > 0 ? (double)throughput.bytes / throughput.characters : 0.0);
+    printf("  Instructions:      %lu\n", (unsigned long)throughput.instructions);
+    printf("  Full redraws:      %lu (%.0f us each)\n", (unsigned long)throughput.fullRedraws,
+           throughput.fullRedraws > 0 ? (double)throughput.fullRedrawMicros / throughput.fullRedraws : 0.0);
+    printf("  Busy violations:   %lu\n", (unsigned long)lcd.getStats().busyViolations);
+}
+
+// The firmware's acceptance run, as a technician would start it from a terminal
+static void runStressTest() {
+    echoSerial = true;
+    handleKey('b');
+    uint64_t end = HostHal::getMicros() + (StressTest::DEFAULT_DURATION + 1000) * 1000ULL;
+    while (HostHal::getMicros() < end) {
+        runFrame();
+    }
+    printScreen(stdout, false);
+}
+
+static void runFor(uint64_t micros) {
+    uint64_t end = HostHal::getMicros() + micros;
+    while (HostHal::getMicros() < end) {
+        runFrame();
+    }
+}
+
+// Pause presses at random moments with every line ringing
+static void runEmergencyStop(uint32_t presses, uint32_t seed) {
+    srand(seed);
+    handleKey('h');                 // Maximum chaos
+    runFor(10000000);
+    for (uint32_t i = 0; i < presses; i++) {
+        runFor(2000000 + (uint64_t)(rand() % 4000) * 1000);
+        if (i % 3 == 2) {
+            handleKey('h');         // Chaos again - the pause lands in its banner's delay()
+        }
+        handleKey('p');
+        runFor(5000000);
+        handleKey('p');             // Resume
+    }
+    runFor(1000000);
+
+    printScreen(stdout, false);
+    printf("\nEmergency stop: %lu pause presses, %lu with relays or ringer power on, %u trips\n",
+           (unsigned long)stopTiming.presses, (unsigned long)stopTiming.livePresses,
+           (unsigned)EmergencyStop::getTripCount());
+    printf("  Outputs off after:    mean %.1f us, worst %lu us (emulated interrupt - the host clock steps up to 1 ms)\n",
+           stopTiming.livePresses > 0 ? (double)stopTiming.cutMicros / stopTiming.livePresses : 0.0,
+           (unsigned long)stopTiming.maxCutMicros);
+    printf("  Back on while held:   %lu clock steps\n", (unsigned long)stopTiming.outputsBackOn);
+    printf("  Main loop noticed:    worst %.1f ms after the cut (the firmware's own measurement)\n",
+           EmergencyStop::getMaxCatchUpMicros() / 1000.0);
+    printf("  Pause completed:      mean %.1f ms, worst %.1f ms (the old pause latency)\n",
+           stopTiming.catchUps > 0 ? stopTiming.catchUpMicros / 1000.0 / stopTiming.catchUps : 0.0,
+           stopTiming.maxCatchUpMicros / 1000.0);
+}
+
+int main(int argc, char** argv) {
+    bool bench = false;
+    bool stress = false;
+    uint32_t stopPresses = 0;
+    uint32_t benchSeconds = 120;
+    uint32_t seed = 1;
+    uint32_t acHz = 60;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            bench = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                benchSeconds = strtoul(argv[++i], nullptr, 10);
+            }
+        } else if (strcmp(argv[i], "--stress") == 0) {
+            stress = true;
+        } else if (strcmp(argv[i], "--estop") == 0) {
+            stopPresses = 20;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                stopPresses = strtoul(argv[++i], nullptr, 10);
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], nullptr, 0);
+        } else if (strcmp(argv[i], "--serial") == 0) {
+            echoSerial = true;
+        } else if (strcmp(argv[i], "--slow-lcd") == 0) {
+            lcd.setMaxClock(100000);
+        } else if (strcmp(argv[i], "--slow-clone") == 0) {
+            lcd.setInstructionNanos(Hd44780Emulator::SLOW_INSTRUCTION_NANOS);
+        } else if (strcmp(argv[i], "--backlight-low") == 0) {
+            lcd.setBacklightActiveLow(true);
+        } else if (strcmp(argv[i], "--rw-grounded") == 0) {
+            lcd.setRwGrounded(true);
+        } else if (strcmp(argv[i], "--ac") == 0 && i + 1 < argc) {
+            acHz = strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--bench [seconds]] [--stress] [--estop [presses]] [--seed N] [--serial] [--slow-lcd] [--slow-clone] [--backlight-low] [--rw-grounded] [--ac HZ]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Wire.attach(LCD_ADDRESS, &lcd);
+    HostHal::setClockListener(onClockAdvance);
+    HostHal::setSerialSink(onSerial);
+    HostHal::seedAnalogNoise(seed);
+    MCUSR = 1 << PORF;  // Power-on reset
+
+    setup();
+    // Two crossings per AC cycle, 4us Timer1 ticks
+    RelayEdgeEngine::emulateZeroCross(acHz ? 1000000UL / (2 * 4 * acHz) : 0);
+
+    if (stress) {
+        runStressTest();
+    } else if (stopPresses > 0) {
+        runEmergencyStop(stopPresses, seed);
+    } else if (bench) {
+        runBenchmark(benchSeconds);
+    } else {
+        runInteractive();
+    }
+    return 0;
+}
@@ -0,0 +1,274 @@
+#include <Arduino.h>
+
+HostSerial Serial;
+uint8_t MCUSR = 0;
+
+struct PinState {
+    uint8_t mode;
+    uint8_t output;         // Last digitalWrite()
+    bool driven;            // Held by the host program
+    uint8_t input;          // Level it holds the pin at
+    uint32_t toggles;
+};
+
+// One board per thread - host tools may run a simulation on each core
+static thread_local uint64_t clockMicros = 0;
+static thread_local void (*clockListener)(uint32_t us) = nullptr;
+static thread_local void (*serialSink)(char c) = nullptr;
+static const uint8_t SERIAL_RX_SIZE = 64;      // Same as the AVR core's receive buffer
+static thread_local char serialRx[SERIAL_RX_SIZE];
+static thread_local uint8_t serialRxHead = 0;
+static thread_local uint8_t serialRxCount = 0;
+static thread_local PinState pins[NUM_DIGITAL_PINS];
+static thread_local uint32_t analogNoise = 1;
+static thread_local uint32_t randomState = 1;
+
+// xorshift32 - state must stay nonzero
+static uint32_t nextNoise(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+uint64_t HostHal::getMicros() {
+    return clockMicros;
+}
+
+void HostHal::advanceMicros(uint32_t us) {
+    if (us == 0) {
+        return;
+    }
+    clockMicros += us;
+    if (clockListener) {
+        clockListener(us);
+    }
+}
+
+void HostHal::skipMillisWrap(uint32_t spanMs) {
+    const uint64_t wrapMs = 1ULL << 32;
+    uint64_t intoWrap = (clockMicros / 1000) % wrapMs;
+    if (intoWrap + spanMs < wrapMs) {
+        return;
+    }
+    uint64_t target = (clockMicros / 1000 - intoWrap + wrapMs) * 1000;
+    while (clockMicros < target) {
+        uint64_t step = target - clockMicros;
+        advanceMicros(step > 0xFFFFFFFFULL ? 0xFFFFFFFFUL : (uint32_t)step);
+    }
+}
+
+void HostHal::setClockListener(void (*listener)(uint32_t us)) {
+    clockListener = listener;
+}
+
+void HostHal::setInputLevel(uint8_t pin, uint8_t level) {
+    if (pin < NUM_DIGITAL_PINS) {
+        pins[pin].driven = true;
+        pins[pin].input = level ? HIGH : LOW;
+    }
+}
+
+void HostHal::releaseInput(uint8_t pin) {
+    if (pin < NUM_DIGITAL_PINS) {
+        pins[pin].driven = false;
+    }
+}
+
+uint8_t HostHal::getOutputLevel(uint8_t pin) {
+    return pin < NUM_DIGITAL_PINS ? pins[pin].output : LOW;
+}
+
+uint32_t HostHal::getToggleCount(uint8_t pin) {
+    return pin < NUM_DIGITAL_PINS ? pins[pin].toggles : 0;
+}
+
+void HostHal::seedAnalogNoise(uint32_t seed) {
+    analogNoise = seed ? seed : 1;
+}
+
+void HostHal::setSerialSink(void (*sink)(char c)) {
+    serialSink = sink;
+}
+
+void HostHal::sendSerial(char c) {
+    if (serialRxCount < SERIAL_RX_SIZE) {
+        serialRx[(serialRxHead + serialRxCount) % SERIAL_RX_SIZE] = c;
+        serialRxCount++;
+    }
+}
+
+unsigned long micros() {
+    HostHal::advanceMicros(HostHal::CLOCK_READ_MICROS);
+    return (unsigned long)(uint32_t)clockMicros;
+}
+
+unsigned long millis() {
+    HostHal::advanceMicros(HostHal::CLOCK_READ_MICROS);
+    return (unsigned long)(uint32_t)(clockMicros / 1000);
+}
+
+void delay(unsigned long ms) {
+    while (ms > 0) {
+        HostHal::advanceMicros(1000);   // A millisecond at a time so listeners see every tick
+        ms--;
+    }
+}
+
+void delayMicroseconds(unsigned int us) {
+    HostHal::advanceMicros(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < NUM_DIGITAL_PINS) {
+        pins[pin].mode = mode;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin >= NUM_DIGITAL_PINS) {
+        return;
+    }
+    uint8_t level = val ? HIGH : LOW;
+    if (pins[pin].output != level) {
+        pins[pin].output = level;
+        pins[pin].toggles++;
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    if (pin >= NUM_DIGITAL_PINS) {
+        return LOW;
+    }
+    const PinState& state = pins[pin];
+    if (state.driven) {
+        return state.input;
+    }
+    if (state.mode == INPUT_PULLUP) {
+        return HIGH;
+    }
+    return state.mode == OUTPUT ? state.output : LOW;
+}
+
+int analogRead(uint8_t pin) {
+    (void)pin;
+    HostHal::advanceMicros(HostHal::ANALOG_READ_MICROS);
+    // A floating input: mid-scale with a few bits of noise
+    return 500 + (nextNoise(analogNoise) & 0x1F);
+}
+
+long random(long howBig) {
+    if (howBig <= 0) {
+        return 0;
+    }
+    return nextNoise(randomState) % howBig;
+}
+
+long random(long howSmall, long howBig) {
+    if (howSmall >= howBig) {
+        return howSmall;
+    }
+    return howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) {
+    if (seed != 0) {
+        randomState = (uint32_t)seed;
+    }
+}
+
+int HostSerial::available() {
+    return serialRxCount;
+}
+
+int HostSerial::read() {
+    if (serialRxCount == 0) {
+        return -1;
+    }
+    char c = serialRx[serialRxHead];
+    serialRxHead = (serialRxHead + 1) % SERIAL_RX_SIZE;
+    serialRxCount--;
+    return (uint8_t)c;
+}
+
+size_t HostSerial::write(uint8_t c) {
+    if (serialSink) {
+        serialSink((char)c);
+    }
+    return 1;
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (size-- > 0 && write(*buffer++)) {
+        written++;
+    }
+    return written;
+}
+
+size_t Print::print(const __FlashStringHelper* str) {
+    return print(reinterpret_cast<const char*>(str));
+}
+
+size_t Print::print(const char* str) {
+    return write(str);
+}
+
+size_t Print::print(char c) {
+    return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char value, int base) {
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(int value, int base) {
+    return print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base) {
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base) {
+    if (base == 0) {
+        return write((uint8_t)value);
+    }
+    if (base == DEC && value < 0) {
+        size_t n = print('-');
+        return n + printNumber(0UL - (unsigned long)value, DEC);
+    }
+    return printNumber((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+    if (base == 0) {
+        return write((uint8_t)value);
+    }
+    return printNumber(value, base);
+}
+
+size_t Print::print(double value, int digits) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+    return write(buffer);
+}
+
+size_t Print::println() {
+    return write("\r\n");
+}
+
+size_t Print::printNumber(unsigned long value, uint8_t base) {
+    char buffer[8 * sizeof(long) + 1];
+    char* str = &buffer[sizeof(buffer) - 1];
+    *str = '\0';
+    if (base < 2) {
+        base = 10;
+    }
+    do {
+        uint8_t digit = value % base;
+        value /= base;
+        *--str = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    } while (value);
+    return write(str);
+}
@@ -0,0 +1,157 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Virtual Arduino for running the firmware sources on a desktop.
+//
+// Time is a microsecond counter that only moves when something spends it:
+// delay(), a blocking I2C transfer, an ADC conversion, or the host program
+// stepping past an idle millisecond. Every clock read costs a microsecond
+// too, so busy-waits on millis() still finish. Pins are a plain level table
+// the host program can drive (buttons, encoder) and inspect (relays, LEDs).
+// All of it is per thread, so independent simulations can run side by side.
+//
+// ARDUINO is deliberately left undefined - sources with hardware-only code
+// (Timer1, the bootloader hand-off) fall back to their host versions.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "avr/pgmspace.h"
+#include "avr/io.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+static const uint8_t A0 = 14;
+static const uint8_t A1 = 15;
+static const uint8_t A2 = 16;
+static const uint8_t A3 = 17;
+static const uint8_t A4 = 18;
+static const uint8_t A5 = 19;
+static const uint8_t A6 = 20;
+static const uint8_t A7 = 21;
+static const uint8_t LED_BUILTIN = 13;
+static const uint8_t NUM_DIGITAL_PINS = 22;
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Templates rather than the AVR core's macros so desktop headers still compile after this one
+template <class T, class L>
+auto min(const T& a, const L& b) -> decltype((b < a) ? b : a) {
+    return (b < a) ? b : a;
+}
+
+template <class T, class L>
+auto max(const T& a, const L& b) -> decltype((b < a) ? b : a) {
+    return (a < b) ? b : a;
+}
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bit(b) (1UL << (b))
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(PSTR(string_literal)))
+
+// Arduino's Print: text and number formatting on top of write()
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+    virtual void flush() {}
+
+    size_t print(const __FlashStringHelper* str);
+    size_t print(const char* str);
+    size_t print(char c);
+    size_t print(unsigned char value, int base = DEC);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println();
+    template <class T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <class T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+
+private:
+    size_t printNumber(unsigned long value, uint8_t base);
+};
+
+// Serial port - output goes to whatever the host program plugs in (nowhere by default)
+class HostSerial : public Print {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    int available();
+    int read();
+    operator bool() { return true; }
+    size_t write(uint8_t c) override;
+    using Print::write;
+};
+
+extern HostSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+// Host program's side of the board
+class HostHal {
+public:
+    static const uint8_t CLOCK_READ_MICROS = 1;       // Cost of a millis()/micros() call
+    static const uint8_t ANALOG_READ_MICROS = 112;    // One ADC conversion at the default prescaler
+
+    // Virtual time since power-on (never wraps, unlike micros())
+    static uint64_t getMicros();
+    static void advanceMicros(uint32_t us);
+
+    // Jump past the 32-bit millis() wrap if it would come within spanMs. unsigned
+    // long is 64 bits here, so firmware time arithmetic is only wrap-safe on the AVR
+    // and long host runs must not straddle the wrap.
+    static void skipMillisWrap(uint32_t spanMs);
+
+    // Called with every clock advance - lets emulated peripherals (Timer1) keep pace
+    static void setClockListener(void (*listener)(uint32_t us));
+
+    // Drive an input from outside (button, encoder contact) - releases pull-ups
+    static void setInputLevel(uint8_t pin, uint8_t level);
+    static void releaseInput(uint8_t pin);
+
+    // Level the firmware last wrote to a pin, and how many times it changed
+    static uint8_t getOutputLevel(uint8_t pin);
+    static uint32_t getToggleCount(uint8_t pin);
+
+    // Noise source behind analogRead() - fixed seed = reproducible run
+    static void seedAnalogNoise(uint32_t seed);
+
+    // Where Serial output goes (nullptr = discarded)
+    static void setSerialSink(void (*sink)(char c));
+
+    // Queue a character for Serial.read() (dropped when 64 are already waiting)
+    static void sendSerial(char c);
+};
+
+#endif
@@ -0,0 +1,29 @@
+#include <EEPROM.h>
+
+EEPROMClass EEPROM;
+
+EEPROMClass::EEPROMClass() {
+    memset(cells, 0xFF, sizeof(cells));
+    writeCount = 0;
+}
+
+uint8_t EEPROMClass::read(int address) const {
+    if (address < 0 || address >= SIZE) {
+        return 0xFF;
+    }
+    return cells[address];
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+    if (address < 0 || address >= SIZE) {
+        return;
+    }
+    cells[address] = value;
+    writeCount++;
+}
+
+void EEPROMClass::update(int address, uint8_t value) {
+    if (read(address) != value) {
+        write(address, value);
+    }
+}
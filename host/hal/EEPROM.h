@@ -0,0 +1,45 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <Arduino.h>
+
+// 1KB of EEPROM, blank (0xFF) at start. put() only rewrites bytes that
+// changed, like the AVR library, and every real write is counted.
+class EEPROMClass {
+public:
+    static const uint16_t SIZE = 1024;
+
+    EEPROMClass();
+
+    uint8_t read(int address) const;
+    void write(int address, uint8_t value);
+    void update(int address, uint8_t value);
+    uint16_t length() const { return SIZE; }
+
+    template <class T> T& get(int address, T& value) const {
+        uint8_t* bytes = (uint8_t*)&value;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            bytes[i] = read(address + i);
+        }
+        return value;
+    }
+
+    template <class T> const T& put(int address, const T& value) {
+        const uint8_t* bytes = (const uint8_t*)&value;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            update(address + i, bytes[i]);
+        }
+        return value;
+    }
+
+    // Host only
+    uint32_t getWriteCount() const { return writeCount; }
+
+private:
+    uint8_t cells[SIZE];
+    uint32_t writeCount;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
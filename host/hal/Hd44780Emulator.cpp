@@ -0,0 +1,204 @@
+#include "Hd44780Emulator.h"
+
+// Expander port bits
+static const uint8_t PORT_RS = 0x01;
+static const uint8_t PORT_RW = 0x02;
+static const uint8_t PORT_E = 0x04;
+static const uint8_t PORT_BACKLIGHT = 0x08;
+
+// DDRAM address of each row's first cell on a 20x4 module
+static const uint8_t ROW_START[Hd44780Emulator::ROWS] = { 0x00, 0x40, 0x14, 0x54 };
+
+Hd44780Emulator::Hd44780Emulator() {
+    memset(ddram, ' ', sizeof(ddram));
+    memset(cgram, 0, sizeof(cgram));
+    addressCounter = 0;
+    addressingCgram = false;
+    incrementAddress = true;
+    fourBitMode = false;        // Power-on reset leaves the interface 8 bits wide
+    twoLineMode = false;
+    displayOn = false;
+    backlightOn = false;
+    highNibblePending = false;
+    highNibble = 0;
+    lowNibbleRead = false;
+    rwGrounded = false;
+    backlightActiveLow = false;
+    instructionNanos = INSTRUCTION_NANOS;
+    port = 0;
+    maxClock = 400000;
+    nowNanos = 0;
+    busyUntilNanos = 0;
+    resetStats();
+}
+
+void Hd44780Emulator::receive(const uint8_t* data, uint8_t length) {
+    // Wire calls this once the transfer is over - byte i was acknowledged
+    // (and reached the port) 9 bits per later byte plus the stop bit earlier
+    uint64_t bitNanos = 1000000000ULL / Wire.getClock();
+    uint64_t endNanos = HostHal::getMicros() * 1000;
+    for (uint8_t i = 0; i < length; i++) {
+        nowNanos = endNanos - bitNanos * (1 + 9 * (length - 1 - i));
+        writePort(data[i]);
+    }
+}
+
+uint8_t Hd44780Emulator::request(uint8_t* data, uint8_t length) {
+    uint8_t pins = port;
+    if (!backlightActiveLow) {
+        pins &= ~PORT_BACKLIGHT;    // Held at the transistor's base voltage
+    }
+    if (!rwGrounded && (port & PORT_RW) && (port & PORT_E)) {
+        // Quasi-bidirectional port: the LCD can pull released (high) lines low
+        bool busy = HostHal::getMicros() * 1000 < busyUntilNanos;
+        uint8_t status = (busy ? 0x80 : 0) | addressCounter;
+        uint8_t nibble = (fourBitMode && lowNibbleRead) ? (status & 0x0F) : (status >> 4);
+        pins &= (nibble << 4) | 0x0F;
+    }
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] = pins;
+    }
+    return length;
+}
+
+uint8_t Hd44780Emulator::getCell(uint8_t row, uint8_t col) const {
+    if (row >= ROWS || col >= COLS) {
+        return ' ';
+    }
+    return ddram[ROW_START[row] + col];
+}
+
+const uint8_t* Hd44780Emulator::getGlyph(uint8_t slot) const {
+    return &cgram[(slot & 7) * 8];
+}
+
+void Hd44780Emulator::setBacklightActiveLow(bool activeLow) {
+    backlightActiveLow = activeLow;
+    backlightOn = (port & PORT_BACKLIGHT) ? !activeLow : activeLow;
+}
+
+void Hd44780Emulator::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void Hd44780Emulator::writePort(uint8_t value) {
+    stats.portWrites++;
+    bool wasEnabled = port & PORT_E;
+    port = value;
+    backlightOn = (value & PORT_BACKLIGHT) ? !backlightActiveLow : backlightActiveLow;
+    if (wasEnabled && !(value & PORT_E)) {
+        latch(value);
+    }
+}
+
+void Hd44780Emulator::latch(uint8_t value) {
+    stats.strobes++;
+    if ((value & PORT_RW) && !rwGrounded) {
+        // Busy flag read - allowed while busy, nothing is written
+        if (fourBitMode) {
+            lowNibbleRead = !lowNibbleRead;
+        }
+        return;
+    }
+    if (nowNanos < busyUntilNanos) {
+        stats.busyViolations++;
+    }
+    bool dataRegister = value & PORT_RS;
+    uint8_t nibble = value >> 4;
+
+    // D0-D3 aren't wired, so an 8-bit mode strobe carries just the high half
+    if (!fourBitMode) {
+        execute(dataRegister, nibble << 4);
+        return;
+    }
+    if (!highNibblePending) {
+        highNibble = nibble;
+        highNibblePending = true;
+        return;
+    }
+    highNibblePending = false;
+    execute(dataRegister, (highNibble << 4) | nibble);
+}
+
+void Hd44780Emulator::execute(bool dataRegister, uint8_t value) {
+    bool slow = !dataRegister && (value == 0x01 || (value & 0xFE) == 0x02);
+    busyUntilNanos = nowNanos + (slow ? CLEAR_NANOS : instructionNanos);
+    if (dataRegister) {
+        writeData(value);
+    } else {
+        instruction(value);
+    }
+}
+
+void Hd44780Emulator::instruction(uint8_t value) {
+    stats.instructions++;
+    if (value & 0x80) {
+        // Set DDRAM address
+        addressingCgram = false;
+        addressCounter = value & 0x7F;
+    } else if (value & 0x40) {
+        // Set CGRAM address
+        addressingCgram = true;
+        addressCounter = value & 0x3F;
+    } else if (value & 0x20) {
+        // Function set - DL picks the interface width
+        fourBitMode = !(value & 0x10);
+        twoLineMode = value & 0x08;
+        highNibblePending = false;
+        lowNibbleRead = false;
+    } else if (value & 0x10) {
+        // Cursor or display shift - only cursor moves are modelled (the firmware never shifts)
+        if (!(value & 0x08)) {
+            bool savedIncrement = incrementAddress;
+            incrementAddress = value & 0x04;
+            stepAddress();
+            incrementAddress = savedIncrement;
+        }
+    } else if (value & 0x08) {
+        displayOn = value & 0x04;
+    } else if (value & 0x04) {
+        incrementAddress = value & 0x02;
+    } else if (value & 0x02) {
+        // Return home
+        addressingCgram = false;
+        addressCounter = 0;
+    } else if (value & 0x01) {
+        // Clear display
+        memset(ddram, ' ', sizeof(ddram));
+        addressingCgram = false;
+        addressCounter = 0;
+        incrementAddress = true;
+    }
+}
+
+void Hd44780Emulator::writeData(uint8_t value) {
+    if (addressingCgram) {
+        stats.cgramWrites++;
+        cgram[addressCounter & 0x3F] = value & 0x1F;
+        addressCounter = (addressCounter + (incrementAddress ? 1 : -1)) & 0x3F;
+        return;
+    }
+    stats.characters++;
+    if (ddram[addressCounter] == value) {
+        stats.unchangedCharacters++;
+    }
+    ddram[addressCounter] = value;
+    stepAddress();
+}
+
+void Hd44780Emulator::stepAddress() {
+    // Two-line mode: 0x00-0x27 and 0x40-0x67, each running on into the other
+    if (twoLineMode) {
+        if (incrementAddress) {
+            addressCounter = addressCounter == 0x27 ? 0x40 : (addressCounter == 0x67 ? 0x00 : addressCounter + 1);
+        } else {
+            addressCounter = addressCounter == 0x40 ? 0x27 : (addressCounter == 0x00 ? 0x67 : addressCounter - 1);
+        }
+    } else {
+        if (incrementAddress) {
+            addressCounter = addressCounter == 0x4F ? 0x00 : addressCounter + 1;
+        } else {
+            addressCounter = addressCounter == 0x00 ? 0x4F : addressCounter - 1;
+        }
+    }
+}
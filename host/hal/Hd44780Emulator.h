@@ -0,0 +1,105 @@
+#ifndef HOST_HD44780_EMULATOR_H
+#define HOST_HD44780_EMULATOR_H
+
+#include <Wire.h>
+
+// The far end of the bus: a PCF8574 port expander wired to an HD44780.
+//
+// Every byte the backpack receives becomes the expander's port state. A
+// falling edge on E latches D4-D7 into the controller, which starts in
+// 8-bit mode (low data lines unconnected) until a function set switches it
+// to 4-bit, then pairs nibbles high-first. Instructions and data update
+// DDRAM, CGRAM and the address counter the way the datasheet describes,
+// so what getCell() returns is what the glass would show. Each port write
+// is timed from its place in the transfer, so a nibble latched while the
+// previous instruction is still executing is counted as a busy violation
+// (a real controller would drop it).
+// Wiring as on the common backpack: P0=RS, P1=RW, P2=E, P3=backlight,
+// P4-P7=D4-D7. A strobe with RW high is a status read: while E is high the
+// controller pulls D7 low unless busy and D4-D6 (then D4-D7 for the second
+// nibble in 4-bit mode) low where the address counter has a 0 bit. Boards
+// with RW tied to ground and backlights switched low can be emulated too.
+class Hd44780Emulator : public I2CDevice {
+public:
+    static const uint8_t COLS = 20;
+    static const uint8_t ROWS = 4;
+
+    // Execution times at the nominal 270 kHz oscillator
+    static const uint32_t CLEAR_NANOS = 1520000;    // Clear display, return home
+    static const uint32_t INSTRUCTION_NANOS = 37000; // Everything else, data writes included
+    static const uint32_t SLOW_INSTRUCTION_NANOS = 72000;  // Clone on a ~140 kHz oscillator
+
+    struct Stats {
+        uint32_t portWrites;        // Bytes written to the expander
+        uint32_t strobes;           // Nibbles latched
+        uint32_t instructions;
+        uint32_t characters;        // DDRAM data writes
+        uint32_t unchangedCharacters;   // ...that wrote what was already there
+        uint32_t cgramWrites;       // CGRAM data bytes (8 per glyph)
+        uint32_t busyViolations;    // Nibbles latched before the last instruction finished
+    };
+
+    Hd44780Emulator();
+
+    void receive(const uint8_t* data, uint8_t length) override;
+
+    // Reading the expander returns its port as the pins read: the LCD drives
+    // D4-D7 during a status read, and a backlight pin driving an NPN base
+    // (active high) reads low
+    uint8_t request(uint8_t* data, uint8_t length) override;
+
+    // PCF8574 is specified for 100 kHz but most backpacks run at 400 kHz
+    uint32_t getMaxClock() const override { return maxClock; }
+    void setMaxClock(uint32_t hz) { maxClock = hz; }
+
+    // Board variants: RW wired to ground (writes only), backlight on when P3 is low
+    void setRwGrounded(bool grounded) { rwGrounded = grounded; }
+    void setBacklightActiveLow(bool activeLow);
+
+    // Execution time of everything but clear and home
+    void setInstructionNanos(uint32_t nanos) { instructionNanos = nanos; }
+
+    // Character code in a cell (codes 0-15 show CGRAM glyph code & 7)
+    uint8_t getCell(uint8_t row, uint8_t col) const;
+
+    // 8 rows of 5 pixels (bit 4 = leftmost) for a CGRAM slot
+    const uint8_t* getGlyph(uint8_t slot) const;
+
+    bool isDisplayOn() const { return displayOn; }
+    bool isBacklightOn() const { return backlightOn; }
+    bool isFourBitMode() const { return fourBitMode; }
+
+    const Stats& getStats() const { return stats; }
+    void resetStats();
+
+private:
+    uint8_t ddram[128];         // Indexed by DDRAM address (two-line mode: 0x00-0x27, 0x40-0x67)
+    uint8_t cgram[64];
+    uint8_t addressCounter;
+    bool addressingCgram;       // Last address instruction was Set CGRAM Address
+    bool incrementAddress;
+    bool fourBitMode;
+    bool twoLineMode;
+    bool displayOn;
+    bool backlightOn;
+    bool highNibblePending;     // 4-bit mode: first half of a byte received
+    bool lowNibbleRead;         // 4-bit mode: next status read strobe returns the low half
+    bool rwGrounded;
+    bool backlightActiveLow;
+    uint32_t instructionNanos;
+    uint8_t highNibble;
+    uint8_t port;               // Expander output state
+    uint32_t maxClock;
+    uint64_t nowNanos;          // When the port write being handled happened
+    uint64_t busyUntilNanos;    // End of the executing instruction
+    Stats stats;
+
+    void writePort(uint8_t value);
+    void latch(uint8_t value);
+    void execute(bool dataRegister, uint8_t value);
+    void instruction(uint8_t value);
+    void writeData(uint8_t value);
+    void stepAddress();
+};
+
+#endif
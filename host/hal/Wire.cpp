@@ -0,0 +1,125 @@
+#include <Wire.h>
+
+TwoWire Wire;
+
+TwoWire::TwoWire() {
+    deviceCount = 0;
+    clockHz = 100000;   // Wire's default
+    txAddress = 0;
+    txLength = 0;
+    txOverflow = false;
+    rxLength = 0;
+    rxIndex = 0;
+    resetStats();
+}
+
+void TwoWire::begin() {
+}
+
+void TwoWire::setClock(uint32_t frequency) {
+    if (frequency > 0) {
+        clockHz = frequency;
+    }
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    txAddress = address;
+    txLength = 0;
+    txOverflow = false;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    // Like the AVR library, bytes past the buffer are dropped
+    if (txLength >= BUFFER_LENGTH) {
+        txOverflow = true;
+        return 0;
+    }
+    txBuffer[txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length) {
+    size_t written = 0;
+    while (written < length && write(data[written])) {
+        written++;
+    }
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    I2CDevice* device = findDevice(txAddress);
+    spendBusTime(txLength, device != nullptr);
+    if (!device) {
+        return 2;   // NACK on address
+    }
+    device->receive(txBuffer, txLength);
+    txLength = 0;
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity) {
+    I2CDevice* device = findDevice(address);
+    rxIndex = 0;
+    rxLength = 0;
+    if (device) {
+        rxLength = device->request(rxBuffer, min(quantity, (uint8_t)BUFFER_LENGTH));
+    }
+    spendBusTime(rxLength, device != nullptr);
+    return rxLength;
+}
+
+int TwoWire::available() {
+    return rxLength - rxIndex;
+}
+
+int TwoWire::read() {
+    return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1;
+}
+
+void TwoWire::attach(uint8_t address, I2CDevice* device) {
+    if (deviceCount < MAX_DEVICES) {
+        devices[deviceCount].address = address;
+        devices[deviceCount].device = device;
+        deviceCount++;
+    }
+}
+
+uint32_t TwoWire::getClock() const {
+    return clockHz;
+}
+
+const TwoWire::BusStats& TwoWire::getStats() const {
+    return stats;
+}
+
+void TwoWire::resetStats() {
+    stats.transactions = 0;
+    stats.bytes = 0;
+    stats.nacks = 0;
+    stats.busMicros = 0;
+}
+
+I2CDevice* TwoWire::findDevice(uint8_t address) const {
+    for (uint8_t i = 0; i < deviceCount; i++) {
+        if (devices[i].address == address && clockHz <= devices[i].device->getMaxClock()) {
+            return devices[i].device;
+        }
+    }
+    return nullptr;
+}
+
+uint32_t TwoWire::spendBusTime(uint8_t bytes, bool acknowledged) {
+    // Start, address, then the data bytes if the address was acknowledged, stop
+    uint32_t bits = 2 + 9UL * (acknowledged ? 1 + bytes : 1);
+    uint32_t busMicros = (bits * 1000000UL + clockHz - 1) / clockHz;
+    stats.busMicros += busMicros;
+    if (acknowledged) {
+        stats.transactions++;
+        stats.bytes += bytes;
+    } else {
+        stats.nacks++;
+    }
+    HostHal::advanceMicros(busMicros);
+    return busMicros;
+}
@@ -0,0 +1,80 @@
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH 32
+
+// Something answering on the virtual I2C bus
+class I2CDevice {
+public:
+    virtual ~I2CDevice() {}
+
+    // One write transaction's payload, in order
+    virtual void receive(const uint8_t* data, uint8_t length) = 0;
+
+    // Answer a read transaction - returns how many bytes were filled in
+    virtual uint8_t request(uint8_t* data, uint8_t length) = 0;
+
+    // Fastest SCL the device still answers at
+    virtual uint32_t getMaxClock() const = 0;
+};
+
+// Arduino's Wire. Transfers block, so each one spends its bus time on the
+// virtual clock at the configured SCL rate: start + address + data bytes
+// (9 bits each with the ACK) + stop. A device clocked faster than it
+// supports doesn't acknowledge its address.
+class TwoWire {
+public:
+    struct BusStats {
+        uint32_t transactions;      // Acknowledged write and read transactions
+        uint32_t bytes;             // Payload bytes either way (address bytes not included)
+        uint32_t nacks;             // Transactions nobody answered (probes of empty addresses)
+        uint32_t busMicros;         // Time SCL was busy
+    };
+
+    TwoWire();
+
+    void begin();
+    void setClock(uint32_t frequency);
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* data, size_t length);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity);
+    int available();
+    int read();
+
+    // Host only
+    void attach(uint8_t address, I2CDevice* device);
+    uint32_t getClock() const;
+    const BusStats& getStats() const;
+    void resetStats();
+
+private:
+    static const uint8_t MAX_DEVICES = 4;
+
+    struct Attachment {
+        uint8_t address;
+        I2CDevice* device;
+    };
+
+    Attachment devices[MAX_DEVICES];
+    uint8_t deviceCount;
+    uint32_t clockHz;
+    uint8_t txAddress;
+    uint8_t txBuffer[BUFFER_LENGTH];
+    uint8_t txLength;
+    bool txOverflow;
+    uint8_t rxBuffer[BUFFER_LENGTH];
+    uint8_t rxLength;
+    uint8_t rxIndex;
+    BusStats stats;
+
+    I2CDevice* findDevice(uint8_t address) const;
+    uint32_t spendBusTime(uint8_t bytes, bool acknowledged);
+};
+
+extern TwoWire Wire;
+
+#endif
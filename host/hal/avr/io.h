@@ -0,0 +1,15 @@
+#ifndef HOST_AVR_IO_H
+#define HOST_AVR_IO_H
+
+// Only the registers the firmware reads outside its ARDUINO-only code
+
+#include <stdint.h>
+
+// MCU status register - the host program sets the reset cause before setup()
+extern uint8_t MCUSR;
+#define PORF 0
+#define EXTRF 1
+#define BORF 2
+#define WDRF 3
+
+#endif
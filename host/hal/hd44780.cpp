@@ -0,0 +1,183 @@
+#include <hd44780.h>
+#include <hd44780ioClass/hd44780_I2Cexp.h>
+
+// Instruction set
+static const uint8_t LCD_CLEAR = 0x01;
+static const uint8_t LCD_HOME = 0x02;
+static const uint8_t LCD_ENTRY_MODE = 0x04;
+static const uint8_t LCD_DISPLAY_CONTROL = 0x08;
+static const uint8_t LCD_FUNCTION_SET = 0x20;
+static const uint8_t LCD_SET_CGRAM = 0x40;
+static const uint8_t LCD_SET_DDRAM = 0x80;
+
+static const uint8_t ENTRY_INCREMENT = 0x02;
+static const uint8_t DISPLAY_ON = 0x04;
+static const uint8_t FUNCTION_TWO_LINES = 0x08;
+
+hd44780::hd44780() {
+    cols = 0;
+    rows = 0;
+    displayControl = DISPLAY_ON;
+    chExecTime = HD44780_CHEXECTIME;
+    insExecTime = HD44780_INSEXECTIME;
+    lastInstructionMicros = 0;
+    lastExecTime = 0;
+}
+
+int hd44780::begin(uint8_t cols, uint8_t rows) {
+    this->cols = cols;
+    this->rows = rows;
+
+    int status = ioinit();
+    if (status != RV_ENOERR) {
+        return status;
+    }
+
+    // Datasheet 4-bit initialisation: three 8-bit function sets, then switch to 4-bit
+    send(HD44780_IOcmd4bit, 0x03, 4100);
+    send(HD44780_IOcmd4bit, 0x03, 100);
+    send(HD44780_IOcmd4bit, 0x03, HD44780_INSEXECTIME);
+    send(HD44780_IOcmd4bit, 0x02, HD44780_INSEXECTIME);
+
+    send(HD44780_IOcmd, LCD_FUNCTION_SET | (rows > 1 ? FUNCTION_TWO_LINES : 0), insExecTime);
+    displayControl = DISPLAY_ON;
+    send(HD44780_IOcmd, LCD_DISPLAY_CONTROL | displayControl, insExecTime);
+    clear();
+    send(HD44780_IOcmd, LCD_ENTRY_MODE | ENTRY_INCREMENT, insExecTime);
+    backlight();
+    return RV_ENOERR;
+}
+
+int hd44780::clear() {
+    return send(HD44780_IOcmd, LCD_CLEAR, chExecTime);
+}
+
+int hd44780::home() {
+    return send(HD44780_IOcmd, LCD_HOME, chExecTime);
+}
+
+int hd44780::setCursor(uint8_t col, uint8_t row) {
+    // Rows 2 and 3 continue rows 0 and 1 in DDRAM
+    static const uint8_t rowOffsets[] = { 0x00, 0x40, 0x00, 0x40 };
+    if (row >= rows) {
+        row = rows - 1;
+    }
+    uint8_t address = rowOffsets[row & 3] + col + (row >= 2 ? cols : 0);
+    return send(HD44780_IOcmd, LCD_SET_DDRAM | address, insExecTime);
+}
+
+int hd44780::createChar(uint8_t location, const uint8_t charmap[]) {
+    int status = send(HD44780_IOcmd, LCD_SET_CGRAM | ((location & 7) << 3), insExecTime);
+    for (uint8_t i = 0; i < 8 && status == RV_ENOERR; i++) {
+        status = send(HD44780_IOdata, charmap[i], insExecTime);
+    }
+    return status;
+}
+
+int hd44780::display() {
+    displayControl |= DISPLAY_ON;
+    return send(HD44780_IOcmd, LCD_DISPLAY_CONTROL | displayControl, insExecTime);
+}
+
+int hd44780::noDisplay() {
+    displayControl &= ~DISPLAY_ON;
+    return send(HD44780_IOcmd, LCD_DISPLAY_CONTROL | displayControl, insExecTime);
+}
+
+int hd44780::backlight() {
+    return iosetbacklight(255);
+}
+
+int hd44780::noBacklight() {
+    return iosetbacklight(0);
+}
+
+int hd44780::command(uint8_t cmd) {
+    return send(HD44780_IOcmd, cmd, cmd <= LCD_HOME ? chExecTime : insExecTime);
+}
+
+size_t hd44780::write(uint8_t value) {
+    return send(HD44780_IOdata, value, insExecTime) == RV_ENOERR ? 1 : 0;
+}
+
+void hd44780::setExecTimes(uint32_t chExecTimeUs, uint32_t insExecTimeUs) {
+    chExecTime = chExecTimeUs;
+    insExecTime = insExecTimeUs;
+}
+
+int hd44780::send(iotype type, uint8_t value, uint32_t execTime) {
+    waitReady();
+    int status = iowrite(type, value);
+    lastInstructionMicros = micros();
+    lastExecTime = execTime;
+    return status;
+}
+
+void hd44780::waitReady() {
+    // Only blocks if the previous instruction can still be executing
+    uint32_t elapsed = micros() - lastInstructionMicros;
+    if (elapsed < lastExecTime) {
+        delayMicroseconds(lastExecTime - elapsed);
+    }
+}
+
+hd44780_I2Cexp::hd44780_I2Cexp() {
+    address = 0;
+    backlightMask = PIN_BACKLIGHT;
+}
+
+hd44780_I2Cexp::hd44780_I2Cexp(uint8_t address) {
+    this->address = address;
+    backlightMask = PIN_BACKLIGHT;
+}
+
+int hd44780_I2Cexp::ioinit() {
+    Wire.begin();
+
+    // Auto-locate: PCF8574 answers at 0x20-0x27, PCF8574A at 0x38-0x3F
+    if (address == 0) {
+        static const uint8_t firstAddresses[] = { 0x20, 0x38 };
+        for (uint8_t bank = 0; bank < 2 && address == 0; bank++) {
+            for (uint8_t a = firstAddresses[bank]; a < firstAddresses[bank] + 8; a++) {
+                Wire.beginTransmission(a);
+                if (Wire.endTransmission() == 0) {
+                    address = a;
+                    break;
+                }
+            }
+        }
+        if (address == 0) {
+            return RV_ENXIO;
+        }
+    }
+
+    // All port lines low before the controller sees its first strobe
+    Wire.beginTransmission(address);
+    Wire.write((uint8_t)0);
+    return Wire.endTransmission() == 0 ? RV_ENOERR : RV_EIO;
+}
+
+int hd44780_I2Cexp::iowrite(iotype type, uint8_t value) {
+    uint8_t control = (type == HD44780_IOdata ? PIN_RS : 0) | backlightMask;
+    Wire.beginTransmission(address);
+    if (type == HD44780_IOcmd4bit) {
+        writeNibble(value & 0x0F, control);
+    } else {
+        writeNibble(value >> 4, control);
+        writeNibble(value & 0x0F, control);
+    }
+    return Wire.endTransmission() == 0 ? RV_ENOERR : RV_EIO;
+}
+
+int hd44780_I2Cexp::iosetbacklight(uint8_t dimvalue) {
+    backlightMask = dimvalue ? PIN_BACKLIGHT : 0;
+    Wire.beginTransmission(address);
+    Wire.write(backlightMask);
+    return Wire.endTransmission() == 0 ? RV_ENOERR : RV_EIO;
+}
+
+void hd44780_I2Cexp::writeNibble(uint8_t nibble, uint8_t control) {
+    uint8_t value = (nibble << 4) | control;
+    Wire.write(value | PIN_E);
+    Wire.write(value);
+}
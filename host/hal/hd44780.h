@@ -0,0 +1,66 @@
+#ifndef HOST_HD44780_H
+#define HOST_HD44780_H
+
+#include <Arduino.h>
+
+// Instruction execution times (the library's defaults)
+#define HD44780_CHEXECTIME 2000     // clear, home
+#define HD44780_INSEXECTIME 38      // everything else
+
+// Host stand-in for the hd44780 library's LCD API and its i/o class hooks.
+//
+// Commands and characters go out through iowrite() as the library sends
+// them, and the library's lazy execution-time waits are kept: it remembers
+// when the last instruction started and only spins (on the virtual clock)
+// if the next one comes too soon.
+class hd44780 : public Print {
+public:
+    // Return values, as in the library
+    static const int RV_ENOERR = 0;
+    static const int RV_EIO = -1;
+    static const int RV_ENOTSUP = -3;
+    static const int RV_ENXIO = -4;
+
+    enum iotype {
+        HD44780_IOcmd,          // Full instruction
+        HD44780_IOdata,         // Character or CGRAM data
+        HD44780_IOcmd4bit       // Low nibble only, during 4-bit initialisation
+    };
+
+    hd44780();
+
+    int begin(uint8_t cols, uint8_t rows);
+    int clear();
+    int home();
+    int setCursor(uint8_t col, uint8_t row);
+    int createChar(uint8_t location, const uint8_t charmap[]);
+    int display();
+    int noDisplay();
+    int backlight();
+    int noBacklight();
+    int command(uint8_t cmd);
+    size_t write(uint8_t value) override;
+    using Print::write;
+
+    // Override the instruction execution times the library waits for
+    void setExecTimes(uint32_t chExecTimeUs, uint32_t insExecTimeUs);
+
+private:
+    // i/o class hooks
+    virtual int ioinit() { return RV_ENOERR; }
+    virtual int iowrite(iotype type, uint8_t value) = 0;
+    virtual int iosetbacklight(uint8_t dimvalue) { (void)dimvalue; return RV_ENOERR; }
+
+    uint8_t cols;
+    uint8_t rows;
+    uint8_t displayControl;
+    uint32_t chExecTime;
+    uint32_t insExecTime;
+    uint32_t lastInstructionMicros;
+    uint32_t lastExecTime;
+
+    int send(iotype type, uint8_t value, uint32_t execTime);
+    void waitReady();
+};
+
+#endif
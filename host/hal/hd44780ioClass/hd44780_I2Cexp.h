@@ -0,0 +1,33 @@
+#ifndef HOST_HD44780_I2CEXP_H
+#define HOST_HD44780_I2CEXP_H
+
+#include <hd44780.h>
+#include <Wire.h>
+
+// The library's auto-configuring expander class, for backpacks LcdTransport
+// doesn't handle. Only the common PCF8574 wiring is emulated: P0=RS, P1=RW
+// (unused - it never reads), P2=E, P3=backlight (active high), P4-P7=D4-D7.
+// Like the library, each instruction or character is one Wire transmission
+// carrying both nibbles, and each nibble is two port writes - E high, then
+// E low to latch it.
+class hd44780_I2Cexp : public hd44780 {
+public:
+    hd44780_I2Cexp();                   // Find the backpack on the bus during begin()
+    explicit hd44780_I2Cexp(uint8_t address);
+
+private:
+    static const uint8_t PIN_RS = 0x01;
+    static const uint8_t PIN_E = 0x04;
+    static const uint8_t PIN_BACKLIGHT = 0x08;
+
+    uint8_t address;        // 0 = not located yet
+    uint8_t backlightMask;
+
+    int ioinit() override;
+    int iowrite(iotype type, uint8_t value) override;
+    int iosetbacklight(uint8_t dimvalue) override;
+
+    void writeNibble(uint8_t nibble, uint8_t control);
+};
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef HOST_NEW_H
+#define HOST_NEW_H
+
+// Placement new, as the AVR core's <new.h> provides it
+#include <new>
+
+#endif
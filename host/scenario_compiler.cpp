@@ -0,0 +1,279 @@
+// Host tool: compiles a scenario script into ScenarioPlayer bytecode
+//
+// Build and run from the project root:
+//   g++ -O2 -std=c++11 -Iinclude host/scenario_compiler.cpp -o scenario_compiler
+//   ./scenario_compiler host/scenarios/office_day.txt SHOW_SCENARIO > include/ShowScenario.h
+//
+// The output is a header with the bytecode as a PROGMEM array, each
+// instruction on its own line next to the script line it came from.
+//
+// Script syntax - one command per line, # starts a comment:
+//   at 10:00            wait until 10 minutes into the show (also H:MM:SS)
+//   wait 30s            also ms, m
+//   lines 4             active lines (0-8)
+//   concurrent 2        concurrent call limit (1-8)
+//   delay 120           Call Timing setting in seconds (10-1000)
+//   rate 900            arrivals per hour ("rate off" goes back to Call Timing)
+//   call 3 rings 4 short uk     start a call on line 3 (1-8); rings, short, uk optional.
+//                       Skipped if line 3 isn't active when it runs (see "lines")
+//   hangup 3            or "hangup all"
+//   top:                label
+//   jump top
+//   end
+// "at" times count along the script from the top, so they only make sense
+// before the first jump.
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ScenarioFormat.h"
+
+struct Instruction {
+    std::vector<uint8_t> bytes;
+    int sourceLine;
+    std::string text;
+};
+
+struct Fixup {
+    size_t instruction;     // Index of the jump whose target is a label
+    std::string label;
+    int sourceLine;
+};
+
+static const char* scriptPath = "";
+static std::vector<Instruction> program;
+static uint16_t codeSize = 0;
+static std::map<std::string, uint16_t> labels;
+static std::vector<Fixup> fixups;
+static unsigned long showClock = 0;     // ms into the show, along the text
+static bool clockKnown = true;
+
+static void fail(int line, const std::string& message) {
+    fprintf(stderr, "%s:%d: %s\n", scriptPath, line, message.c_str());
+    exit(1);
+}
+
+static void emit(int line, const std::string& text, uint8_t opcode, std::vector<uint8_t> operands = std::vector<uint8_t>()) {
+    Instruction instruction;
+    instruction.bytes.push_back(opcode);
+    for (uint8_t operand : operands) {
+        instruction.bytes.push_back(operand);
+    }
+    instruction.sourceLine = line;
+    instruction.text = text;
+    if (instruction.bytes.size() != Scenario::instructionLength(opcode)) {
+        fail(line, "internal error: wrong operand count");
+    }
+    codeSize += instruction.bytes.size();
+    program.push_back(instruction);
+}
+
+static std::vector<uint8_t> u16(unsigned long value) {
+    return std::vector<uint8_t>{ (uint8_t)(value & 0xFF), (uint8_t)(value >> 8) };
+}
+
+static long parseNumber(int line, const std::string& word, long minValue, long maxValue) {
+    char* end = nullptr;
+    long value = strtol(word.c_str(), &end, 10);
+    if (word.empty() || *end != '\0') {
+        fail(line, "expected a number, got '" + word + "'");
+    }
+    if (value < minValue || value > maxValue) {
+        fail(line, word + " is out of range (" + std::to_string(minValue) + "-" + std::to_string(maxValue) + ")");
+    }
+    return value;
+}
+
+// "30s", "500ms", "2m"
+static unsigned long parseDuration(int line, const std::string& word) {
+    size_t digits = 0;
+    while (digits < word.size() && isdigit((unsigned char)word[digits])) {
+        digits++;
+    }
+    std::string unit = word.substr(digits);
+    unsigned long value = parseNumber(line, word.substr(0, digits), 0, 100000000L);
+    if (unit == "ms") return value;
+    if (unit == "s") return value * 1000;
+    if (unit == "m") return value * 60000;
+    fail(line, "duration needs a unit (ms, s, m): '" + word + "'");
+    return 0;
+}
+
+// "M:SS" or "H:MM:SS"
+static unsigned long parseClock(int line, const std::string& word) {
+    unsigned long fields[3];
+    int count = 0;
+    std::stringstream stream(word);
+    std::string field;
+    while (std::getline(stream, field, ':')) {
+        if (count == 3) {
+            fail(line, "bad time '" + word + "'");
+        }
+        fields[count++] = parseNumber(line, field, 0, 100000);
+    }
+    if (count < 2) {
+        fail(line, "time must be M:SS or H:MM:SS, got '" + word + "'");
+    }
+    unsigned long seconds = 0;
+    for (int i = 0; i < count; i++) {
+        seconds = seconds * 60 + fields[i];
+    }
+    return seconds * 1000;
+}
+
+// Waits in whole seconds where possible, the 16-bit operands split long ones
+static void emitWait(int line, const std::string& text, unsigned long ms) {
+    while (ms > 0) {
+        if (ms % 1000 == 0 || ms > 0xFFFF) {
+            unsigned long seconds = std::min(ms / 1000, 0xFFFFUL);
+            emit(line, text, Scenario::OP_WAIT_S, u16(seconds));
+            ms -= seconds * 1000;
+        } else {
+            emit(line, text, Scenario::OP_WAIT_MS, u16(ms));
+            ms = 0;
+        }
+    }
+}
+
+static void compileLine(int line, const std::string& source) {
+    std::string text = source.substr(0, source.find('#'));
+    std::stringstream stream(text);
+    std::vector<std::string> words;
+    std::string word;
+    while (stream >> word) {
+        words.push_back(word);
+    }
+    if (words.empty()) {
+        return;
+    }
+
+    // Trim for the listing comment
+    size_t first = text.find_first_not_of(" \t");
+    size_t last = text.find_last_not_of(" \t\r\n");
+    std::string listing = text.substr(first, last - first + 1);
+
+    const std::string& command = words[0];
+    size_t argc = words.size() - 1;
+
+    if (command.back() == ':' && argc == 0) {
+        std::string name = command.substr(0, command.size() - 1);
+        if (labels.count(name)) {
+            fail(line, "label '" + name + "' defined twice");
+        }
+        labels[name] = codeSize;
+    } else if (command == "at" && argc == 1) {
+        if (!clockKnown) {
+            fail(line, "'at' after a jump - use 'wait'");
+        }
+        unsigned long target = parseClock(line, words[1]);
+        if (target < showClock) {
+            fail(line, "'at " + words[1] + "' is earlier than the script has already reached");
+        }
+        emitWait(line, listing, target - showClock);
+        showClock = target;
+    } else if (command == "wait" && argc == 1) {
+        unsigned long ms = parseDuration(line, words[1]);
+        emitWait(line, listing, ms);
+        showClock += ms;
+    } else if (command == "lines" && argc == 1) {
+        emit(line, listing, Scenario::OP_LINES, { (uint8_t)parseNumber(line, words[1], 0, 8) });
+    } else if (command == "concurrent" && argc == 1) {
+        emit(line, listing, Scenario::OP_CONCURRENT, { (uint8_t)parseNumber(line, words[1], 1, 8) });
+    } else if (command == "delay" && argc == 1) {
+        emit(line, listing, Scenario::OP_DELAY, u16(parseNumber(line, words[1], 10, 1000)));
+    } else if (command == "rate" && argc == 1) {
+        unsigned long rate = words[1] == "off" ? 0 : parseNumber(line, words[1], 1, 0xFFFF);
+        emit(line, listing, Scenario::OP_RATE, u16(rate));
+    } else if (command == "call" && argc >= 1) {
+        uint8_t phone = parseNumber(line, words[1], 1, 8) - 1;
+        uint8_t rings = 0;
+        uint8_t flags = 0;
+        for (size_t i = 2; i < words.size(); i++) {
+            if (words[i] == "rings" && i + 1 < words.size()) {
+                rings = parseNumber(line, words[++i], 1, 8);
+            } else if (words[i] == "short") {
+                flags |= Scenario::CALL_CUT_SHORT;
+            } else if (words[i] == "uk") {
+                flags |= Scenario::CALL_UK_STYLE;
+            } else {
+                fail(line, "unknown call option '" + words[i] + "'");
+            }
+        }
+        if (flags && rings == 0) {
+            fail(line, "'short' and 'uk' need a ring count");
+        }
+        emit(line, listing, Scenario::OP_CALL, { phone, rings, flags });
+    } else if (command == "hangup" && argc == 1) {
+        uint8_t phone = words[1] == "all" ? Scenario::ALL_LINES : parseNumber(line, words[1], 1, 8) - 1;
+        emit(line, listing, Scenario::OP_HANGUP, { phone });
+    } else if (command == "jump" && argc == 1) {
+        fixups.push_back(Fixup{ program.size(), words[1], line });
+        emit(line, listing, Scenario::OP_JUMP, u16(0));
+        clockKnown = false;
+    } else if (command == "end" && argc == 0) {
+        emit(line, listing, Scenario::OP_END);
+        clockKnown = false;
+    } else {
+        fail(line, "can't understand '" + listing + "'");
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s script.txt ARRAY_NAME > header.h\n", argv[0]);
+        return 1;
+    }
+    scriptPath = argv[1];
+    std::string arrayName = argv[2];
+
+    FILE* in = fopen(scriptPath, "r");
+    if (!in) {
+        perror(scriptPath);
+        return 1;
+    }
+    char buffer[256];
+    int line = 0;
+    while (fgets(buffer, sizeof(buffer), in)) {
+        compileLine(++line, buffer);
+    }
+    fclose(in);
+
+    for (const Fixup& fixup : fixups) {
+        if (!labels.count(fixup.label)) {
+            fail(fixup.sourceLine, "no label '" + fixup.label + "'");
+        }
+        std::vector<uint8_t> target = u16(labels[fixup.label]);
+        program[fixup.instruction].bytes[1] = target[0];
+        program[fixup.instruction].bytes[2] = target[1];
+    }
+
+    // Header file on stdout
+    std::string guard = arrayName + "_H";
+    printf("#ifndef %s\n#define %s\n\n#include <Arduino.h>\n\n", guard.c_str(), guard.c_str());
+    printf("// Generated by host/scenario_compiler.cpp from %s - edit the script, not this file\n", scriptPath);
+    printf("const uint8_t %s[] PROGMEM = {\n", arrayName.c_str());
+    char header[32];
+    snprintf(header, sizeof(header), "'%c', %u, %u, %u,", Scenario::MAGIC, Scenario::VERSION, codeSize & 0xFF, codeSize >> 8);
+    printf("    %-26s// Header: version %u, %u bytes of code\n", header, Scenario::VERSION, codeSize);
+    uint16_t offset = 0;
+    for (const Instruction& instruction : program) {
+        std::string bytes;
+        char hex[8];
+        for (uint8_t b : instruction.bytes) {
+            snprintf(hex, sizeof(hex), "0x%02X, ", b);
+            bytes += hex;
+        }
+        printf("    %-26s// %3u: %s (line %d)\n", bytes.c_str(), offset, instruction.text.c_str(), instruction.sourceLine);
+        offset += instruction.bytes.size();
+    }
+    printf("};\n\n#endif\n");
+
+    fprintf(stderr, "%s: %u bytes of code, %u instructions\n", scriptPath, codeSize, (unsigned)program.size());
+    return 0;
+}
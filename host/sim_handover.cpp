@@ -0,0 +1,201 @@
+// Host simulation: first ring of a call admitted from the wait queue
+//
+// Build and run from the project root:
+//   g++ -O2 -std=gnu++11 -Iinclude -Ihost/hal host/sim_handover.cpp host/hal/Arduino.cpp host/hal/EEPROM.cpp src/RingerManager.cpp src/TelephoneRinger.cpp src/ArrivalModel.cpp src/EventBus.cpp src/RelayEdgeEngine.cpp src/EmergencyStop.cpp src/RelayWear.cpp src/VirtualClock.cpp src/CallStats.cpp src/StringUtils.cpp -o sim_handover
+//   ./sim_handover --minutes 120
+//
+// Eight lines share one concurrent slot, so nearly every call starts when
+// another ends and hands its slot to the longest-waiting line on the same
+// step() pass. As in the firmware's scheduler, step() gets the time read
+// at the start of the frame, after --work microseconds of other tasks. The relay outputs are watched on
+// every clock tick, with the relays switched from step() and with Timer1
+// edges (emulated), and the run fails if any call's first ring is shorter
+// than the shortest planned ring (a final ring cut to 25%) or if two
+// relays are ever on at once.
+
+#include <Arduino.h>
+#include "RingerManager.h"
+#include "RelayEdgeEngine.h"
+#include "EventBus.h"
+
+int maxCallDelaySetting = 10;  // Read by TelephoneRinger - short waits keep the queue full
+
+static const int NUM_LINES = 8;
+static const int RELAY_PINS[NUM_LINES] = {5, 6, 7, 8, 9, 10, 11, 12};  // Same as main.cpp
+
+// Shortest planned ring (TelephoneRinger's 2 s ring cut to 25%), less a little for frame timing
+static const unsigned long MIN_RING_MICROS = 2000UL * 25 / 100 * 1000 - 20000;
+
+struct RelayWatch {
+    bool on;
+    uint64_t onAt;
+    bool firstRing;         // The ring under way (or just ended) opened a call
+    bool firstRingChecked;
+};
+
+struct RunResult {
+    unsigned long calls;
+    unsigned long firstRings;
+    unsigned long shortFirstRings;
+    uint64_t shortestFirstRing;
+    uint64_t overlapMicros;  // Time with more relays on than the concurrent limit
+};
+
+static RelayWatch watches[NUM_LINES];
+static RunResult* current = nullptr;
+static bool edgeMode = false;
+static uint32_t timerRemainderMicros = 0;
+static uint64_t lastWatch = 0;
+
+static void checkFirstRing(RelayWatch& watch, uint64_t length) {
+    if (!watch.firstRing || watch.firstRingChecked) {
+        return;
+    }
+    watch.firstRingChecked = true;
+    current->firstRings++;
+    if (length < current->shortestFirstRing) {
+        current->shortestFirstRing = length;
+    }
+    if (length < MIN_RING_MICROS) {
+        current->shortFirstRings++;
+    }
+}
+
+// Relay outputs after every clock movement
+static void watchRelays() {
+    if (!current) {
+        return;
+    }
+    uint64_t now = HostHal::getMicros();
+    int on = 0;
+    for (int i = 0; i < NUM_LINES; i++) {
+        RelayWatch& watch = watches[i];
+        bool level = HostHal::getOutputLevel(RELAY_PINS[i]) == LOW;   // Active LOW
+        if (level && !watch.on) {
+            watch.onAt = now;
+            watch.firstRing = false;
+            watch.firstRingChecked = false;
+        } else if (!level && watch.on) {
+            checkFirstRing(watch, now - watch.onAt);
+        }
+        watch.on = level;
+        on += level;
+    }
+    if (on > 1) {
+        current->overlapMicros += now - lastWatch;
+    }
+    lastWatch = now;
+}
+
+static void onClockAdvance(uint32_t us) {
+    if (edgeMode) {
+        uint32_t total = timerRemainderMicros + us;
+        RelayEdgeEngine::emulateAdvance(total / 4);
+        timerRemainderMicros = total % 4;
+    }
+    watchRelays();
+}
+
+// The call's first ring is the one its relay is on for now (or has just finished)
+static void onCallStarted(const EventBus::Event& event) {
+    if (!current) {
+        return;
+    }
+    watchRelays();  // The relay may have switched since the clock last moved
+    RelayWatch& watch = watches[event.line];
+    if (watch.firstRingChecked) {
+        return;
+    }
+    current->calls++;
+    watch.firstRing = true;
+    if (!watch.on) {
+        checkFirstRing(watch, 0);   // Over before the pass that started it ended
+    }
+}
+
+static void run(bool hardwareEdges, uint32_t seed, unsigned long minutes, uint32_t workMicros, RunResult& result) {
+    HostHal::skipMillisWrap(minutes * 60000UL + 1000);
+    for (int i = 0; i < NUM_LINES; i++) {
+        pinMode(RELAY_PINS[i], OUTPUT);
+        digitalWrite(RELAY_PINS[i], HIGH);
+        watches[i] = RelayWatch();
+    }
+    edgeMode = hardwareEdges;
+    if (hardwareEdges) {
+        RelayEdgeEngine::begin();
+        RelayEdgeEngine::emulateZeroCross(0);
+    }
+
+    RingerManager ringers;
+    ringers.seedRandom(seed);
+    ringers.initialize(RELAY_PINS, NUM_LINES, nullptr, false);
+    ringers.setHardwareEdges(hardwareEdges);
+    ringers.setActiveRelayCount(NUM_LINES);
+    ringers.setMaxConcurrent(1);
+
+    result = RunResult();
+    result.shortestFirstRing = UINT64_MAX;
+    current = &result;
+    lastWatch = HostHal::getMicros();
+
+    uint64_t end = HostHal::getMicros() + (uint64_t)minutes * 60000000ULL;
+    while (HostHal::getMicros() < end) {
+        // The scheduler reads the clock once per frame; tasks ahead of the
+        // ringers use up some of it before step() gets that frame time
+        unsigned long frameTime = millis();
+        HostHal::advanceMicros(workMicros);
+        ringers.step(frameTime);
+        EventBus::dispatch();
+        uint64_t now = HostHal::getMicros();
+        HostHal::advanceMicros((uint32_t)((now / 1000 + 1) * 1000 - now));
+    }
+    ringers.stopAllCalls();
+    EventBus::dispatch();
+    current = nullptr;
+    if (hardwareEdges) {
+        RelayEdgeEngine::cancelAll();
+        edgeMode = false;
+    }
+}
+
+static bool report(const char* name, const RunResult& result) {
+    bool pass = result.shortFirstRings == 0 && result.overlapMicros == 0;
+    printf("%-13s %6lu calls, %6lu first rings checked, %4lu shorter than %lu ms (shortest %lu ms), "
+           "two relays on for %lu ms  %s\n",
+           name, result.calls, result.firstRings, result.shortFirstRings, MIN_RING_MICROS / 1000,
+           result.firstRings ? (unsigned long)(result.shortestFirstRing / 1000) : 0UL,
+           (unsigned long)(result.overlapMicros / 1000), pass ? "ok" : "FAIL");
+    return pass;
+}
+
+int main(int argc, char** argv) {
+    unsigned long minutes = 120;
+    uint32_t workMicros = 1500;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--minutes") == 0 && i + 1 < argc) {
+            minutes = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--work") == 0 && i + 1 < argc) {
+            workMicros = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], nullptr, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--minutes N] [--work US] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    HostHal::setClockListener(onClockAdvance);
+    EventBus::subscribe(EventBus::maskOf(EventBus::CALL_STARTED), onCallStarted);
+
+    printf("%d lines, 1 concurrent, %lu us of other work per frame, %lu minutes\n",
+           NUM_LINES, (unsigned long)workMicros, minutes);
+    RunResult loopResult;
+    RunResult edgeResult;
+    run(false, seed, minutes, workMicros, loopResult);
+    run(true, seed, minutes, workMicros, edgeResult);
+    bool pass = report("Loop relays", loopResult);
+    pass = report("Timer1 edges", edgeResult) && pass;
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
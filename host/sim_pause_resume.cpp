@@ -0,0 +1,323 @@
+// Host simulation: pause and resume on the ringers' virtual clock
+//
+// Build and run from the project root:
+//   g++ -O2 -std=gnu++11 -Iinclude -Ihost/hal host/sim_pause_resume.cpp host/hal/Arduino.cpp host/hal/EEPROM.cpp src/RingerManager.cpp src/TelephoneRinger.cpp src/ArrivalModel.cpp src/EventBus.cpp src/RelayEdgeEngine.cpp src/EmergencyStop.cpp src/RelayWear.cpp src/VirtualClock.cpp src/CallStats.cpp src/StringUtils.cpp -o sim_pause_resume
+//   ./sim_pause_resume --trials 500
+//
+// Each trial runs the real RingerManager for an hour three times on the
+// same seed: without a pause, with a pause (RingerManager::pause/resume)
+// somewhere in the middle, and with the firmware's old pause, which only
+// stopped stepping the ringers while wall-clock time ran on.
+//
+// With the virtual clock the paused run must be the unpaused run with a
+// gap cut into it: the same concurrent call, ringing and relay profile
+// change for change and the same call start times once the pause length
+// is taken off, relays all off during the pause, and stepping while paused
+// must not change anything. The old-style run shows what the clock fixes -
+// every line whose wait ran out during the pause starting at once.
+
+#include <vector>
+#include <Arduino.h>
+#include "RingerManager.h"
+#include "EventBus.h"
+
+int maxCallDelaySetting = 30;  // Read by TelephoneRinger
+
+static const int NUM_LINES = 8;
+static const int RELAY_PINS[NUM_LINES] = {2, 3, 4, 5, 6, 7, 8, 9};  // Same as main.cpp
+
+static const unsigned long RUN_MS = 3600000UL;        // Line time per run, pause not counted
+static const unsigned long HERD_WINDOW_MS = 5000;     // "Right after resume"
+static const int PAUSED_STEPS = 4;                    // step() calls made while paused
+
+enum PauseStyle {
+    NO_PAUSE,
+    VIRTUAL_CLOCK,      // RingerManager::pause()/resume()
+    WALL_CLOCK          // Old firmware: ringers simply not stepped
+};
+
+struct SimConfig {
+    int lines;
+    int maxConcurrent;
+    bool arrivalMode;
+    uint16_t callsPerHour;
+};
+
+// Whenever concurrent calls, bells ringing or relay outputs change
+struct Sample {
+    unsigned long time;
+    uint8_t concurrent;
+    uint8_t ringing;
+    uint8_t relays;     // Bit per energized relay (output LOW)
+
+    bool operator==(const Sample& other) const {
+        return time == other.time && concurrent == other.concurrent &&
+               ringing == other.ringing && relays == other.relays;
+    }
+};
+
+struct RunResult {
+    std::vector<Sample> trace;
+    std::vector<unsigned long> starts;  // Line time of every CALL_STARTED
+    int relaysOnWhilePaused;
+    int changesWhilePaused;
+};
+
+// CALL_STARTED goes here for the run in progress
+static RunResult* current = nullptr;
+static unsigned long lineTime = 0;
+
+static void onCallStarted(const EventBus::Event& event) {
+    (void)event;
+    if (current) {
+        current->starts.push_back(lineTime);
+    }
+}
+
+static uint8_t relayMask(int lines) {
+    uint8_t mask = 0;
+    for (int i = 0; i < lines; i++) {
+        if (HostHal::getOutputLevel(RELAY_PINS[i]) == LOW) {
+            mask |= 1 << i;
+        }
+    }
+    return mask;
+}
+
+static Sample sampleOf(const RingerManager& ringers, int lines, unsigned long time) {
+    Sample s = { time, (uint8_t)ringers.getActiveCallCount(), (uint8_t)ringers.getRingingPhoneCount(), relayMask(lines) };
+    return s;
+}
+
+static void record(RunResult& result, const Sample& s) {
+    if (result.trace.empty()) {
+        result.trace.push_back(s);
+        return;
+    }
+    const Sample& last = result.trace.back();
+    if (s.concurrent != last.concurrent || s.ringing != last.ringing || s.relays != last.relays) {
+        result.trace.push_back(s);
+    }
+}
+
+// Every millis() read costs the HAL a microsecond - go to exact millisecond
+// boundaries so the three runs see identical times
+static void moveTo(uint64_t baseMicros, unsigned long ms) {
+    uint64_t target = baseMicros + (uint64_t)ms * 1000;
+    uint64_t now = HostHal::getMicros();
+    if (target > now) {
+        HostHal::advanceMicros((uint32_t)(target - now));
+    }
+}
+
+// Times in the results are line time: wall time from the start with the pause taken off
+static void runTrial(const SimConfig& config, uint32_t seed, PauseStyle style,
+                     unsigned long pauseAt, unsigned long pauseLength, RunResult& result) {
+    HostHal::skipMillisWrap(RUN_MS + pauseLength);
+    uint32_t intoMillisecond = HostHal::getMicros() % 1000;
+    if (intoMillisecond) {
+        HostHal::advanceMicros(1000 - intoMillisecond);
+    }
+    const uint64_t baseMicros = HostHal::getMicros();
+
+    for (int i = 0; i < NUM_LINES; i++) {
+        pinMode(RELAY_PINS[i], OUTPUT);
+        digitalWrite(RELAY_PINS[i], HIGH);
+    }
+    RingerManager ringers;
+    ringers.seedRandom(seed);
+    ringers.initialize(RELAY_PINS, NUM_LINES, nullptr, false);
+    ringers.setActiveRelayCount(config.lines);
+    ringers.setMaxConcurrent(config.maxConcurrent);
+    ringers.setCallsPerHour(config.callsPerHour);
+    ringers.setArrivalMode(config.arrivalMode);
+
+    result = RunResult();
+    current = &result;
+    bool pausePending = style != NO_PAUSE;
+    unsigned long offset = 0;           // Wall time minus line time
+    unsigned long wall = 0;
+
+    for (;;) {
+        lineTime = wall - offset;
+        if (lineTime >= RUN_MS) {
+            break;
+        }
+        moveTo(baseMicros, wall);
+
+        if (pausePending && lineTime == pauseAt) {
+            pausePending = false;
+            if (style == VIRTUAL_CLOCK) {
+                ringers.pause(millis());
+                Sample before = sampleOf(ringers, config.lines, lineTime);
+                if (before.relays) {
+                    result.relaysOnWhilePaused++;
+                }
+                // main.cpp doesn't step while paused, but nothing may move if something did
+                for (int i = 1; i <= PAUSED_STEPS; i++) {
+                    moveTo(baseMicros, wall + pauseLength * i / (PAUSED_STEPS + 1));
+                    ringers.step(millis());
+                    EventBus::dispatch();
+                    Sample during = sampleOf(ringers, config.lines, lineTime);
+                    if (during.relays) {
+                        result.relaysOnWhilePaused++;
+                    }
+                    if (during.concurrent != before.concurrent || during.ringing != before.ringing) {
+                        result.changesWhilePaused++;
+                    }
+                }
+            }
+            wall += pauseLength;
+            offset = style == VIRTUAL_CLOCK ? pauseLength : 0;
+            moveTo(baseMicros, wall);
+            if (style == VIRTUAL_CLOCK) {
+                ringers.resume(millis());
+                record(result, sampleOf(ringers, config.lines, lineTime));
+            }
+            continue;
+        }
+
+        unsigned long now = millis();
+        ringers.step(now);
+        EventBus::dispatch();
+        record(result, sampleOf(ringers, config.lines, lineTime));
+
+        unsigned long next = ringers.getTimeToNextEvent(now);
+        unsigned long limit = (pausePending && lineTime < pauseAt) ? pauseAt - lineTime : RUN_MS - lineTime;
+        wall += min(next, limit);
+    }
+    current = nullptr;
+}
+
+static int startsBetween(const std::vector<unsigned long>& starts, unsigned long from, unsigned long to) {
+    int count = 0;
+    for (size_t i = 0; i < starts.size(); i++) {
+        if (starts[i] >= from && starts[i] < to) count++;
+    }
+    return count;
+}
+
+static int peakRingingBetween(const std::vector<Sample>& trace, unsigned long from, unsigned long to) {
+    int peak = 0;
+    for (size_t i = 0; i < trace.size(); i++) {
+        // A sample holds until the next one
+        unsigned long end = i + 1 < trace.size() ? trace[i + 1].time : RUN_MS;
+        if (end > from && trace[i].time < to && trace[i].ringing > peak) {
+            peak = trace[i].ringing;
+        }
+    }
+    return peak;
+}
+
+// Returns the number of failed trials
+static int runMode(const SimConfig& config, int trials, uint32_t seed) {
+    FastRandom rng;
+    rng.seed(seed, 0);
+    int failures = 0;
+    long relaysOn = 0, pausedChanges = 0;
+    long herd[3] = {0, 0, 0};
+    long herdWorst[3] = {0, 0, 0};
+    long ringPeak[3] = {0, 0, 0};
+
+    for (int trial = 0; trial < trials; trial++) {
+        uint32_t trialSeed = seed + (uint32_t)trial * 0x9E3779B9UL;
+        unsigned long pauseAt = rng.range(600000UL, 3000000UL);     // 10 to 50 minutes in
+        unsigned long pauseLength = rng.range(60000UL, 1800000UL);  // 1 to 30 minutes
+
+        RunResult runs[3];
+        runTrial(config, trialSeed, NO_PAUSE, pauseAt, pauseLength, runs[NO_PAUSE]);
+        runTrial(config, trialSeed, VIRTUAL_CLOCK, pauseAt, pauseLength, runs[VIRTUAL_CLOCK]);
+        runTrial(config, trialSeed, WALL_CLOCK, pauseAt, pauseLength, runs[WALL_CLOCK]);
+
+        const RunResult& plain = runs[NO_PAUSE];
+        const RunResult& paused = runs[VIRTUAL_CLOCK];
+        bool match = plain.trace == paused.trace && plain.starts == paused.starts &&
+                     paused.relaysOnWhilePaused == 0 && paused.changesWhilePaused == 0;
+        if (!match) {
+            if (failures < 5) {
+                printf("  trial %d (seed 0x%08lx, pause %lu ms at %lu ms): profile differs "
+                       "(%zu/%zu changes, %zu/%zu calls, %d relay-on, %d moved while paused)\n",
+                       trial, (unsigned long)trialSeed, pauseLength, pauseAt,
+                       plain.trace.size(), paused.trace.size(), plain.starts.size(), paused.starts.size(),
+                       paused.relaysOnWhilePaused, paused.changesWhilePaused);
+            }
+            failures++;
+        }
+        relaysOn += paused.relaysOnWhilePaused;
+        pausedChanges += paused.changesWhilePaused;
+
+        // Old-style pause resumes at pauseAt + pauseLength of its own timeline
+        for (int style = 0; style < 3; style++) {
+            unsigned long resumeAt = style == WALL_CLOCK ? pauseAt + pauseLength : pauseAt;
+            int started = startsBetween(runs[style].starts, resumeAt, resumeAt + HERD_WINDOW_MS);
+            herd[style] += started;
+            if (started > herdWorst[style]) herdWorst[style] = started;
+            ringPeak[style] += peakRingingBetween(runs[style].trace, resumeAt, resumeAt + HERD_WINDOW_MS);
+        }
+    }
+
+    printf("  virtual clock vs no pause: %d of %d trials identical", trials - failures, trials);
+    printf(" (relays on while paused: %ld, state changes while paused: %ld)\n", relaysOn, pausedChanges);
+    printf("  first %lu s after resume     %14s %14s %14s\n", HERD_WINDOW_MS / 1000, "no pause", "virtual clock", "old pause");
+    printf("    calls started (mean)       %14.2f %14.2f %14.2f\n",
+           (double)herd[NO_PAUSE] / trials, (double)herd[VIRTUAL_CLOCK] / trials, (double)herd[WALL_CLOCK] / trials);
+    printf("    calls started (worst)      %14ld %14ld %14ld\n",
+           herdWorst[NO_PAUSE], herdWorst[VIRTUAL_CLOCK], herdWorst[WALL_CLOCK]);
+    printf("    peak bells ringing (mean)  %14.2f %14.2f %14.2f\n",
+           (double)ringPeak[NO_PAUSE] / trials, (double)ringPeak[VIRTUAL_CLOCK] / trials, (double)ringPeak[WALL_CLOCK] / trials);
+    return failures;
+}
+
+static void usage() {
+    printf("usage: sim_pause_resume [--lines N] [--concurrent N] [--delay S] [--trials N] [--seed N]\n");
+}
+
+int main(int argc, char** argv) {
+    SimConfig config;
+    config.lines = NUM_LINES;
+    config.maxConcurrent = 4;
+    int callDelay = 30;
+    int trials = 200;
+    uint32_t seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--lines") && hasValue) {
+            config.lines = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--concurrent") && hasValue) {
+            config.maxConcurrent = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--delay") && hasValue) {
+            callDelay = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--trials") && hasValue) {
+            trials = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && hasValue) {
+            seed = strtoul(argv[++i], nullptr, 0);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    // Same ranges as the settings menu
+    config.lines = constrain(config.lines, 1, NUM_LINES);
+    config.maxConcurrent = constrain(config.maxConcurrent, 1, NUM_LINES);
+    maxCallDelaySetting = constrain(callDelay, 10, 1000);
+    config.callsPerHour = (unsigned long)config.lines * 3600UL / (5UL + maxCallDelaySetting);
+    if (trials < 1) trials = 1;
+
+    EventBus::subscribe(EventBus::maskOf(EventBus::CALL_STARTED), onCallStarted);
+
+    printf("Pause/resume: %d lines, %d concurrent, Call Timing %d s, %d one-hour trials per mode\n",
+           config.lines, config.maxConcurrent, maxCallDelaySetting, trials);
+
+    int failures = 0;
+    config.arrivalMode = false;
+    printf("\nPer-line call timing\n");
+    failures += runMode(config, trials, seed);
+    config.arrivalMode = true;
+    printf("\nPoisson arrivals at %u calls/hour\n", config.callsPerHour);
+    failures += runMode(config, trials, seed);
+
+    printf("\n%s\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,271 @@
+// Host simulation: RelayEdgeEngine's timed edge queue
+//
+// Build and run from the project root:
+//   g++ -O2 -std=c++11 -Iinclude host/sim_relay_edges.cpp src/RelayEdgeEngine.cpp -o sim_relay_edges && ./sim_relay_edges
+//
+// Drives the engine with random schedule / cancel / advance operations on an
+// emulated Timer1 (starting just before the 32-bit tick counter wraps) and
+// checks every pin write against a reference model: right pin, right level,
+// right order, and no later than the compare-match arming window allows.
+// Edges are scheduled up to 2 seconds ahead so the 16-bit compare register
+// has to be re-armed several times before they fire.
+//
+// A second part turns on zero-cross sync with an emulated 60Hz signal, then
+// 50Hz, then no signal, and checks that every relay contact meets its
+// crossing (switch tick + operate/release time), that no edge fires before
+// it was due or later than one half cycle plus the lead, and that edges go
+// back to firing on time when the signal stops. With the signal locked it
+// also schedules an OFF and an ON edge for one pin a fraction of a
+// millisecond apart, at every phase of the half cycle, and checks they still
+// switch in that order (and the other way round) - the release lead is
+// shorter than the operate lead, so the ON edge's crossing time alone would
+// put it first.
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "FastRandom.h"
+#include "RelayEdgeEngine.h"
+
+static const int OPERATIONS = 2000000;
+static const uint8_t PIN_COUNT = 8;
+static const uint32_t MAX_AHEAD_TICKS = 2000UL * RelayEdgeEngine::TICKS_PER_MS;
+static const uint32_t ALLOWED_LATENESS_TICKS = 4;  // Compare is never armed closer than this
+
+struct Write {
+    uint32_t tick;
+    uint8_t pin;
+    uint8_t level;
+};
+
+struct Expected {
+    uint32_t time;
+    uint32_t due;        // When it can first fire - scheduling time for edges already in the past
+    uint32_t sequence;   // Equal times fire in scheduling order
+    uint8_t pin;
+    uint8_t level;
+};
+
+static std::vector<Write> writes;
+
+// The engine's host build switches pins through this
+void digitalWrite(uint8_t pin, uint8_t val) {
+    Write w = { RelayEdgeEngine::now(), pin, val };
+    writes.push_back(w);
+}
+
+static bool firesBefore(const Expected& a, const Expected& b) {
+    int32_t diff = (int32_t)(a.time - b.time);
+    return diff != 0 ? diff < 0 : a.sequence < b.sequence;
+}
+
+// Zero-cross part - relay times as the firmware configures them
+static const uint16_t OPERATE_MICROS = 7000;
+static const uint16_t RELEASE_MICROS = 3000;
+static const int ZERO_CROSS_OPERATIONS = 200000;
+
+// One signal condition: random edges (at most one pending per pin, like a
+// ringer's cadence) checked against the crossing grid. halfCycle 0 = no signal.
+static long runZeroCross(const char* name, uint32_t halfCycle, FastRandom& rng) {
+    // Let pending edges drain and the engine lock on (or notice the signal is gone)
+    RelayEdgeEngine::emulateZeroCross(halfCycle);
+    uint32_t firstCrossing = RelayEdgeEngine::now() + halfCycle;
+    RelayEdgeEngine::emulateAdvance(MAX_AHEAD_TICKS + 20UL * RelayEdgeEngine::MAX_HALF_CYCLE_TICKS);
+    writes.clear();
+    RelayEdgeEngine::resetStats();
+
+    const uint32_t operateTicks = OPERATE_MICROS / 4;
+    const uint32_t releaseTicks = RELEASE_MICROS / 4;
+    const uint32_t maxDelay = halfCycle + std::max(operateTicks, releaseTicks) + ALLOWED_LATENESS_TICKS;
+
+    Expected pending[PIN_COUNT];
+    bool hasPending[PIN_COUNT] = {};
+    long fired = 0, errors = 0;
+    uint32_t worstDelay = 0;
+
+    for (int op = 0; op < ZERO_CROSS_OPERATIONS && errors < 10; op++) {
+        uint32_t now = RelayEdgeEngine::now();
+        uint8_t pin = rng.below(PIN_COUNT);
+        if (rng.below(100) < 30 && !hasPending[pin]) {
+            // Half of them land within 2ms of another pending edge, as when several lines ring together
+            uint8_t other = rng.below(PIN_COUNT);
+            Expected& e = pending[pin];
+            e.time = now + rng.below(MAX_AHEAD_TICKS / 4);
+            if (hasPending[other] && rng.chance(50)) {
+                e.time = pending[other].time + rng.below(500);
+            }
+            e.due = ((int32_t)(e.time - now) < 0) ? now : e.time;
+            e.pin = pin;
+            e.level = rng.below(2);
+            RelayEdgeEngine::scheduleEdge(e.pin, e.level, e.time);
+            hasPending[pin] = true;
+        } else {
+            RelayEdgeEngine::emulateAdvance(rng.below(halfCycle ? halfCycle * 2 : 2000));
+        }
+
+        for (const Write& w : writes) {
+            if (w.pin >= PIN_COUNT || !hasPending[w.pin] || w.level != pending[w.pin].level) {
+                printf("%s op %d: unexpected write pin %u level %u\n", name, op, w.pin, w.level);
+                errors++;
+                continue;
+            }
+            uint32_t delay = w.tick - pending[w.pin].due;
+            worstDelay = std::max(worstDelay, delay);
+            uint32_t limit = halfCycle ? maxDelay : ALLOWED_LATENESS_TICKS;
+            if ((int32_t)delay < 0 || delay > limit) {
+                printf("%s op %d: pin %u switched %ld ticks after due\n", name, op, w.pin, (long)(int32_t)delay);
+                errors++;
+            }
+            if (halfCycle) {
+                uint32_t contact = w.tick + (w.level == 0 ? operateTicks : releaseTicks);
+                uint32_t phase = (contact - firstCrossing) % halfCycle;
+                if (phase > ALLOWED_LATENESS_TICKS && halfCycle - phase > ALLOWED_LATENESS_TICKS) {
+                    printf("%s op %d: pin %u contact %lu ticks off the crossing\n", name, op, w.pin, (unsigned long)phase);
+                    errors++;
+                }
+            }
+            hasPending[w.pin] = false;
+            fired++;
+        }
+        writes.clear();
+    }
+
+    uint16_t batches = RelayEdgeEngine::getSyncedBatches();
+    printf("Zero-cross %-9s %ld edges in %u batches (%.2f per crossing), worst delay %lu us, measured half cycle %lu us\n",
+           name, fired, batches, batches ? (double)fired / batches : 0.0, (unsigned long)worstDelay * 4,
+           (unsigned long)RelayEdgeEngine::getHalfCycleMicros());
+    if (halfCycle && RelayEdgeEngine::getHalfCycleMicros() / 4 != halfCycle) {
+        printf("%s: half cycle not locked\n", name);
+        errors++;
+    }
+    return errors;
+}
+
+// Two edges for one pin, 50 ticks apart, from every phase of the half cycle.
+// The signal must already be locked.
+static long runPinOrder(const char* name, uint32_t halfCycle) {
+    static const uint8_t PIN = 5;
+    long errors = 0;
+    RelayEdgeEngine::cancelAll();   // Left over from the random run
+    for (uint8_t first = 0; first < 2; first++) {
+        uint8_t second = 1 - first;
+        for (uint32_t phase = 0; phase < halfCycle && errors < 10; phase += 7) {
+            RelayEdgeEngine::emulateAdvance(7);
+            writes.clear();
+            uint32_t now = RelayEdgeEngine::now();
+            RelayEdgeEngine::scheduleEdge(PIN, first, now + 10);
+            RelayEdgeEngine::scheduleEdge(PIN, second, now + 60);
+            RelayEdgeEngine::emulateAdvance(3 * halfCycle);
+            if (writes.size() != 2 || writes[0].level != first || writes[1].level != second) {
+                printf("%s %s then %s at phase %lu: ", name, first ? "OFF" : "ON", second ? "OFF" : "ON",
+                       (unsigned long)phase);
+                for (const Write& w : writes) {
+                    printf("level %u at %lu ", w.level, (unsigned long)(w.tick - now));
+                }
+                printf("\n");
+                errors++;
+            }
+        }
+    }
+    writes.clear();
+    printf("Pin order %-10s %s\n", name, errors == 0 ? "kept at every phase" : "BROKEN");
+    return errors;
+}
+
+int main() {
+    RelayEdgeEngine::begin();
+    RelayEdgeEngine::emulateAdvance(0xFFFFFFFFUL - 40UL * MAX_AHEAD_TICKS);  // Cross the wrap early on
+
+    FastRandom rng;
+    rng.seed(2024, 0);
+
+    std::vector<Expected> pending;
+    uint32_t sequence = 0;
+    long scheduled = 0, cancelled = 0, fired = 0, errors = 0;
+    uint32_t worstLateness = 0;
+
+    for (int op = 0; op < OPERATIONS && errors < 10; op++) {
+        uint32_t action = rng.below(100);
+        uint32_t now = RelayEdgeEngine::now();
+
+        if (action < 45) {
+            // Schedule - mostly ahead, sometimes already due
+            Expected e;
+            e.time = rng.chance(5) ? now - rng.below(1000) : now + rng.below(MAX_AHEAD_TICKS);
+            e.due = ((int32_t)(e.time - now) < 0) ? now : e.time;
+            e.sequence = sequence++;
+            e.pin = rng.below(PIN_COUNT);
+            e.level = rng.below(2);
+            bool accepted = RelayEdgeEngine::scheduleEdge(e.pin, e.level, e.time);
+            if (accepted != (pending.size() < RelayEdgeEngine::MAX_EDGES)) {
+                printf("schedule %s with %u pending\n", accepted ? "accepted" : "rejected", (unsigned)pending.size());
+                errors++;
+            }
+            if (accepted) {
+                pending.push_back(e);
+                scheduled++;
+            }
+        } else if (action < 50) {
+            uint8_t pin = rng.below(PIN_COUNT);
+            RelayEdgeEngine::cancelEdges(pin);
+            size_t before = pending.size();
+            pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                         [pin](const Expected& e) { return e.pin == pin; }),
+                          pending.end());
+            cancelled += before - pending.size();
+        } else if (action < 51) {
+            RelayEdgeEngine::cancelAll();
+            cancelled += pending.size();
+            pending.clear();
+        } else {
+            RelayEdgeEngine::emulateAdvance(rng.below(MAX_AHEAD_TICKS / 8));
+        }
+
+        // Everything written since the last operation must be the soonest pending edges, in order
+        std::sort(pending.begin(), pending.end(), firesBefore);
+        for (size_t i = 0; i < writes.size(); i++) {
+            const Write& w = writes[i];
+            if (pending.empty()) {
+                printf("unexpected write pin %u level %u at %lu\n", w.pin, w.level, (unsigned long)w.tick);
+                errors++;
+                break;
+            }
+            const Expected& e = pending.front();
+            uint32_t lateness = w.tick - e.due;
+            if (w.pin != e.pin || w.level != e.level || (int32_t)lateness < 0 || lateness > ALLOWED_LATENESS_TICKS) {
+                printf("op %d: wrote pin %u level %u at %lu, expected pin %u level %u at %lu\n",
+                       op, w.pin, w.level, (unsigned long)w.tick, e.pin, e.level, (unsigned long)e.time);
+                errors++;
+            }
+            worstLateness = std::max(worstLateness, lateness);
+            pending.erase(pending.begin());
+            fired++;
+        }
+        writes.clear();
+
+        // Nothing overdue may be left behind once the arming window has passed
+        if (!pending.empty() && (int32_t)(RelayEdgeEngine::now() - pending.front().due) > (int32_t)ALLOWED_LATENESS_TICKS) {
+            printf("op %d: edge for pin %u overdue\n", op, pending.front().pin);
+            errors++;
+        }
+        if (RelayEdgeEngine::getPendingCount() != pending.size()) {
+            printf("op %d: engine holds %u edges, expected %u\n", op,
+                   RelayEdgeEngine::getPendingCount(), (unsigned)pending.size());
+            errors++;
+        }
+    }
+
+    printf("Edges scheduled: %ld, fired: %ld, cancelled: %ld\n", scheduled, fired, cancelled);
+    printf("Worst lateness: %lu ticks (%lu us)\n", (unsigned long)worstLateness, (unsigned long)worstLateness * 4);
+
+    RelayEdgeEngine::cancelAll();
+    writes.clear();
+    RelayEdgeEngine::enableZeroCross(0, OPERATE_MICROS, RELEASE_MICROS);
+    errors += runZeroCross("60Hz:", 2083, rng);     // 8333us half cycle
+    errors += runPinOrder("60Hz:", 2083);
+    errors += runZeroCross("50Hz:", 2500, rng);
+    errors += runZeroCross("20Hz:", 6250, rng);     // Ring generator
+    errors += runZeroCross("no signal:", 0, rng);
+    printf("%s\n", errors == 0 ? "PASS" : "FAIL");
+    return errors == 0 ? 0 : 1;
+}
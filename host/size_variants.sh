@@ -0,0 +1,23 @@
+#!/bin/sh
+# Size benchmark: flash and RAM used by each firmware variant
+#
+# Run from the project root (needs PlatformIO's pio on the PATH):
+#   sh host/size_variants.sh
+#
+# Builds every [env:...] in platformio.ini and tabulates the usage lines
+# PlatformIO prints after linking, so the leanest variant that still has
+# the features an installation needs can be picked.
+
+ENVS=$(sed -n 's/^\[env:\(.*\)\]$/\1/p' platformio.ini)
+
+printf '%-16s %10s %10s\n' "variant" "flash" "ram"
+for env in $ENVS; do
+    if ! out=$(pio run -e "$env" 2>&1); then
+        echo "$env: build failed"
+        echo "$out" | tail -20
+        exit 1
+    fi
+    flash=$(echo "$out" | sed -n 's/^Flash:.*(used \([0-9]*\) bytes.*/\1/p')
+    ram=$(echo "$out" | sed -n 's/^RAM:.*(used \([0-9]*\) bytes.*/\1/p')
+    printf '%-16s %10s %10s\n' "$env" "$flash" "$ram"
+done
@@ -0,0 +1,51 @@
+#ifndef ARRIVAL_MODEL_H
+#define ARRIVAL_MODEL_H
+
+#include <stdint.h>
+#include "FastRandom.h"
+
+// Poisson call arrival process for the whole call center.
+//
+// Inter-arrival gaps are exponentially distributed around the mean implied
+// by the target rate. Samples come from a fixed-point inverse-CDF table in
+// flash - no floating point on the AVR. Plain stdint so it also builds on the host.
+class ArrivalModel {
+public:
+    ArrivalModel();
+    
+    // Seed the arrival stream (stream keeps it independent of the per-line streams)
+    void seed(uint32_t seedValue, uint8_t stream);
+    
+    // Target arrival rate for the whole system (0 = no arrivals)
+    void setCallsPerHour(uint16_t callsPerHour);
+    uint16_t getCallsPerHour() const;
+    
+    // Start a fresh gap from currentTime
+    void reset(unsigned long currentTime);
+    
+    // True once each time an arrival is due; the next gap is drawn immediately
+    bool poll(unsigned long currentTime);
+    
+    // Milliseconds until the next arrival is due (0xFFFFFFFF if the rate is 0)
+    unsigned long getTimeToNextArrival(unsigned long currentTime) const;
+    
+    // One exponential inter-arrival gap in milliseconds
+    unsigned long sampleInterArrival();
+    
+    // Random line index in [0, lineCount) for the arrival to try first
+    uint8_t pickLine(uint8_t lineCount);
+    
+    unsigned long getArrivalCount() const;
+
+private:
+    FastRandom rng;
+    uint16_t callsPerHour;
+    unsigned long meanInterval;     // ms between arrivals on average
+    unsigned long lastArrival;
+    unsigned long nextInterval;     // Gap until the next arrival
+    unsigned long arrivalCount;
+    
+    static const unsigned long MS_PER_HOUR = 3600000UL;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef BOOT_MANAGER_H
+#define BOOT_MANAGER_H
+
+#include <Arduino.h>
+
+class BootManager {
+public:
+    // Why the MCU last came out of reset
+    enum ResetCause {
+        RESET_UNKNOWN,      // Bootloader cleared the flags without passing them on
+        RESET_POWER_ON,     // Cold start
+        RESET_EXTERNAL,     // Reset button or serial upload
+        RESET_BROWNOUT,     // Supply dipped below the brown-out threshold
+        RESET_WATCHDOG      // Watchdog timeout
+    };
+    
+    // Read (and clear) the hardware reset flags - call first thing in setup()
+    static void captureResetCause();
+    
+    static ResetCause getResetCause();
+    
+    // Warm boot = any reset that wasn't a power-on, the relays were already tested
+    static bool isWarmBoot();
+    
+    // Click every relay once, overlapped so the whole test takes a fraction of a second
+    static void runRelaySelfTest(const int* relayPins, int numPins);
+    
+    // Record the moment the system became operational
+    static void markReady();
+    
+    // Milliseconds from power-on to markReady()
+    static unsigned long getBootTime();
+    
+    static const char* getResetCauseString();
+
+private:
+    static uint8_t resetFlags;
+    static unsigned long readyTime;
+    
+    // Relay self-test timing
+    static const unsigned long RELAY_TEST_ON_TIME = 120;   // Each relay energized for 120ms
+    static const unsigned long RELAY_TEST_STAGGER = 40;    // Next relay starts 40ms later
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef CALL_STATS_H
+#define CALL_STATS_H
+
+#include <Arduino.h>
+
+// Running call statistics, small and cheap enough to stay on in every build.
+//
+// RingerManager reports each call start, ring edge and call end as it
+// happens, in line time (pauses don't count). Every report is a few
+// additions and shifts - no samples are kept, only 82 bytes (on the AVR)
+// of totals, moving averages and one small histogram:
+//   - calls per hour from a moving average of the gap between call starts
+//   - rings per call and the answer rate (last ring cut short) as moving
+//     averages over finished calls, plus lifetime totals
+//   - bell-on time per line in 1.024 s ticks, 32-bit so they never fill
+//     (16 bits would after 18.6 h of bell time, a busy day on one line)
+//   - time spent at each concurrency level, in 1.024 s ticks; all bins are
+//     halved together when one fills, so the shares stay right forever
+// Moving averages weigh each new call 1/16.
+//
+// Only one timestamp is kept: each report first credits the time since
+// the previous one, in 32 ms units, to the open call gap, the current
+// concurrency level and every ringing line. The ringing lines share one
+// remainder, so bell time isn't lost to rounding, but a partial tick can
+// end up with whichever line is ringing when it completes.
+// Call and ring totals stop at 65535. When the finished-call count fills,
+// it and the answered count are halved together, so the lifetime answer
+// rate stays right.
+class CallStats {
+public:
+    static const uint8_t MAX_LINES = 8;
+
+    CallStats();
+
+    // Start over from line time now
+    void reset(unsigned long now);
+
+    // Fed by RingerManager
+    void callStarted(uint8_t line, unsigned long now);
+    void ringOn(uint8_t line, unsigned long now);
+    void ringOff(uint8_t line, unsigned long now);
+    void callEnded(uint8_t line, uint8_t rings, bool answered, unsigned long now);
+
+    // Results as of line time now
+    uint16_t getCallCount() const;
+    uint16_t getRingCount() const;
+    uint16_t getCallsPerHour(unsigned long now) const;
+    uint16_t getRingsPerCallX10() const;            // Moving average, in tenths
+    uint8_t getAnswerPercent() const;               // Moving average
+    unsigned long getRingSeconds(uint8_t line, unsigned long now) const;
+    uint8_t getConcurrencyPercent(uint8_t callLevel, unsigned long now) const;
+    uint16_t getMeanConcurrencyX10(unsigned long now) const;
+
+    // Serial dump, and four 20-character lines for the LCD stats page
+    void printReport(unsigned long now) const;
+    void formatPage(char lines[4][21], unsigned long now) const;
+
+private:
+    static const uint8_t UNIT_SHIFT = 5;            // 32 ms units between reports
+    static const uint8_t TICK_SHIFT = 5;            // 32 units = 1.024 s per tick
+    static const uint8_t TICK_UNITS = 1 << TICK_SHIFT;
+
+    unsigned long startTime;
+    unsigned long lastReport;                       // Everything below is accounted up to here
+    uint8_t unitRemainder;                          // ms not yet counted
+    uint16_t calls;
+    uint16_t rings;
+    uint16_t endedCalls;
+    uint16_t answeredCalls;
+
+    // Moving averages
+    uint16_t callGap;               // Units since the last call start (saturates at 35 min)
+    unsigned long callGapAverage;   // ms
+    uint16_t ringsPerCallAverage;   // 8.8 fixed point
+    uint16_t answerAverage;         // 0x8000 = every call answered
+
+    // Bell-on time
+    unsigned long ringTicks[MAX_LINES];
+    uint8_t ringRemainder;                          // Line-units not yet credited (< TICK_UNITS * MAX_LINES)
+    uint8_t ringingLines;
+
+    // Time at concurrency
+    static const uint8_t LEVELS = MAX_LINES + 1;
+    uint16_t concurrencyTicks[LEVELS];
+    uint8_t levelRemainder;                         // Units not yet counted
+    uint8_t activeLines;
+    uint8_t level;
+
+    void advance(unsigned long now);
+    void accountLevel(unsigned long units);
+    void accountRings(unsigned long units);
+    unsigned long pendingUnits(unsigned long now) const;
+    unsigned long ringTicksAt(uint8_t line, unsigned long now) const;
+    unsigned long ticksAt(uint8_t callLevel, unsigned long now) const;
+    unsigned long totalTicks(unsigned long now) const;
+};
+
+#endif
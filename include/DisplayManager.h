@@ -3,8 +3,15 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "Features.h"
+#if FEATURE_LCD
 #include <hd44780.h>                       // main hd44780 header
 #include <hd44780ioClass/hd44780_I2Cexp.h> // i2c expander i/o class header
+#include "LcdTransport.h"                  // batched PCF8574 i/o class
+#include "GlyphManager.h"
+#else
+#include "NullLcd.h"                       // headless: empty stand-ins
+#endif
 
 // Forward declarations
 class RingerManager;
@@ -13,12 +20,18 @@ class DisplayManager {
 public:
     DisplayManager();
     
-    // Initialize display
-    void initialize(bool enableSerialOutput = true);
+    // Initialize display - cachedAddress skips the bus scan when it still answers
+    void initialize(bool enableSerialOutput = true, uint8_t cachedAddress = 0);
+    
+    // I2C address the LCD was found at (0 if no LCD)
+    uint8_t getI2CAddress() const;
     
-    // Update display content
+    // Redraw when something shown has changed (invalidate(), uptime clock, temp message expiry)
     void update(unsigned long currentTime, bool systemPaused, const RingerManager* ringerManager, int maxConcurrent = -1);
     
+    // Status screen content changed - redraw on the next update()
+    void invalidate();
+    
     // Display control
     void setBrightness(uint8_t brightness);
     void clear();
@@ -28,6 +41,9 @@ public:
     void showMenuMessage(const char* line1, const char* line2 = "", 
                         const char* line3 = "", const char* line4 = "");
     
+    // Overwrite one field in place (padded to width) without clearing the screen
+    void writeField(uint8_t column, uint8_t row, const char* text, uint8_t width);
+    
     // Display specific screens
     void showStatus(const RingerManager* ringerManager, bool paused, int maxConcurrent = -1);
     void showStartupMessage();
@@ -37,13 +53,41 @@ public:
     void showRelayAdjustmentMessage(int newCount); // Brief relay adjustment feedback
     void showRelayAdjustmentDirection(int newCount, bool increment); // Show +1/-1 style feedback
     void showSaveExitMessage(); // Menu long-press save & exit confirmation
+    
+    // Bus speed, bytes per character and redraw times
+    void printStatus() const;
+    void resetStats();
 
 private:
-    hd44780_I2Cexp lcd; // declare lcd object: auto locate & auto config expander chip
+#if FEATURE_LCD
+    typedef hd44780 Lcd;
+    typedef LcdTransport Transport;
+    typedef hd44780_I2Cexp GenericLcd;
+    typedef GlyphManager Glyphs;
+#else
+    typedef NullLcd Lcd;
+    typedef NullLcd Transport;
+    typedef NullLcd GenericLcd;
+    typedef NullGlyphs Glyphs;
+#endif
+
+    Transport transport;            // Batched expander transport - every drawing method ends with lcd->flush()
+    GenericLcd genericLcd;          // Library auto-config for backpacks the transport doesn't handle
+    Lcd* lcd;                       // Whichever of the two drives the LCD
+    bool enableSerialOutput;
     bool lcdAvailable;  // Track if LCD is actually working
+    uint8_t lcdAddress; // I2C address the LCD answered at
     unsigned long lastUpdate;
     uint8_t currentScreen;
     bool displayNeedsUpdate;
+    bool statusShown;               // Status screen is what's on the LCD (storm icon visible)
+    
+    // Uptime shown on the status screen, counted up a second at a time
+    // rather than divided out of millis() on every frame
+    unsigned long nextClockTick;    // millis() at which the next second starts
+    uint16_t clockHours;
+    uint8_t clockMinutes;
+    uint8_t clockSeconds;
     
     // Temporary message state (non-blocking)
     bool showingTempMessage;
@@ -51,17 +95,33 @@ private:
     char tempMessageText[21];  // Buffer for temporary message
     static const unsigned long TEMP_MESSAGE_DURATION = 800;  // 0.8 seconds
     
-    // Animated storm icon state
+    // Redraw timing (update() calls that drew something)
+    unsigned long frameCount;
+    unsigned long lastFrameMicros;
+    unsigned long maxFrameMicros;
+    unsigned long lastStatusPrint;
+    static const unsigned long STATUS_PRINT_INTERVAL = 10000; // Print status every 10 seconds
+    
+    // Custom characters
+    Glyphs glyphs;
+    
+    // Animated storm icon state - every frame stays loaded, animating rewrites one cell
     bool animationEnabled;
     unsigned long lastAnimationUpdate;
     uint8_t currentAnimationFrame;
     static const unsigned long ANIMATION_FRAME_DURATION = 250;  // 4 FPS (250ms per frame)
     static const uint8_t ANIMATION_FRAME_COUNT = 4;  // 4 frames for retro charm
+    static const uint8_t STORM_ICON_COLUMN = 10;     // "CallStorm " then the icon, row 0
+    uint8_t stormGlyphs[ANIMATION_FRAME_COUNT];      // Character code of each frame
 
     // Helper methods
     // Note: Legacy String-based methods removed for heap safety
-    void initializeStormAnimation(); // Load custom characters for storm icon
-    void updateStormAnimation(); // Update animation frame if needed
+    bool lcdReady() const { return Features::LCD && lcdAvailable; }  // Folds to false in headless builds
+    bool probeI2CAddress(uint8_t address);
+    void initializeStormAnimation(); // Pin the storm frames into CGRAM
+    void updateStormAnimation(unsigned long currentTime); // Update animation frame if needed
+    bool tickClock(unsigned long currentTime);  // Catch the uptime clock up, true if it moved
+    void writeCentered(uint8_t row, const char* text, int offset);  // Use with CENTERED()
 };
 
 #endif
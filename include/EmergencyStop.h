@@ -0,0 +1,59 @@
+#ifndef EMERGENCY_STOP_H
+#define EMERGENCY_STOP_H
+
+#include <stdint.h>
+
+// Pause button as an emergency stop.
+//
+// The button (A0-A5) gets a pin change interrupt. When it goes LOW while
+// armed, the ISR drives every relay pin and the ringer power pin HIGH (off
+// for the active-LOW modules) with one read-modify-write per port, and
+// drops all pending relay edges. Nothing waits for the main loop, so an
+// LCD redraw or a delay() can't hold the bells on.
+//
+// The trip stays latched until acknowledge(): meanwhile no relay edge or
+// writeOutput() may switch anything back on. The main loop notes when it
+// noticed, does the usual pause bookkeeping, then acknowledges and learns
+// how far behind the cut it was.
+// The stop is disarmed by the trip and re-armed with arm() - after the
+// resume press has been released, so its bounce can't trip it again.
+//
+// On the host (no ARDUINO define) there is no pin change interrupt; the
+// host program calls handlePinChange() when it changes a port C input.
+class EmergencyStop {
+public:
+    static const uint8_t MAX_OUTPUTS = 9;   // Eight relays and the ringer power
+
+    // Watch buttonPin and cut these outputs when it is pressed. Disarmed.
+    static void begin(uint8_t buttonPin, const int* relayPins, uint8_t relayCount, uint8_t powerPin);
+
+    static void arm();
+    static bool isArmed();
+
+    // Outputs cut and the main loop hasn't caught up yet
+    static bool isTripped();
+
+    // Main loop noticed the trip at noticedMicros and has since paused
+    // everything - clears the trip and returns how long after the cut it noticed
+    static unsigned long acknowledge(unsigned long noticedMicros);
+
+    // Worst acknowledge() result and the number of trips since begin()
+    static unsigned long getMaxCatchUpMicros();
+    static uint16_t getTripCount();
+
+    // digitalWrite() for a guarded output - LOW (on) is refused while tripped,
+    // checked with interrupts off so a trip can't slip in between
+    static void writeOutput(uint8_t pin, uint8_t level);
+
+    // Called from the pin change interrupt
+    static void handlePinChange();
+
+private:
+    static volatile bool armed;
+    static volatile bool tripped;
+    static volatile unsigned long tripMicros;
+    static volatile uint16_t tripCount;
+    static unsigned long maxCatchUpMicros;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define ENCODER_MANAGER_H
 
 #include <Arduino.h>
+#include "InputDebouncer.h"
 
 class EncoderManager {
 public:
@@ -15,13 +16,28 @@ public:
         BUTTON_LONG_PRESS
     };
     
+    // Spin speed -> step multiplier. A detent that follows the previous one
+    // (same direction) within fastInterval ms scales by fastMultiplier, within
+    // mediumInterval by mediumMultiplier, otherwise by 1.
+    struct AccelerationCurve {
+        uint16_t mediumInterval;
+        uint16_t fastInterval;
+        uint8_t mediumMultiplier;
+        uint8_t fastMultiplier;
+    };
+    
     EncoderManager();
     
-    // Initialize encoder pins
-    void initialize(int pinA, int pinB, int buttonPin, bool enableInitOutput = true);
+    // Register the encoder pins with the shared debouncer
+    void initialize(InputDebouncer* inputs, int pinA, int pinB, int buttonPin, bool enableInitOutput = true);
+    
+    // Call after every inputs->update() to turn its levels and edges into events
+    EncoderEvent update(unsigned long currentTime);
     
-    // Call this frequently in main loop to check for events
-    EncoderEvent update();
+    // Step multiplier for the rotation event update() just returned (1 when turned slowly)
+    uint8_t getStepMultiplier() const;
+    
+    void setAccelerationCurve(const AccelerationCurve& curve);
     
     // Get current encoder state for debugging
     bool getButtonState() const;
@@ -29,37 +45,28 @@ public:
     
 private:
     // Pin assignments
+    InputDebouncer* inputs;
     int encoderPinA;
     int encoderPinB;
     int encoderButtonPin;
     
-    // Encoder state tracking
+    // Encoder state tracking (debounced levels)
     bool lastA;
-    bool lastB;
-    bool currentA;
-    bool currentB;
-    
-    // Button state tracking
-    bool lastButtonState;
-    bool currentButtonState;
-    bool lastRawButtonState;  // Track last raw state for debouncing
-    bool buttonPressed;
-    unsigned long buttonPressTime;
-    unsigned long lastButtonDebounce;
     
-    // Debug support
-    unsigned long lastDebugPrint;
-    static const unsigned long DEBUG_INTERVAL = 5000; // Print debug every 5 seconds
+    // Acceleration - detent rate is a running average so one quick twitch doesn't jump
+    AccelerationCurve acceleration;
+    unsigned long lastDetentTime;
+    uint16_t averageInterval;       // Smoothed ms between detents (0 = no rate yet)
+    EncoderEvent lastDirection;
+    uint8_t stepMultiplier;
+    static const uint16_t ACCELERATION_RESET_INTERVAL = 250;  // Pause this long = slow again
     
-    // Timing constants
-    static const unsigned long BUTTON_DEBOUNCE_TIME = 50;    // 50ms debounce
-    static const unsigned long LONG_PRESS_TIME = 1000;       // 1 second for long press
+    // A long press was reported for the current press, so its release isn't a short press
+    bool longPressReported;
     
     // Helper methods
-    bool readEncoderA();
-    bool readEncoderB();
-    bool readButton();
     EncoderEvent checkRotation();
+    void updateAcceleration(EncoderEvent direction, unsigned long currentTime);
     EncoderEvent checkButton();
 };
 
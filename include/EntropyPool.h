@@ -0,0 +1,50 @@
+#ifndef ENTROPY_POOL_H
+#define ENTROPY_POOL_H
+
+#include <stdint.h>
+
+// Background entropy for seeding the random streams.
+//
+// The ADC converts a floating analog input back to back. Its conversion-
+// complete interrupt stirs every reading, together with Timer0's count
+// (interrupt latency jitter), into a small byte pool. A reading that
+// differs from the one before is credited one bit, and conversions stop
+// once POOL_TARGET_BITS are credited, so a full pool costs nothing.
+// takeSeed() hashes the pool on the spot and starts harvesting again.
+//
+// The pool owns the ADC - nothing else may call analogRead() once begin()
+// has run. On the host (no ARDUINO define) there is no ADC interrupt, so
+// each harvest runs to completion from analogRead() when it starts.
+class EntropyPool {
+public:
+    static const uint8_t POOL_SIZE = 16;            // Bytes, a power of two
+    static const uint8_t POOL_TARGET_BITS = 128;    // Harvest until this many bits are credited
+
+    // Start harvesting from an analog input (A0-A7)
+    static void begin(uint8_t pin);
+
+    // Seed from the pool as it is right now - never waits
+    static uint32_t takeSeed();
+
+    // Bits credited since the last takeSeed() (at most POOL_TARGET_BITS)
+    static uint8_t getQuality();
+
+    // Conversions stirred in since begin()
+    static unsigned long getSampleCount();
+
+    // Called from the ADC interrupt
+    static void handleConversion(uint16_t reading, uint8_t jitter);
+
+private:
+    static volatile uint8_t pool[POOL_SIZE];
+    static volatile uint8_t position;
+    static volatile uint8_t quality;
+    static volatile uint16_t lastReading;
+    static volatile unsigned long sampleCount;
+    static volatile bool harvesting;
+    static uint8_t analogPin;
+
+    static void startConversion();
+};
+
+#endif
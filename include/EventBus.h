@@ -0,0 +1,73 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <stdint.h>
+
+// Host builds give every thread its own queue so simulations can run in
+// parallel; subscribers are shared and registered before any thread starts
+#ifdef ARDUINO
+#define EVENT_QUEUE_STORAGE
+#else
+#define EVENT_QUEUE_STORAGE thread_local
+#endif
+
+// Ringer state changes, published by RingerManager as they happen.
+//
+// Events wait in a small fixed queue until dispatch() hands them to every
+// subscriber whose mask includes that event type, so the LED, power and
+// display code only runs when something actually changed instead of polling
+// RingerManager every pass.
+class EventBus {
+public:
+    enum EventType {
+        CALL_STARTED,       // Line began a call (first ring starts with it)
+        RING_ON,            // Bell energized
+        RING_OFF,           // Bell released
+        CALL_ENDED,         // Call finished or was stopped - bell is off, line is free again
+        LINE_ENABLED,       // Line brought into service by the active relay count
+        LINE_DISABLED,      // Line taken out of service
+        EVENT_TYPE_COUNT
+    };
+    
+    struct Event {
+        uint8_t type;       // EventType
+        uint8_t line;       // 0-based phone index
+    };
+    
+    typedef void (*EventHandler)(const Event& event);
+    
+    // Subscription mask bits
+    static uint8_t maskOf(EventType type) { return 1 << type; }
+    static const uint8_t ALL_EVENTS = (1 << EVENT_TYPE_COUNT) - 1;
+    
+    // Register a handler for the event types in mask - done once from setup()
+    static bool subscribe(uint8_t mask, EventHandler handler);
+    
+    // Queue an event; returns false (and counts it) if the queue is full
+    static bool publish(EventType type, uint8_t line);
+    
+    // Deliver queued events in order, returns how many were delivered
+    static uint8_t dispatch();
+    
+    static uint8_t getPendingCount();
+    static unsigned long getDroppedCount();
+
+private:
+    struct Subscriber {
+        uint8_t mask;
+        EventHandler handler;
+    };
+    
+    static const uint8_t MAX_SUBSCRIBERS = 6;
+    static const uint8_t QUEUE_SIZE = 16;   // Worst case: every line stopped and disabled at once
+    
+    static Subscriber subscribers[MAX_SUBSCRIBERS];
+    static uint8_t subscriberCount;
+    
+    static EVENT_QUEUE_STORAGE Event queue[QUEUE_SIZE];    // Ring buffer
+    static EVENT_QUEUE_STORAGE uint8_t queueHead;
+    static EVENT_QUEUE_STORAGE uint8_t queueCount;
+    static EVENT_QUEUE_STORAGE unsigned long droppedCount;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef FAST_RANDOM_H
+#define FAST_RANDOM_H
+
+#include <stdint.h>
+
+// Small xorshift32 engine - one instance per phone line so each line has its
+// own independent, replayable stream. Plain stdint so it also builds on the host.
+//
+// Bounded draws use multiply-and-shift instead of modulo (no division on the
+// AVR). The bias is below range/2^32, far smaller than anything audible.
+class FastRandom {
+public:
+    FastRandom() : state(DEFAULT_STATE) {}
+    
+    // Seed a stream - the same (seed, stream) pair always gives the same sequence
+    void seed(uint32_t seedValue, uint8_t stream = 0) {
+        // Scramble so adjacent seeds/streams start far apart (murmur3 finalizer)
+        uint32_t z = seedValue ^ ((uint32_t)stream * 0x9E3779B9UL);
+        z ^= z >> 16;
+        z *= 0x85EBCA6BUL;
+        z ^= z >> 13;
+        z *= 0xC2B2AE35UL;
+        z ^= z >> 16;
+        state = (z != 0) ? z : DEFAULT_STATE;  // xorshift must never hold zero
+    }
+    
+    // Raw 32-bit output
+    uint32_t next() {
+        uint32_t x = state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state = x;
+        return x;
+    }
+    
+    // Value in [0, bound) - 16x16 multiply when the range allows it
+    uint32_t below(uint32_t bound) {
+        if (bound <= 0xFFFFUL) {
+            return ((next() >> 16) * bound) >> 16;
+        }
+        return (uint32_t)(((uint64_t)next() * bound) >> 32);
+    }
+    
+    // Value in [minValue, maxValue) - same contract as Arduino random(min, max)
+    long range(long minValue, long maxValue) {
+        if (minValue >= maxValue) {
+            return minValue;
+        }
+        return minValue + (long)below((uint32_t)(maxValue - minValue));
+    }
+    
+    // True with the given percent probability (0-100)
+    bool chance(uint8_t percent) {
+        return below(100) < percent;
+    }
+    
+    // Current position in the stream, for replaying from a known point
+    uint32_t getState() const { return state; }
+
+private:
+    uint32_t state;
+    
+    static const uint32_t DEFAULT_STATE = 0x6D2B79F5UL;
+};
+
+#endif
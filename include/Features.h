@@ -0,0 +1,61 @@
+#ifndef FEATURES_H
+#define FEATURES_H
+
+#include <Arduino.h>
+
+// Compile-time feature selection.
+//
+// Each FEATURE_ macro defaults to the full build and can be overridden with
+// -D in platformio.ini (see the variant environments there). Code tests the
+// constexpr mirrors in Features:: with ordinary if statements, so a disabled
+// feature still type-checks but its code and strings are dropped by the
+// optimizer and linker instead of being skipped at run time.
+
+#ifndef FEATURE_SERIAL_DEBUG
+#define FEATURE_SERIAL_DEBUG 1      // Serial status/debug output
+#endif
+
+#ifndef FEATURE_LCD
+#define FEATURE_LCD 1               // 20x4 I2C LCD (0 = headless relay-only build)
+#endif
+
+#ifndef FEATURE_STORM_ANIMATION
+#define FEATURE_STORM_ANIMATION 1   // Animated storm icon on the status screen
+#endif
+
+#ifndef FEATURE_CHAOS_MODE
+#define FEATURE_CHAOS_MODE 1        // Long-press Maximum Chaos easter egg
+#endif
+
+#ifndef FEATURE_CONFIG_MANAGER
+#define FEATURE_CONFIG_MANAGER 0    // Unused ConfigManager/SystemConfig prototype
+#endif
+
+namespace Features {
+    constexpr bool SERIAL_DEBUG = FEATURE_SERIAL_DEBUG;
+    constexpr bool LCD = FEATURE_LCD;
+    constexpr bool STORM_ANIMATION = FEATURE_LCD && FEATURE_STORM_ANIMATION;
+    constexpr bool CHAOS_MODE = FEATURE_CHAOS_MODE;
+}
+
+// Stand-in for Serial when debug output is compiled out - every call is an
+// empty inline, so neither the strings nor HardwareSerial get linked
+class NullSerial {
+public:
+    void begin(unsigned long) {}
+    template <typename T> size_t print(const T&) { return 0; }
+    template <typename T> size_t print(const T&, int) { return 0; }
+    template <typename T> size_t println(const T&) { return 0; }
+    template <typename T> size_t println(const T&, int) { return 0; }
+    size_t println() { return 0; }
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+#if FEATURE_SERIAL_DEBUG
+#define DebugSerial Serial
+#else
+#define DebugSerial NullSerial()
+#endif
+
+#endif
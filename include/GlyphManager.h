@@ -0,0 +1,57 @@
+#ifndef GLYPH_MANAGER_H
+#define GLYPH_MANAGER_H
+
+#include <Arduino.h>
+#include <hd44780.h>
+
+// Custom character slots on the HD44780.
+//
+// The LCD has 8 CGRAM slots and redefining one costs a 9-byte I2C burst.
+// Glyphs that are always needed (the storm animation frames) are pinned
+// once at startup so an animation step is a single character write. The
+// remaining slots are handed out least-recently-used for occasional icons,
+// and a glyph that is still loaded is reused without touching CGRAM.
+class GlyphManager {
+public:
+    static const uint8_t SLOT_COUNT = 8;
+    static const uint8_t NO_GLYPH = 0xFF;
+    
+    GlyphManager();
+    
+    // Attach to the LCD and forget all slots (CGRAM contents are unknown after begin())
+    void initialize(hd44780* lcd);
+    
+    // Load a glyph into a slot it keeps for good. Returns its character code or NO_GLYPH.
+    uint8_t pin(const uint8_t* bitmap);
+    
+    // Character code for a glyph, loading it into the least recently used
+    // unpinned slot if it isn't already there. NO_GLYPH if every slot is pinned.
+    uint8_t acquire(const uint8_t* bitmap);
+    
+    // Character code if the glyph is currently loaded, NO_GLYPH otherwise
+    uint8_t find(const uint8_t* bitmap) const;
+    
+    uint8_t getFreeSlotCount() const;  // Unpinned slots
+    unsigned long getLoadCount() const; // CGRAM writes so far
+
+private:
+    struct Slot {
+        const uint8_t* bitmap;  // Glyph data the slot holds (nullptr = empty)
+        uint8_t lastUse;        // Use stamp for LRU
+        bool pinned;
+    };
+    
+    hd44780* lcd;
+    Slot slots[SLOT_COUNT];
+    uint8_t useCounter;
+    unsigned long loadCount;
+    
+    int8_t findSlot(const uint8_t* bitmap) const;
+    int8_t findVictim() const;
+    void load(uint8_t slot, const uint8_t* bitmap);
+    
+    // Slot 0 is addressed as code 8 so glyph codes never end a C string
+    static uint8_t charCode(uint8_t slot) { return slot == 0 ? SLOT_COUNT : slot; }
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef INPUT_DEBOUNCER_H
+#define INPUT_DEBOUNCER_H
+
+#include <Arduino.h>
+
+// All front panel inputs, sampled together and debounced in parallel.
+//
+// update() reads PIND, PINB and PINC once into one 24-bit word (lane =
+// port bit) and runs a 2-bit vertical counter across every lane at once:
+// count0/count1 hold bit 0 and bit 1 of each lane's counter, so a handful
+// of bitwise operations debounce all inputs in the same time as one. A
+// lane's debounced level flips after it has disagreed with it for four
+// counted samples in a row - any agreeing sample starts it over.
+//
+// Encoder contacts count every sample (4ms at the 1 kHz input rate, quick
+// enough for a fast spin); buttons count every BUTTON_SAMPLE_DIVIDER-th
+// sample for a ~40ms debounce. Buttons are active LOW (INPUT_PULLUP) and
+// report press, release and long-press edges for the update() that found them.
+class InputDebouncer {
+public:
+    static const uint8_t MAX_BUTTONS = 4;
+    static const uint8_t BUTTON_SAMPLE_DIVIDER = 10;    // Button counters advance every 10th sample
+    static const unsigned long LONG_PRESS_TIME = 1000;  // Held this long = long press
+
+    InputDebouncer();
+
+    // Register pins (sets INPUT_PULLUP, starts at the current level) - before the first update()
+    void addEncoderLine(uint8_t pin);
+    bool addButton(uint8_t pin);
+
+    // Sample every registered input once and debounce them
+    void update(unsigned long currentTime);
+
+    // Debounced level of a registered pin
+    uint8_t read(uint8_t pin) const;
+
+    // Button edges found by the last update()
+    bool pressed(uint8_t pin) const;
+    bool released(uint8_t pin) const;
+    bool longPressed(uint8_t pin) const;    // Once per press, LONG_PRESS_TIME after it began
+
+private:
+    uint32_t encoderLanes;
+    uint32_t buttonLanes;
+    uint32_t state;             // Debounced levels
+    uint32_t count0;            // Vertical counter, bit 0 of each lane
+    uint32_t count1;            // Vertical counter, bit 1 of each lane
+    uint8_t buttonTick;
+
+    // Edges from the last update()
+    uint32_t pressedLanes;
+    uint32_t releasedLanes;
+    uint32_t longPressLanes;
+
+    // Long press timing - only buttons still held and not yet reported are checked
+    uint8_t buttonPins[MAX_BUTTONS];
+    unsigned long pressTime[MAX_BUTTONS];
+    uint8_t buttonCount;
+    uint32_t longPending;
+
+    static uint32_t laneOf(uint8_t pin);
+    uint32_t sample() const;
+};
+
+#endif
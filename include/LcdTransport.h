@@ -0,0 +1,95 @@
+#ifndef LCD_TRANSPORT_H
+#define LCD_TRANSPORT_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <hd44780.h>
+
+// Batched hd44780 i/o class for the PCF8574 LCD backpack.
+//
+// The stock hd44780_I2Cexp sends every character as its own Wire
+// transmission. This class queues the expander bytes instead (two per
+// nibble: data with E high, then E low to latch) and sends them when the
+// 32-byte Wire buffer is full or the caller flush()es at the end of a
+// drawing operation, so a 20-character row is 3 transmissions instead of
+// 21. Clear and home go out at once - the library times their 1.5ms
+// execution from the moment they're sent.
+//
+// Queued instructions need no software delay: each write is followed by
+// enough E-low repeats that the next latch comes at least EXEC_MICROS
+// later. That is none at 100 kHz (two bytes are 180us) and two bytes at
+// 400 kHz, where two bare bytes (45us) are too close for the 37us nominal
+// instruction time plus slow clones that take over 50us.
+//
+// Only the common backpack wiring is handled. ioinit() checks it by
+// reading the busy flag back on D7 and returns RV_ENOTSUP on anything
+// else (other pin maps, MCP23008, RW tied low) so the caller can fall back
+// to hd44780_I2Cexp's auto-config. Backlight polarity is detected the way
+// hd44780_I2Cexp does it.
+//
+// The bus is switched to 400 kHz when the expander reads its port back
+// correctly at that speed, otherwise it stays at 100 kHz. Nothing else is
+// on this project's I2C bus.
+class LcdTransport : public hd44780 {
+public:
+    static const uint32_t STANDARD_CLOCK = 100000;
+    static const uint32_t FAST_CLOCK = 400000;
+    static const uint16_t EXEC_MICROS = 80;     // Latch to latch - 37us nominal, margin for slow clones
+
+    struct Stats {
+        uint32_t transactions;
+        uint32_t bytes;             // Expander bytes sent (address bytes not included)
+        uint32_t characters;        // Character and CGRAM data writes
+        uint32_t busMicros;         // Time spent in endTransmission()
+    };
+
+    LcdTransport();
+
+    // Backpack address - set before begin()
+    void setAddress(uint8_t address);
+
+    // hd44780::begin() plus the execution times batching makes safe
+    int begin(uint8_t cols, uint8_t rows);
+
+    // Send whatever is queued
+    void flush() override;
+
+    uint32_t getClock() const;
+    const Stats& getStats() const;
+    void resetStats();
+
+private:
+    // Backpack wiring: P0=RS, P1=RW, P2=E, P3=backlight, P4-P7=D4-D7
+    static const uint8_t PIN_RS = 0x01;
+    static const uint8_t PIN_RW = 0x02;
+    static const uint8_t PIN_E = 0x04;
+    static const uint8_t PIN_BACKLIGHT = 0x08;
+    static const uint8_t PIN_D7 = 0x80;         // Busy flag during a status read
+    static const uint8_t DATA_PINS = 0xF0;
+    static const uint8_t READBACK_MASK = 0xF1;  // RS and data read back as written (the backlight driver may not)
+    static const uint8_t QUEUE_SIZE = BUFFER_LENGTH;
+    static const unsigned long READY_TIMEOUT_MS = 50;   // Longest the LCD may stay busy (power-on reset)
+
+    uint8_t address;
+    uint8_t backlightOnMask;    // PIN_BACKLIGHT when active high, 0 when active low
+    uint8_t backlightMask;      // Backlight bit as currently driven
+    uint8_t padBytes;           // E-low repeats after each write
+    uint32_t clock;
+    uint8_t queue[QUEUE_SIZE];
+    uint8_t queueLength;
+    Stats stats;
+
+    // hd44780 i/o class hooks
+    int ioinit() override;
+    int iowrite(hd44780::iotype type, uint8_t value) override;
+    int iosetbacklight(uint8_t dimvalue) override;
+
+    bool send();
+    bool writePort(uint8_t value);
+    bool readPort(uint8_t& value);
+    bool portReadsBack(uint8_t value);
+    bool readsBusyFlag();
+    void queueNibble(uint8_t nibble, uint8_t control);
+};
+
+#endif
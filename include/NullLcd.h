@@ -0,0 +1,47 @@
+#ifndef NULL_LCD_H
+#define NULL_LCD_H
+
+#include <Arduino.h>
+
+// Stand-ins for the LCD classes in headless builds (FEATURE_LCD=0).
+//
+// DisplayManager's drawing code still compiles against these, but every
+// call is an empty inline behind lcdReady(), which folds to false - so no
+// hd44780 vtable, Wire or CGRAM bookkeeping gets linked, and the members
+// take a byte each.
+class NullLcd {
+public:
+    static const int RV_ENOTSUP = -3;
+
+    struct Stats {
+        uint32_t transactions;
+        uint32_t bytes;
+        uint32_t characters;
+        uint32_t busMicros;
+    };
+
+    NullLcd() {}
+    explicit NullLcd(uint8_t) {}
+
+    void setAddress(uint8_t) {}
+    int begin(uint8_t, uint8_t) { return -1; }
+    int clear() { return 0; }
+    int setCursor(uint8_t, uint8_t) { return 0; }
+    int backlight() { return 0; }
+    int noBacklight() { return 0; }
+    template <typename T> size_t print(const T&) { return 0; }
+    size_t write(uint8_t) { return 0; }
+    void flush() {}
+
+    uint32_t getClock() const { return 0; }
+    Stats getStats() const { return Stats(); }
+    void resetStats() {}
+};
+
+class NullGlyphs {
+public:
+    void initialize(NullLcd*) {}
+    uint8_t pin(const uint8_t*) { return 0xFF; }
+};
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef RELAY_EDGE_ENGINE_H
+#define RELAY_EDGE_ENGINE_H
+
+#include <stdint.h>
+
+// Hardware-timed relay edges.
+//
+// Timer1 free-runs at 4us per tick; upcoming relay transitions sit in a small
+// queue sorted by time, and the compare-match interrupt flips each relay pin
+// at its scheduled tick. The main loop only has to keep the queue topped up,
+// so LCD, EEPROM or Serial work no longer delays ring cadence.
+//
+// With zero-cross sync enabled, an edge that comes due is held for the next
+// predicted zero crossing of the switched AC, less the relay's operate or
+// release time, so the contacts meet at zero volts. Every edge that comes due
+// before that crossing is batched onto it. Without a signal (nothing wired,
+// or it stops) edges fire on time as before.
+//
+// On the host (no ARDUINO define) the timer and the zero-cross signal are
+// emulated so the queue logic can be exercised with emulateAdvance().
+class RelayEdgeEngine {
+public:
+    static const uint8_t MAX_EDGES = 16;                 // Two pending edges per line
+    static const uint16_t TICKS_PER_MS = 250;            // 16MHz / 64 prescaler
+    
+    // Plausible AC half cycles: 1ms (500Hz) to 40ms (12.5Hz, below ring frequency)
+    static const uint16_t MIN_HALF_CYCLE_TICKS = 250;
+    static const uint16_t MAX_HALF_CYCLE_TICKS = 10000;
+    
+    // Start Timer1 and the overflow interrupt
+    static void begin();
+    
+    // Timer1 ticks since begin() - wraps after ~4.7 hours, compare with signed differences
+    static uint32_t now();
+    
+    static uint32_t msToTicks(unsigned long ms);
+    
+    // Drive pin to level at the given tick (times in the past fire immediately).
+    // Returns false if the queue is full.
+    static bool scheduleEdge(uint8_t pin, uint8_t level, uint32_t atTicks);
+    
+    // Drop pending edges for one pin, or for every pin
+    static void cancelEdges(uint8_t pin);
+    static void cancelAll();
+    
+    // Drop every pending edge and, until releaseHold(), every edge that would
+    // switch a relay on (the emergency stop's latch)
+    static void holdOff();
+    static void releaseHold();
+    
+    static uint8_t getPendingCount();
+    
+    // Worst delay between an edge's scheduled tick and the pin actually changing
+    // (for a synced edge, the tick it was moved to)
+    static uint32_t getMaxLatenessMicros();
+    static void resetStats();
+    
+    // Sync edges to a zero-cross detector on pin (A0-A5: pin change interrupt,
+    // a crossing is the rising edge of the detector's pulse). Relay modules
+    // are active LOW - LOW edges lead the crossing by operateMicros, HIGH
+    // edges by releaseMicros. Call after begin().
+    static void enableZeroCross(uint8_t pin, uint16_t operateMicros, uint16_t releaseMicros);
+    
+    // Measured AC half cycle, 0 while there is no signal
+    static uint32_t getHalfCycleMicros();
+    
+    // Crossings that edges have been batched onto since resetStats()
+    static uint16_t getSyncedBatches();
+    
+    // Called from the Timer1 and pin change interrupts
+    static void handleOverflow();
+    static void handleCompare();
+    static void handleZeroCross();
+    static void handlePinChange();      // Port C change - a crossing if the detector pin is high
+    
+#ifndef ARDUINO
+    // Host only: move the emulated timer forward, firing compare matches and
+    // zero crossings on the way
+    static void emulateAdvance(uint32_t ticks);
+    
+    // Host only: emulated zero-cross signal with this half cycle (0 = no signal),
+    // first crossing one half cycle from now
+    static void emulateZeroCross(uint32_t halfCycleTicks);
+#endif
+
+private:
+    struct Edge {
+        uint32_t time;      // Timer1 tick to switch at
+        uint8_t pin;
+        uint8_t level;      // HIGH/LOW to write (relay modules are active LOW)
+        bool synced;        // time already moved onto a zero crossing
+    };
+    
+    static Edge queue[MAX_EDGES];   // Sorted, soonest first
+    static volatile uint8_t edgeCount;
+    static volatile uint16_t overflowCount;
+    static volatile uint32_t maxLatenessTicks;
+    static volatile bool heldOff;
+    
+    // Zero-cross tracking, written by handleZeroCross()
+    static bool zeroCrossEnabled;
+    static uint16_t operateTicks;
+    static uint16_t releaseTicks;
+    static volatile uint32_t lastCrossing;
+    static volatile uint32_t halfCycleTicks;     // 0 = no signal
+    static volatile bool halfCycleConfirmed;     // Last interval matched the estimate
+    static volatile uint16_t syncedBatches;
+    static uint32_t syncedCrossing;             // Crossing the latest batch switches on
+    
+    // Compare match is only 16 bits - edges further out are reached by re-arming
+    static const uint16_t MAX_ARM_TICKS = 0xF000;
+    static const uint8_t MIN_ARM_TICKS = 4;
+    
+    static void armCompare();
+    static void applyDueEdges();
+    static bool zeroCrossLocked(uint32_t currentTicks);
+    static void syncDueEdges(uint32_t currentTicks);
+    static void removeAt(uint8_t index);
+};
+
+#endif
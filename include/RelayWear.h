@@ -0,0 +1,66 @@
+#ifndef RELAY_WEAR_H
+#define RELAY_WEAR_H
+
+#include <Arduino.h>
+
+// Per-relay switch counters and least-worn relay lookup.
+//
+// Every ring is one operate/release cycle of a physical relay. The counts
+// live in RAM and are saved to one of SAVE_SLOTS EEPROM records in turn, so
+// each record is rewritten only every fourth save.
+//
+// For selection the relays are kept in wear buckets: bucket b holds a bit
+// for every relay whose count is b levels (of LEVEL_SIZE operations) above
+// the least-worn relay's. leastWorn() checks at most BUCKETS masks, so it
+// costs the same however large the counts get; buckets are only rebuilt
+// when a relay crosses into the next level.
+class RelayWear {
+public:
+    static const uint8_t MAX_RELAYS = 8;
+    static const uint8_t BUCKETS = 8;               // Last bucket holds everything further ahead
+    static const uint16_t LEVEL_SIZE = 64;          // Operations per wear level
+    static const uint8_t SAVE_SLOTS = 4;
+    static const uint8_t NO_RELAY = 0xFF;
+
+    RelayWear();
+
+    // Load the newest saved record (all zero if there is none)
+    void begin(uint8_t relayCount);
+
+    // One operate/release cycle of a relay
+    void recordOperation(uint8_t relay);
+
+    // Least-worn relay among the candidate bits, NO_RELAY if there are none
+    uint8_t leastWorn(uint8_t candidates) const;
+
+    uint32_t getCount(uint8_t relay) const;
+    uint8_t getRelayCount() const;
+
+    // Write the counts to the next EEPROM slot (skipped if nothing changed)
+    void save();
+    bool isDirty() const;
+
+    void printStatus() const;
+
+private:
+    struct Record {
+        uint8_t version;
+        uint16_t sequence;                  // Newest record has the highest (wrapping)
+        uint32_t counts[MAX_RELAYS];
+        uint8_t checksum;
+    };
+
+    uint32_t counts[MAX_RELAYS];
+    uint8_t relayCount;
+    uint8_t bucketMasks[BUCKETS];
+    uint32_t baseLevel;                     // Level of the least-worn relay
+    uint16_t sequence;
+    uint8_t nextSlot;
+    bool dirty;
+
+    void rebuildBuckets();
+    static int slotAddress(uint8_t slot);
+    static uint8_t calculateChecksum(const Record& record);
+};
+
+#endif
@@ -3,6 +3,10 @@
 
 #include <Arduino.h>
 #include "TelephoneRinger.h"
+#include "ArrivalModel.h"
+#include "EventBus.h"
+#include "RelayWear.h"
+#include "CallStats.h"
 
 // Forward declaration  
 struct SystemConfig;
@@ -15,16 +19,24 @@ public:
     // Destructor
     ~RingerManager();
     
+    // Seed every line's random stream from one master seed (call before initialize
+    // so the first wait times are drawn from it). Same seed = same call pattern.
+    void seedRandom(uint32_t seed);
+    uint32_t getRandomSeed() const;
+    
     // Initialize with array of relay pins and configuration
     void initialize(const int* relayPins, int numPhones, const SystemConfig* config, bool enableSerialOutput = true);
     
     // Step all ringers with current time
     void step(unsigned long currentTime);
     
-    // Start a call on a specific phone (0-based index)
+    // Milliseconds until step() next has work to do - lets the caller sleep until then
+    unsigned long getTimeToNextEvent(unsigned long currentTime) const;
+    
+    // Start a call on a specific phone (0-based index) - bypasses the concurrent limit
     void startCall(int phoneIndex);
     
-    // Start a call with specific parameters
+    // Start a call with specific parameters - bypasses the concurrent limit
     void startCall(int phoneIndex, int ringCount, bool cutShort = false, bool useUKStyle = false);
     
     // Stop a call on a specific phone
@@ -33,13 +45,48 @@ public:
     // Stop all calls
     void stopAllCalls();
     
-    // Set callback for checking if new calls can start
-    void setCanStartCallCallback(bool (*callback)());
+    // Concurrent call limit - lines that want a call beyond it wait in a FIFO
+    // and the longest-waiting line starts as soon as a call ends
+    void setMaxConcurrent(int maxConcurrent);
+    int getMaxConcurrent() const;
+    int getQueuedLineCount() const;
+    
+    // Arrival mode: one Poisson arrival process hands calls to free lines
+    // instead of every line scheduling its own calls
+    void setArrivalMode(bool enabled);
+    bool isArrivalMode() const;
+    void setCallsPerHour(uint16_t callsPerHour);
+    unsigned long getArrivalCount() const;
+    unsigned long getBlockedArrivalCount() const; // Arrivals lost because no line was free
+    
+    // Let Timer1 switch ring cadence edges (see RelayEdgeEngine) - call after initialize
+    void setHardwareEdges(bool enabled);
+    
+    // Pause freezes the manager's virtual clock and forces every relay off;
+    // resume restarts the clock where it stopped and re-drives the relays, so
+    // each line carries on exactly where it was - waits, rings and arrivals
+    // keep their phase instead of all falling due at once. step() and
+    // getTimeToNextEvent() take millis() and convert it themselves.
+    void pause(unsigned long currentTime);
+    void resume(unsigned long currentTime);
+    bool isPaused() const;
+    const VirtualClock& getClock() const;
+    
+    // Wear balancing: every ring is counted against its relay, and a line
+    // starting a call first swaps relays with whichever idle line (active or
+    // not) holds the least-worn free relay - so the relays in use rotate even
+    // when fewer than all lines are active. nullptr = line N always on relay N.
+    void setWearBalancing(RelayWear* wear);
+    
+    // Call statistics: every call start, ring edge and call end is reported to
+    // stats in line time. Resets stats - attach before calls start. nullptr = off.
+    void setStatistics(CallStats* stats);
     
-    // Set callback for all phones to check concurrent limit
-    void setCanStartCallCallbackForAllPhones(bool (*callback)());
+    // Relay (index into the relay pins) a line is currently wired to
+    int getRelayForLine(int phoneIndex) const;
     
-    // Set the number of active relays (0-8) - phones beyond this count won't activate
+    // Set the number of active relays (0-8) - phones beyond this count won't activate.
+    // Call starts/ends, rings and enabled lines are published on the EventBus.
     void setActiveRelayCount(int count);
     
     // Get status information
@@ -61,7 +108,50 @@ private:
     const SystemConfig* systemConfig;
     unsigned long lastStatusPrint;
     bool enableSerialOutput;  // Flag to control serial output
+    VirtualClock clock;       // Line and arrival time - stands still while paused
     int activeRelayCount;     // Number of active relays
+    uint32_t randomSeedValue; // Master seed for the per-line random streams
+    
+    // Admission control - activeCallCount counts slots in use, waitQueue holds
+    // line indices in arrival order (ring buffer)
+    static const uint8_t MAX_WAITING_LINES = 8;
+    int maxConcurrent;
+    int activeCallCount;
+    uint8_t waitQueue[MAX_WAITING_LINES];
+    uint8_t waitQueueHead;
+    uint8_t waitQueueCount;
+    
+    // Arrival mode state
+    ArrivalModel arrivals;
+    bool arrivalMode;
+    unsigned long blockedArrivals;
+    
+    // Give a line a slot now, or queue it until one frees up. Calls started
+    // during step() take that pass's time, so lines stepped later in the same
+    // pass never see their new state begin after "now".
+    void requestSlot(int phoneIndex, unsigned long currentTime);
+    void releaseSlot(unsigned long currentTime);
+    void admitWaitingLines(unsigned long currentTime);
+    void removeFromWaitQueue(int phoneIndex);
+    
+    // Start a line's call and tell subscribers
+    void beginCall(int phoneIndex, unsigned long currentTime);
+    
+    // Logical line to relay mapping - a permutation, changed only between calls
+    const int* relayPins;
+    RelayWear* wear;
+    CallStats* stats;
+    uint8_t relayOf[RelayWear::MAX_RELAYS];
+    uint8_t lineOf[RelayWear::MAX_RELAYS];
+    uint8_t busyRelays;         // Bit per relay whose line is in a call
+    
+    void claimRelay(int phoneIndex);    // Call starting - move to the least-worn free relay
+    void releaseRelay(int phoneIndex);  // Call over
+    void ringStarted(int phoneIndex, unsigned long currentTime);
+    void callFinished(int phoneIndex, bool answered, unsigned long currentTime);  // Stats only
+    
+    // Hand an arrival to a random free active line, false if none is free
+    bool routeArrival(unsigned long currentTime);
     
     static const unsigned long STATUS_PRINT_INTERVAL = 10000; // Print status every 10 seconds
     
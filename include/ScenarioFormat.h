@@ -0,0 +1,55 @@
+#ifndef SCENARIO_FORMAT_H
+#define SCENARIO_FORMAT_H
+
+#include <stdint.h>
+
+// Scenario bytecode - shared by ScenarioPlayer and the host compiler
+// (host/scenario_compiler.cpp). Plain stdint so it also builds on the host.
+//
+// A script is a 4-byte header ('S', version, code length low/high) then
+// the code: one opcode byte followed by fixed-size operands, 16-bit values
+// little-endian. Every instruction has a fixed length and executes in
+// constant time, and the only state is the program counter and one wait.
+namespace Scenario {
+    const uint8_t MAGIC = 'S';
+    const uint8_t VERSION = 1;
+    const uint8_t HEADER_SIZE = 4;
+
+    enum Opcode {
+        OP_END = 0x00,          // Stop the show
+        OP_WAIT_MS = 0x01,      // u16 ms
+        OP_WAIT_S = 0x02,       // u16 seconds
+        OP_LINES = 0x10,        // u8 active lines (0-8)
+        OP_CONCURRENT = 0x11,   // u8 concurrent call limit (1-8)
+        OP_DELAY = 0x12,        // u16 Call Timing setting in seconds (10-1000)
+        OP_RATE = 0x13,         // u16 arrivals per hour, overriding Call Timing (0 = back to Call Timing)
+        OP_CALL = 0x20,         // u8 line, u8 rings (0 = random), u8 flags (CALL_*)
+        OP_HANGUP = 0x21,       // u8 line (ALL_LINES = every line)
+        OP_JUMP = 0x30          // u16 code offset
+    };
+
+    // OP_CALL flags
+    const uint8_t CALL_CUT_SHORT = 0x01;    // Final ring answered part way through
+    const uint8_t CALL_UK_STYLE = 0x02;     // UK double ring cadence
+
+    const uint8_t ALL_LINES = 0xFF;
+
+    // Bytes taken by an instruction, opcode included (0 = unknown opcode)
+    inline uint8_t instructionLength(uint8_t opcode) {
+        switch (opcode) {
+            case OP_END: return 1;
+            case OP_LINES:
+            case OP_CONCURRENT:
+            case OP_HANGUP: return 2;
+            case OP_WAIT_MS:
+            case OP_WAIT_S:
+            case OP_DELAY:
+            case OP_RATE:
+            case OP_JUMP: return 3;
+            case OP_CALL: return 4;
+            default: return 0;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SCENARIO_PLAYER_H
+#define SCENARIO_PLAYER_H
+
+#include <Arduino.h>
+#include "ScenarioFormat.h"
+
+// Forward declarations
+class RingerManager;
+
+// Settings a show may change - the sketch's own menu variables, so the
+// normal settings path (and the LCD) follow along
+struct ScenarioTargets {
+    int* activeLines;
+    int* maxConcurrent;
+    int* callDelay;
+};
+
+// Interpreter for scenario bytecode in PROGMEM (see ScenarioFormat.h).
+//
+// step() runs instructions until the next wait, at most MAX_OPS_PER_STEP of
+// them, so a script that never waits can't stall the loop. No allocation -
+// the whole state is a program counter and the current wait.
+class ScenarioPlayer {
+public:
+    static const uint8_t MAX_OPS_PER_STEP = 8;
+    static const unsigned long IDLE_INTERVAL = 1000;   // step() result when nothing is playing
+
+    ScenarioPlayer();
+
+    void initialize(RingerManager* ringerManager, const ScenarioTargets& targets);
+
+    // Start a script from the beginning - false if the header doesn't match this player
+    bool start(const uint8_t* script, unsigned long currentTime);
+    void stop();
+    bool isRunning() const;
+
+    // Run whatever is due. Returns milliseconds until it needs to run again.
+    unsigned long step(unsigned long currentTime);
+
+    // Arrival rate set by OP_RATE (0 = follow the Call Timing setting)
+    uint16_t getCallsPerHour() const;
+
+    // Milliseconds since start()
+    unsigned long getElapsed(unsigned long currentTime) const;
+
+private:
+    RingerManager* ringerManager;
+    ScenarioTargets targets;
+
+    const uint8_t* code;        // PROGMEM, after the header
+    uint16_t codeLength;
+    uint16_t pc;
+    bool running;
+    unsigned long startTime;
+    unsigned long waitStart;
+    unsigned long waitDuration;
+    uint16_t callsPerHour;
+
+    uint8_t fetch8(uint16_t offset) const;
+    uint16_t fetch16(uint16_t offset) const;
+    void execute(uint8_t opcode, unsigned long currentTime);
+};
+
+#endif
@@ -10,6 +10,14 @@
 // EEPROM addresses
 #define EEPROM_VERSION_ADDR 0
 #define EEPROM_SETTINGS_ADDR 4
+#define EEPROM_BOOT_CACHE_ADDR 16
+#define EEPROM_WEAR_ADDR 32             // RelayWear::SAVE_SLOTS records
+
+// Version for boot cache format - increment when changing structure
+#define BOOT_CACHE_VERSION 1
+
+// Version for relay wear records - increment when changing structure
+#define WEAR_RECORD_VERSION 1
 
 // Settings structure - keep this simple and avoid complex types
 struct Settings {
@@ -21,6 +29,14 @@ struct Settings {
     uint8_t checksum;             // Simple checksum for validation
 };
 
+// Boot cache - hardware probe results remembered between boots so a
+// restart can skip bus scans (kept separate from user settings)
+struct BootCache {
+    uint8_t version;              // Boot cache version for compatibility
+    uint8_t lcdAddress;           // I2C address of the LCD backpack (0 = none found)
+    uint8_t checksum;             // Simple checksum for validation
+};
+
 class SettingsManager {
 public:
     // Initialize settings manager
@@ -38,9 +54,14 @@ public:
     // Validate settings values
     static bool validateSettings(const Settings& settings);
     
+    // Load/save cached hardware probe results
+    static bool loadBootCache(BootCache& cache);
+    static bool saveBootCache(const BootCache& cache);
+    
 private:
     // Calculate simple checksum
     static uint8_t calculateChecksum(const Settings& settings);
+    static uint8_t calculateChecksum(const BootCache& cache);
 };
 
 #endif
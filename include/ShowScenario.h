@@ -0,0 +1,50 @@
+#ifndef SHOW_SCENARIO_H
+#define SHOW_SCENARIO_H
+
+#include <Arduino.h>
+
+// Generated by host/scenario_compiler.cpp from host/scenarios/office_day.txt - edit the script, not this file
+const uint8_t SHOW_SCENARIO[] PROGMEM = {
+    'S', 1, 113, 0,           // Header: version 1, 113 bytes of code
+    0x10, 0x03,               //   0: lines 3 (line 8)
+    0x11, 0x02,               //   2: concurrent 2 (line 9)
+    0x12, 0x78, 0x00,         //   4: delay 120 (line 10)
+    0x20, 0x00, 0x03, 0x00,   //   7: call 1 rings 3 (line 11)
+    0x02, 0x2C, 0x01,         //  11: at 5:00 (line 14)
+    0x10, 0x05,               //  14: lines 5 (line 15)
+    0x12, 0x3C, 0x00,         //  16: delay 60 (line 16)
+    0x02, 0x2C, 0x01,         //  19: at 10:00 (line 19)
+    0x10, 0x08,               //  22: lines 8 (line 20)
+    0x11, 0x06,               //  24: concurrent 6 (line 21)
+    0x13, 0xDC, 0x05,         //  26: rate 1500 (line 22)
+    0x20, 0x01, 0x06, 0x00,   //  29: call 2 rings 6 (line 23)
+    0x20, 0x04, 0x06, 0x00,   //  33: call 5 rings 6 (line 24)
+    0x02, 0x84, 0x03,         //  37: at 25:00 (line 25)
+    0x13, 0x84, 0x03,         //  40: rate 900 (line 26)
+    0x02, 0x2C, 0x01,         //  43: at 30:00 (line 29)
+    0x13, 0x00, 0x00,         //  46: rate off (line 30)
+    0x10, 0x02,               //  49: lines 2 (line 31)
+    0x11, 0x01,               //  51: concurrent 1 (line 32)
+    0x12, 0x2C, 0x01,         //  53: delay 300 (line 33)
+    0x02, 0x58, 0x02,         //  56: at 40:00 (line 34)
+    0x10, 0x06,               //  59: lines 6 (line 35)
+    0x11, 0x04,               //  61: concurrent 4 (line 36)
+    0x12, 0x2D, 0x00,         //  63: delay 45 (line 37)
+    0x02, 0xD0, 0x02,         //  66: at 52:00 (line 40)
+    0x10, 0x08,               //  69: lines 8 (line 41)
+    0x11, 0x08,               //  71: concurrent 8 (line 42)
+    0x13, 0xB8, 0x0B,         //  73: rate 3000 (line 43)
+    0x20, 0x00, 0x08, 0x00,   //  76: call 1 rings 8 (line 44)
+    0x20, 0x01, 0x08, 0x00,   //  80: call 2 rings 8 (line 45)
+    0x20, 0x02, 0x08, 0x00,   //  84: call 3 rings 8 (line 46)
+    0x20, 0x03, 0x08, 0x00,   //  88: call 4 rings 8 (line 47)
+    0x02, 0xB4, 0x00,         //  92: at 55:00 (line 48)
+    0x20, 0x07, 0x04, 0x03,   //  95: call 8 rings 4 short uk (line 49)
+    0x02, 0xB4, 0x00,         //  99: at 58:00 (line 50)
+    0x13, 0x00, 0x00,         // 102: rate off (line 51)
+    0x21, 0xFF,               // 105: hangup all (line 52)
+    0x02, 0x78, 0x00,         // 107: at 60:00 (line 55)
+    0x30, 0x00, 0x00,         // 110: jump top_of_day (line 56)
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef STRESS_TEST_H
+#define STRESS_TEST_H
+
+#include <Arduino.h>
+#include "EncoderManager.h"
+
+// Acceptance benchmark - measurements and the scripted input for a fixed run.
+//
+// While a run is going the sketch keeps every line in a call, redraws the
+// LCD as fast as its task allows and feeds the encoder script below through
+// the real input handling. This class records what that costs: the spread of
+// loop() periods, the LCD time per redraw and how deep the stack got. Relay
+// edge lateness and task overruns come from RelayEdgeEngine and
+// TaskScheduler, whose stats are reset when the run starts.
+class StressTest {
+public:
+    static const unsigned long DEFAULT_DURATION = 60000;   // 1 minute run
+    static const unsigned long INPUT_INTERVAL = 40;        // Scripted detent every 40ms (a fast spin)
+    static const uint8_t PERIOD_BUCKETS = 8;
+
+    // Pass limits
+    static const unsigned long MAX_EDGE_LATENESS = 1000;   // us - a ring edge a millisecond late is audible
+    static const uint16_t MIN_FREE_STACK = 128;            // bytes never touched between heap and stack
+
+    StressTest();
+
+    // Start a run - paints the free RAM so the deepest stack use can be found afterwards
+    void start(unsigned long now, unsigned long duration = DEFAULT_DURATION);
+    void stop();
+    bool isRunning() const;
+    bool isFinished(unsigned long now) const;
+
+    // Call once per loop() pass while running
+    void recordLoop(unsigned long nowMicros);
+
+    // Time spent on one LCD redraw
+    void recordLcd(unsigned long lcdMicros);
+
+    // Next scripted encoder event: open the menu, scroll to the last item and
+    // back and to it again, then press it (Exit) - menuItemCount sets the scroll length
+    EncoderManager::EncoderEvent nextInput(uint8_t menuItemCount);
+
+    // Results - call after stop(); edge lateness and overruns are passed in by the sketch
+    bool passed(unsigned long edgeLatenessMicros) const;
+    uint16_t getFreeStack() const;
+    void printReport(unsigned long edgeLatenessMicros, uint16_t overruns) const;
+
+    // Four 20-character summary lines for the LCD
+    void formatSummary(char lines[4][21], unsigned long edgeLatenessMicros, uint16_t overruns) const;
+
+private:
+    bool running;
+    unsigned long startTime;
+    unsigned long duration;
+    unsigned long elapsed;              // Run length, set by stop()
+
+    // Loop period distribution - bucket i counts periods below PERIOD_LIMITS[i], the last the rest
+    static const uint16_t PERIOD_LIMITS[PERIOD_BUCKETS - 1];
+    unsigned long periodCounts[PERIOD_BUCKETS];
+    unsigned long lastLoopMicros;
+    unsigned long loopCount;
+    unsigned long maxPeriod;
+
+    unsigned long lcdFrames;
+    unsigned long lcdTotalMicros;
+    unsigned long lcdMaxMicros;
+
+    uint8_t inputStep;
+    uint16_t freeStack;                 // Measured by stop()
+
+    static void paintStack();
+    static uint16_t measureStack();
+};
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef STRING_UTILS_H
 #define STRING_UTILS_H
 
+#include <stdint.h>
+
 // Global shared buffer for temporary string operations
 // Safe to use since Arduino is single-threaded
 extern char globalStringBuffer[21];  // 20 chars + null terminator
@@ -11,4 +13,40 @@ void padStringToGlobalBuffer(const char* str, int length = 20);
 // Helper function to center-justify a string in a buffer
 void centerStringToGlobalBuffer(const char* str, int length = 20);
 
+// Leading spaces that center a string literal on a 20 character line,
+// worked out by the compiler. CENTERED() passes the literal and its offset.
+#define CENTER_OFFSET(literal) ((20 - (int)(sizeof(literal) - 1)) / 2)
+#define CENTERED(literal) literal, CENTER_OFFSET(literal)
+
+// printf-free line formatting - the display only needs short decimal
+// fields, and vfprintf alone costs well over a kilobyte of AVR flash.
+// Appends to the caller's buffer and keeps it terminated; whatever does
+// not fit is dropped, as snprintf would.
+class LineWriter {
+public:
+    LineWriter(char* buffer, uint8_t size);     // size includes the terminator
+    
+    void text(const char* str);
+    void character(char c);
+    void spaces(uint8_t count);
+    
+    // Decimal in as few digits as needed
+    void number(long value);
+    
+    // Decimal right-aligned in width digits: fill '0' gives "07", ' ' gives " 7"
+    void paddedNumber(unsigned long value, uint8_t width, char fill = '0');
+    
+    // Spaces up to width characters in total
+    void padTo(uint8_t width);
+    
+    uint8_t length() const;
+    
+private:
+    char* buffer;
+    uint8_t size;
+    uint8_t used;
+    
+    void digits(unsigned long value, uint8_t width, char fill);
+};
+
 #endif
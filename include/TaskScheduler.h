@@ -0,0 +1,63 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+
+// A task runs with the frame timestamp and returns how many milliseconds
+// until it wants to run again (0 = next frame)
+typedef unsigned long (*TaskFunction)(unsigned long now);
+
+// Protothread-style helpers for tasks that run as a sequence of steps.
+// TASK_DELAY() returns to the scheduler and resumes on the following line
+// once the delay has passed. Locals are NOT preserved across a delay - keep
+// state in statics or globals. Only one TASK_BEGIN()/TASK_END() per function.
+#define TASK_BEGIN() static uint16_t taskResumeLine = 0; switch (taskResumeLine) { case 0:
+#define TASK_DELAY(ms) do { taskResumeLine = __LINE__; return (ms); case __LINE__:; } while (0)
+#define TASK_END() } taskResumeLine = 0; return 0
+
+// Static cooperative scheduler - every task gets the rate it asks for,
+// all tasks in a frame share one clock reading
+class TaskScheduler {
+public:
+    static const uint8_t MAX_TASKS = 8;
+    static const int8_t INVALID_TASK = -1;
+    
+    TaskScheduler();
+    
+    // Register a task, first run after initialDelay ms. Returns the task id.
+    int8_t addTask(const __FlashStringHelper* name, TaskFunction function, unsigned long initialDelay = 0);
+    
+    // Run every task that is due - call from loop()
+    void run();
+    
+    // Make a sleeping task run on the next frame (its deadline moved earlier)
+    void wakeTask(int8_t taskId);
+    
+    // Timestamp shared by all tasks in the current frame
+    unsigned long getFrameTime() const;
+    
+    // Overrun accounting
+    uint16_t getOverrunCount(int8_t taskId) const;
+    uint16_t getTotalOverruns() const;
+    void resetStats();
+    void printStatus() const;
+
+private:
+    struct Task {
+        const __FlashStringHelper* name;
+        TaskFunction function;
+        unsigned long lastRun;      // When the current wait started (or the task was woken)
+        unsigned long interval;     // Wait requested by the task
+        uint16_t overruns;          // Started a full interval late, or ran longer than its interval
+        uint16_t maxLateness;       // Worst start delay past the deadline (ms)
+        uint16_t maxRunTime;        // Worst single run (us, saturates)
+        unsigned long runCount;
+    };
+    
+    Task tasks[MAX_TASKS];
+    uint8_t taskCount;
+    unsigned long frameTime;
+    unsigned long frameCount;
+};
+
+#endif
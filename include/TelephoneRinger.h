@@ -2,6 +2,9 @@
 #define TELEPHONE_RINGER_H
 
 #include <Arduino.h>
+#include "FastRandom.h"
+#include "RelayEdgeEngine.h"
+#include "VirtualClock.h"
 
 // Forward declaration
 struct SystemConfig;
@@ -9,22 +12,49 @@ struct SystemConfig;
 // External reference to global call frequency setting
 extern int maxCallDelaySetting;
 
-// Callback function type for checking if a new call can start
-typedef bool (*CanStartCallCallback)();
-
 class TelephoneRinger {
 public:
+    // What happened during step() that the owner has to act on
+    enum StepEvent {
+        EVENT_NONE,
+        EVENT_CALL_REQUEST,  // Wait expired - line is queued and wants a concurrent call slot
+        EVENT_RING_ON,       // Next ring of the call started
+        EVENT_RING_OFF,      // A ring finished
+        EVENT_CALL_ENDED     // Call finished - its slot is free again
+    };
+    
     // Constructor
     TelephoneRinger();
     
     // Initialize with relay pin and configuration
     void initialize(int relayPin, const SystemConfig* config, bool enableSerialOutput = true);
     
-    // Set callback for checking if new calls are allowed
-    void setCanStartCallCallback(CanStartCallCallback callback);
+    // Seed this line's private random stream (stream = line index)
+    void seedRandom(uint32_t seed, uint8_t stream);
+    
+    // Auto call = line schedules its own calls; off = only starts when told to
+    void setAutoCall(bool enabled);
+    
+    // Hardware edges: ring on/off transitions are switched by RelayEdgeEngine at
+    // their exact tick instead of whenever step() gets to them
+    void setHardwareEdges(bool enabled);
+    
+    // Clock that call starts, stops and waits are measured on (nullptr = millis()).
+    // step() and getTimeToNextEvent() must be given times from the same clock.
+    void setClock(const VirtualClock* clock);
+    
+    // Move the line to another relay - only while the line is idle
+    void setRelayPin(int pin);
+    
+    // Re-drive the relay to match the current state after something else
+    // (pause) forced it off or cancelled its edges
+    void resyncRelay(unsigned long currentTime);
     
     // Step the state machine with current time
-    void step(unsigned long currentTime);
+    StepEvent step(unsigned long currentTime);
+    
+    // Hold the line until the owner grants it a slot with startCall()
+    void queueCall();
     
     // Start a new call sequence
     void startCall();
@@ -32,6 +62,10 @@ public:
     // Start a call with specific parameters
     void startCall(int ringCount, bool cutShort = false, bool useUKStyle = false);
     
+    // startCall() as of currentTime - for an owner starting it part way through
+    // a pass that steps every line at the same time
+    void startCallAt(unsigned long currentTime);
+    
     // Stop the current call
     void stopCall();
     
@@ -41,6 +75,18 @@ public:
     // Check if currently in a call sequence
     bool isActive() const;
     
+    // Check if waiting for a concurrent call slot
+    bool isQueued() const;
+    
+    // Rings the current (or last) call has started, and whether its last ring
+    // is cut short - i.e. the call counts as answered if it runs to the end
+    uint8_t getRingCount() const;
+    bool isCutShort() const;
+    
+    // Milliseconds until step() has something to do (NO_DEADLINE if only an owner can wake it)
+    unsigned long getTimeToNextEvent(unsigned long currentTime) const;
+    static const unsigned long NO_DEADLINE = 0xFFFFFFFFUL;
+    
     // Note: getStateString() removed for heap safety
 
 private:
@@ -49,32 +95,52 @@ private:
         RING_ON,        // Ring tone is on
         RING_OFF,       // Ring tone is off (between rings)
         CALL_ANSWERED,  // Call answered (hanging up)
-        WAITING         // Waiting before next call attempt
+        WAITING,        // Waiting before next call attempt
+        QUEUED          // Waiting for a concurrent call slot
+    };
+    
+    // Everything a call needs, decided once in startCall() so step() only
+    // has to compare elapsed time against the current state's duration
+    struct RingPlan {
+        uint8_t ringCount;            // Total rings in this call
+        bool finalRingCutShort;       // Last ring "answered" part way through
+        uint16_t ringOnDuration;      // Full ring length (ms)
+        uint16_t ringOffDuration;     // Silence between rings (ms)
+        uint16_t finalRingDuration;   // Last ring length, shorter when cut short (ms)
     };
     
     // State variables
     RingerState state;
     int relayPin;
     unsigned long lastStateChange;
+    unsigned long stateDuration;  // How long the current state lasts
     int currentRingCount;
-    int totalRingsToMake;
-    bool finalRingCutShort;
     bool useUKRingStyle;
-    unsigned long waitDuration;
+    bool autoCall;            // Schedule own calls (false = driven by RingerManager)
+    bool useEdgeEngine;       // Relay switched by RelayEdgeEngine rather than step()
+    uint32_t nextEdgeTime;    // Timer1 tick of the edge that ends the current state
     bool enableSerialOutput;  // Flag to control serial output
+    RingPlan plan;            // Plan for the call in progress
     
     // Configuration reference
     const SystemConfig* systemConfig;
+    const VirtualClock* clock;
     
-    // Callback for checking if new calls are allowed
-    CanStartCallCallback canStartCallCallback;
+    // Per-line random stream
+    FastRandom rng;
     
-    // Current timing values (may vary based on ring style)
-    unsigned long currentRingOnDuration;
-    unsigned long currentRingOffDuration;
+    // Timing constants
+    static const uint16_t DEFAULT_RING_ON_DURATION = 2000;   // 2 seconds
+    static const uint16_t DEFAULT_RING_OFF_DURATION = 4000;  // 4 seconds
+    static const unsigned long CALL_END_PAUSE = 1000;        // Pause after a call before waiting
     
     // Helper methods
+    void compilePlan(int ringCount, bool cutShort);
+    void beginCall(unsigned long currentTime);
+    unsigned long now() const;
+    unsigned long getRingDuration() const;
     void setRelayState(bool active);
+    unsigned long scheduleStateEndEdge(unsigned long currentTime, unsigned long duration);
     unsigned long getRandomWaitTime();
     // Note: debugPrint(String) removed for heap safety
 };
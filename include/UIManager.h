@@ -2,119 +2,87 @@
 #define UI_MANAGER_H
 
 #include <Arduino.h>
-#include "Config.h"
+#include "EncoderManager.h"
 
 // Forward declarations
-class ConfigManager;
-class RingerManager;
-class PatternManager;
+class DisplayManager;
 
-// UI input types
-enum UIInput {
-    UI_NONE = 0,
-    UI_ENCODER_CW,          // Encoder clockwise
-    UI_ENCODER_CCW,         // Encoder counter-clockwise
-    UI_ENCODER_PRESS,       // Encoder button press
-    UI_ENCODER_LONG_PRESS   // Encoder long press
-};
+// Writes a setting's value as shown on the LCD ("4", "30s")
+typedef void (*MenuFormatter)(char* buffer, uint8_t size, int value);
+
+// Runs after a setting changes, or when an action item is selected
+typedef void (*MenuHook)();
 
-// UI states/screens
-enum UIScreen {
-    SCREEN_STATUS = 0,      // Main status display
-    SCREEN_MENU,            // Main menu
-    SCREEN_RELAY_COUNT,     // Set number of active relays
-    SCREEN_PATTERN_MODE,    // Select pattern mode
-    SCREEN_RING_STYLE,      // Select ring style
-    SCREEN_MAX_RINGS,       // Set max rings per call
-    SCREEN_SIMULTANEOUS,    // Set max simultaneous rings
-    SCREEN_TIMING,          // Timing settings
-    SCREEN_ADVANCED,        // Advanced settings
-    SCREEN_ABOUT            // About/info screen
+// One menu entry. Menus are tables of these in PROGMEM, read an item at a
+// time, so adding a setting is one table row instead of more switch cases.
+struct MenuItem {
+    const char* label;      // PROGMEM - item name, and the title while adjusting
+    const char* hint;       // PROGMEM - turn instructions while adjusting
+    int* value;             // Setting this item edits (nullptr = action item)
+    int16_t minValue;
+    int16_t maxValue;
+    int16_t step;
+    MenuFormatter format;   // nullptr = plain number
+    MenuHook onChange;      // After each change, or on press for an action item
 };
 
+// Settings menu driven by a MenuItem table.
+//
+// Turning the encoder moves between items, pressing an item adjusts it,
+// pressing again saves and goes back. Each detent rewrites only the field
+// that changed (item name or value), full screens are drawn only when
+// switching between the item list and a setting.
 class UIManager {
 public:
     UIManager();
     
-    // Initialize with hardware pins and references
-    void initialize(int encoderPinA, int encoderPinB, int encoderButton,
-                   ConfigManager* configMgr, RingerManager* ringerMgr, 
-                   PatternManager* patternMgr);
-    
-    // Main update loop
-    void step(unsigned long currentTime);
-    
-    // Input handling
-    UIInput checkInput();
-    void handleInput(UIInput input);
+    // items points at a PROGMEM table; onSave runs when an adjusted value is confirmed
+    void initialize(DisplayManager* display, const MenuItem* items, uint8_t itemCount, MenuHook onSave);
     
-    // Display management
-    void updateDisplay();
-    void setDisplayBrightness(uint8_t brightness);
-    void wakeDisplay();
+    void open();    // Show the item list, starting at the first item
+    void close();   // Leave the menu (caller redraws the status screen)
+    bool isOpen() const;
+    bool isAdjusting() const;
+    uint8_t getCurrentItem() const;
     
-    // Menu navigation
-    void enterMenu();
-    void exitMenu();
-    void navigateMenu(int direction);
-    void selectMenuItem();
+    // Handle an encoder event while the menu is open. Returns false if the
+    // event isn't one the menu uses (or the menu is closed).
+    // stepMultiplier comes from the encoder's acceleration and only applies
+    // to settings with a large range.
+    bool handleEvent(EncoderManager::EncoderEvent event, uint8_t stepMultiplier = 1);
     
-    // Screen management
-    void setScreen(UIScreen screen);
-    UIScreen getCurrentScreen() const { return currentScreen; }
-    
-    // Get display strings for current screen
-    String getDisplayLine1() const;
-    String getDisplayLine2() const;
+    // Formatter for settings in seconds
+    static void formatSeconds(char* buffer, uint8_t size, int value);
     
+    // Formatter for 0/1 switches
+    static void formatOnOff(char* buffer, uint8_t size, int value);
+
 private:
-    // Hardware references
-    int encoderA, encoderB, encoderBtn;
-    ConfigManager* configManager;
-    RingerManager* ringerManager;
-    PatternManager* patternManager;
-    
-    // UI state
-    UIScreen currentScreen;
-    uint8_t menuIndex;
-    uint8_t subMenuIndex;
-    bool inMenu;
-    bool settingValue;
-    
-    // Input handling
-    int lastEncoderA, lastEncoderB;
-    bool lastButtonState;
-    unsigned long buttonPressTime;
-    unsigned long lastInputTime;
-    
-    // Display state
-    bool displayActive;
-    unsigned long lastDisplayUpdate;
-    uint8_t currentBrightness;
-    
-    // Menu definitions
-    static const char* MAIN_MENU_ITEMS[];
-    static const uint8_t MAIN_MENU_COUNT;
-    
-    // Screen handlers
-    void handleStatusScreen(UIInput input);
-    void handleMenuScreen(UIInput input);
-    void handleSettingScreen(UIInput input);
-    
-    // Display helpers
-    String formatStatusLine1() const;
-    String formatStatusLine2() const;
-    String formatMenuLine(uint8_t index) const;
-    String formatSettingValue(UIScreen screen) const;
-    
-    // Input helpers
-    bool readEncoder(int& direction);
-    bool readButton(bool& longPress);
-    void debounceInputs();
-    
-    // Value adjustment helpers
-    void adjustCurrentSetting(int direction);
-    void saveCurrentSetting();
+    DisplayManager* display;
+    const MenuItem* items;
+    uint8_t itemCount;
+    MenuHook onSave;
+    
+    bool menuOpen;
+    bool adjusting;
+    uint8_t currentItem;
+    
+    // Screen layout
+    static const uint8_t NAME_ROW = 1;
+    static const uint8_t VALUE_ROW = 1;
+    static const uint8_t VALUE_COLUMN = 9;      // After "Setting: "
+    static const uint8_t LINE_LENGTH = 20;
+    
+    // Settings with fewer steps than this ignore acceleration (1-8 needs precision, not speed)
+    static const uint8_t ACCELERATION_MIN_STEPS = 20;
+    
+    void loadItem(uint8_t index, MenuItem& item) const;
+    void drawItemList();
+    void drawItemName();
+    void drawSetting();
+    void drawValue(const MenuItem& item);
+    void formatValue(const MenuItem& item, char* buffer, uint8_t size) const;
+    void adjust(int8_t direction, uint8_t stepMultiplier);
 };
 
 #endif
@@ -0,0 +1,32 @@
+#ifndef VIRTUAL_CLOCK_H
+#define VIRTUAL_CLOCK_H
+
+#include <Arduino.h>
+
+// millis() with the paused time taken out.
+//
+// While paused the clock stands still; on resume it carries on from where
+// it stopped, so every deadline measured against it keeps the time it had
+// left instead of expiring all at once.
+class VirtualClock {
+public:
+    VirtualClock();
+    
+    // Virtual time for a millis() reading (frozen at the pause while paused)
+    unsigned long toVirtual(unsigned long realTime) const;
+    unsigned long now() const;
+    
+    void pause(unsigned long realTime);
+    void resume(unsigned long realTime);
+    bool isPaused() const;
+    
+    // Real milliseconds spent paused so far (not counting a pause in progress)
+    unsigned long getPausedTotal() const;
+    
+private:
+    unsigned long pausedTotal;
+    unsigned long pausedAt;
+    bool paused;
+};
+
+#endif
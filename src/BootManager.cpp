@@ -0,0 +1,88 @@
+#include "BootManager.h"
+
+#ifdef ARDUINO
+// Optiboot hands the original MCUSR value over in r2 before it clears the
+// register, so grab it before the C runtime has a chance to reuse r2
+uint8_t bootloaderResetFlags __attribute__ ((section(".noinit")));
+void saveBootloaderResetFlags(void) __attribute__ ((naked)) __attribute__ ((used)) __attribute__ ((section(".init0")));
+void saveBootloaderResetFlags(void) {
+    __asm__ __volatile__ ("sts %0, r2\n" : "=m" (bootloaderResetFlags) :);
+}
+#else
+// Host build - no bootloader, the reset cause is whatever was put in MCUSR
+static const uint8_t bootloaderResetFlags = 0;
+#endif
+
+uint8_t BootManager::resetFlags = 0;
+unsigned long BootManager::readyTime = 0;
+
+void BootManager::captureResetCause() {
+    // Older bootloaders leave the flags in MCUSR, newer ones pass them in r2
+    resetFlags = MCUSR | bootloaderResetFlags;
+    MCUSR = 0;
+}
+
+BootManager::ResetCause BootManager::getResetCause() {
+    // Check in priority order - a brown-out during power-up can set several flags
+    if (resetFlags & (1 << PORF)) {
+        return RESET_POWER_ON;
+    }
+    if (resetFlags & (1 << BORF)) {
+        return RESET_BROWNOUT;
+    }
+    if (resetFlags & (1 << WDRF)) {
+        return RESET_WATCHDOG;
+    }
+    if (resetFlags & (1 << EXTRF)) {
+        return RESET_EXTERNAL;
+    }
+    return RESET_UNKNOWN;
+}
+
+bool BootManager::isWarmBoot() {
+    // Unknown causes are treated as cold so the relays still get tested
+    ResetCause cause = getResetCause();
+    return cause != RESET_POWER_ON && cause != RESET_UNKNOWN;
+}
+
+void BootManager::runRelaySelfTest(const int* relayPins, int numPins) {
+    if (numPins <= 0) return;
+    
+    // Relay i is on from i*STAGGER to i*STAGGER+ON_TIME, so at most
+    // ON_TIME/STAGGER coils are energized at once (ringer power is still off)
+    unsigned long totalTime = RELAY_TEST_STAGGER * (numPins - 1) + RELAY_TEST_ON_TIME;
+    unsigned long startTime = millis();
+    unsigned long elapsed = 0;
+    
+    while (elapsed < totalTime) {
+        for (int i = 0; i < numPins; i++) {
+            unsigned long onTime = RELAY_TEST_STAGGER * i;
+            bool active = elapsed >= onTime && elapsed < onTime + RELAY_TEST_ON_TIME;
+            digitalWrite(relayPins[i], active ? LOW : HIGH);  // LOW = active for active-LOW modules
+        }
+        elapsed = millis() - startTime;
+    }
+    
+    // Make sure everything ends de-energized
+    for (int i = 0; i < numPins; i++) {
+        digitalWrite(relayPins[i], HIGH);
+    }
+}
+
+void BootManager::markReady() {
+    readyTime = millis();
+}
+
+unsigned long BootManager::getBootTime() {
+    return readyTime;
+}
+
+const char* BootManager::getResetCauseString() {
+    switch (getResetCause()) {
+        case RESET_POWER_ON: return "power-on";
+        case RESET_EXTERNAL: return "external";
+        case RESET_BROWNOUT: return "brown-out";
+        case RESET_WATCHDOG: return "watchdog";
+        default: return "unknown";
+    }
+}
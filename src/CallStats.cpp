@@ -0,0 +1,350 @@
+#include "CallStats.h"
+#include "Features.h"
+#include "StringUtils.h"
+
+// Lines set in a mask
+static uint8_t countBits(uint8_t mask) {
+    uint8_t count = 0;
+    for (; mask; mask &= mask - 1) {
+        count++;
+    }
+    return count;
+}
+
+CallStats::CallStats() {
+    reset(0);
+}
+
+void CallStats::reset(unsigned long now) {
+    startTime = now;
+    lastReport = now;
+    unitRemainder = 0;
+    calls = 0;
+    rings = 0;
+    endedCalls = 0;
+    answeredCalls = 0;
+    callGap = 0;
+    callGapAverage = 0;
+    ringsPerCallAverage = 0;
+    answerAverage = 0;
+    for (uint8_t i = 0; i < MAX_LINES; i++) {
+        ringTicks[i] = 0;
+    }
+    ringRemainder = 0;
+    ringingLines = 0;
+    for (uint8_t i = 0; i < LEVELS; i++) {
+        concurrencyTicks[i] = 0;
+    }
+    levelRemainder = 0;
+    activeLines = 0;
+    level = 0;
+}
+
+void CallStats::callStarted(uint8_t line, unsigned long now) {
+    if (line >= MAX_LINES) {
+        return;
+    }
+    advance(now);
+    unsigned long gap = (unsigned long)callGap << UNIT_SHIFT;
+    callGap = 0;
+    if (calls == 1) {
+        callGapAverage = gap;
+    } else if (calls > 1) {
+        callGapAverage = callGapAverage - (callGapAverage >> 4) + (gap >> 4);
+    }
+    if (calls < 0xFFFF) {
+        calls++;
+    }
+
+    // A line restarted mid-call is a new call but not another concurrent one
+    uint8_t bit = 1 << line;
+    if (!(activeLines & bit)) {
+        activeLines |= bit;
+        level++;
+    }
+}
+
+void CallStats::ringOn(uint8_t line, unsigned long now) {
+    uint8_t bit = 1 << line;
+    if (line >= MAX_LINES || (ringingLines & bit)) {
+        return;
+    }
+    advance(now);
+    if (rings < 0xFFFF) {
+        rings++;
+    }
+    ringingLines |= bit;
+}
+
+void CallStats::ringOff(uint8_t line, unsigned long now) {
+    uint8_t bit = 1 << line;
+    if (line >= MAX_LINES || !(ringingLines & bit)) {
+        return;
+    }
+    advance(now);
+    ringingLines &= ~bit;
+}
+
+void CallStats::callEnded(uint8_t line, uint8_t ringCount, bool answered, unsigned long now) {
+    uint8_t bit = 1 << line;
+    if (line >= MAX_LINES || !(activeLines & bit)) {
+        return;
+    }
+    advance(now);
+    ringingLines &= ~bit;
+
+    uint16_t ringsFixed = (uint16_t)ringCount << 8;
+    uint16_t answerFixed = answered ? 0x8000 : 0;
+    if (endedCalls == 0) {
+        ringsPerCallAverage = ringsFixed;
+        answerAverage = answerFixed;
+    } else {
+        ringsPerCallAverage = ringsPerCallAverage - (ringsPerCallAverage >> 4) + (ringsFixed >> 4);
+        answerAverage = answerAverage - (answerAverage >> 4) + (answerFixed >> 4);
+    }
+    if (endedCalls == 0xFFFF) {
+        endedCalls >>= 1;
+        answeredCalls >>= 1;
+    }
+    endedCalls++;
+    if (answered) {
+        answeredCalls++;
+    }
+
+    activeLines &= ~bit;
+    level--;
+}
+
+// Credit the time since the last report to the open call gap, the level
+// that held and the lines that rang during it
+void CallStats::advance(unsigned long now) {
+    unsigned long elapsed = now - lastReport + unitRemainder;
+    lastReport = now;
+    unitRemainder = elapsed & ((1 << UNIT_SHIFT) - 1);
+    unsigned long units = elapsed >> UNIT_SHIFT;
+    if (units == 0) {
+        return;
+    }
+    callGap = min(callGap + units, 0xFFFFUL);
+    accountLevel(units);
+    accountRings(units);
+}
+
+void CallStats::accountLevel(unsigned long units) {
+    units += levelRemainder;
+    levelRemainder = units & (TICK_UNITS - 1);
+    unsigned long ticks = units >> TICK_SHIFT;
+
+    while (concurrencyTicks[level] + ticks > 0xFFFF) {
+        for (uint8_t i = 0; i < LEVELS; i++) {
+            concurrencyTicks[i] >>= 1;
+        }
+        ticks >>= 1;
+    }
+    concurrencyTicks[level] += ticks;
+}
+
+// Every ringing line gets an equal share of the line-time, whole ticks only
+void CallStats::accountRings(unsigned long units) {
+    uint8_t count = countBits(ringingLines);
+    if (count == 0) {
+        return;
+    }
+    unsigned long lineUnits = units * count + ringRemainder;
+    unsigned long ticks = lineUnits / (TICK_UNITS * count);
+    ringRemainder = lineUnits - ticks * TICK_UNITS * count;
+    for (uint8_t i = 0; i < MAX_LINES; i++) {
+        if (ringingLines & (1 << i)) {
+            ringTicks[i] += ticks;
+        }
+    }
+}
+
+// Whole units since the last report, not yet credited anywhere
+unsigned long CallStats::pendingUnits(unsigned long now) const {
+    return (now - lastReport + unitRemainder) >> UNIT_SHIFT;
+}
+
+uint16_t CallStats::getCallCount() const {
+    return calls;
+}
+
+uint16_t CallStats::getRingCount() const {
+    return rings;
+}
+
+uint16_t CallStats::getCallsPerHour(unsigned long now) const {
+    if (calls < 2) {
+        return 0;
+    }
+    // A gap still open longer than the average pulls the rate down as it grows
+    unsigned long open = (callGap + pendingUnits(now)) << UNIT_SHIFT;
+    unsigned long gap = max(callGapAverage, open);
+    return 3600000UL / max(gap, 1UL);
+}
+
+uint16_t CallStats::getRingsPerCallX10() const {
+    return ((unsigned long)ringsPerCallAverage * 10 + 128) >> 8;
+}
+
+uint8_t CallStats::getAnswerPercent() const {
+    return ((unsigned long)answerAverage * 100 + 0x4000) >> 15;
+}
+
+unsigned long CallStats::getRingSeconds(uint8_t line, unsigned long now) const {
+    if (line >= MAX_LINES) {
+        return 0;
+    }
+    // A tick is 1.024 s; scaled this way it won't overflow for decades
+    unsigned long ticks = ringTicksAt(line, now);
+    return ticks + ticks * 3 / 125;
+}
+
+// Line's ticks plus its share of the time since the last report
+unsigned long CallStats::ringTicksAt(uint8_t line, unsigned long now) const {
+    unsigned long ticks = ringTicks[line];
+    if (ringingLines & (1 << line)) {
+        uint8_t count = countBits(ringingLines);
+        ticks += (pendingUnits(now) * count + ringRemainder) / (TICK_UNITS * count);
+    }
+    return ticks;
+}
+
+// Histogram bin plus the time at the current level not yet credited
+unsigned long CallStats::ticksAt(uint8_t callLevel, unsigned long now) const {
+    unsigned long ticks = concurrencyTicks[callLevel];
+    if (callLevel == level) {
+        ticks += (pendingUnits(now) + levelRemainder) >> TICK_SHIFT;
+    }
+    return ticks;
+}
+
+unsigned long CallStats::totalTicks(unsigned long now) const {
+    unsigned long total = 0;
+    for (uint8_t i = 0; i < LEVELS; i++) {
+        total += ticksAt(i, now);
+    }
+    return total;
+}
+
+uint8_t CallStats::getConcurrencyPercent(uint8_t callLevel, unsigned long now) const {
+    unsigned long total = totalTicks(now);
+    if (callLevel >= LEVELS || total == 0) {
+        return 0;
+    }
+    return (ticksAt(callLevel, now) * 100 + total / 2) / total;
+}
+
+uint16_t CallStats::getMeanConcurrencyX10(unsigned long now) const {
+    unsigned long total = totalTicks(now);
+    if (total == 0) {
+        return 0;
+    }
+    unsigned long weighted = 0;
+    for (uint8_t i = 1; i < LEVELS; i++) {
+        weighted += ticksAt(i, now) * i;
+    }
+    return (weighted * 10 + total / 2) / total;
+}
+
+void CallStats::printReport(unsigned long now) const {
+    DebugSerial.print(F("Call stats over "));
+    DebugSerial.print((now - startTime) / 1000);
+    DebugSerial.println(F("s of line time"));
+
+    DebugSerial.print(F("  Calls: "));
+    DebugSerial.print(calls);
+    DebugSerial.print(F(" (now "));
+    DebugSerial.print(getCallsPerHour(now));
+    DebugSerial.print(F("/hour), rings: "));
+    DebugSerial.print(rings);
+    DebugSerial.print(F(" ("));
+    uint16_t perCall = getRingsPerCallX10();
+    DebugSerial.print(perCall / 10);
+    DebugSerial.print(F("."));
+    DebugSerial.print(perCall % 10);
+    DebugSerial.println(F("/call recently)"));
+
+    DebugSerial.print(F("  Answered: "));
+    DebugSerial.print(endedCalls ? ((unsigned long)answeredCalls * 100 + endedCalls / 2) / endedCalls : 0);
+    DebugSerial.print(F("% of finished calls (recently "));
+    DebugSerial.print(getAnswerPercent());
+    DebugSerial.println(F("%)"));
+
+    DebugSerial.print(F("  Ring seconds per line:"));
+    for (uint8_t i = 0; i < MAX_LINES; i++) {
+        DebugSerial.print(F(" "));
+        DebugSerial.print(getRingSeconds(i, now));
+    }
+    DebugSerial.println();
+
+    DebugSerial.print(F("  Time at concurrency:"));
+    for (uint8_t i = 0; i < LEVELS; i++) {
+        DebugSerial.print(F(" "));
+        DebugSerial.print(i);
+        DebugSerial.print(F(":"));
+        DebugSerial.print(getConcurrencyPercent(i, now));
+        DebugSerial.print(F("%"));
+    }
+    uint16_t mean = getMeanConcurrencyX10(now);
+    DebugSerial.print(F(", mean "));
+    DebugSerial.print(mean / 10);
+    DebugSerial.print(F("."));
+    DebugSerial.println(mean % 10);
+}
+
+void CallStats::formatPage(char lines[4][21], unsigned long now) const {
+    LineWriter line0(lines[0], 21);
+    line0.text("Calls ");
+    line0.number(calls);
+    line0.character(' ');
+    line0.number(getCallsPerHour(now));
+    line0.text("/h");
+
+    LineWriter line1(lines[1], 21);
+    uint16_t perCall = getRingsPerCallX10();
+    line1.text("Rings ");
+    line1.number(perCall / 10);
+    line1.character('.');
+    line1.number(perCall % 10);
+    line1.text(" Answer ");
+    line1.number(getAnswerPercent());
+    line1.character('%');
+
+    LineWriter line2(lines[2], 21);
+    uint16_t mean = getMeanConcurrencyX10(now);
+    line2.text("Conc ");
+    line2.number(mean / 10);
+    line2.character('.');
+    line2.number(mean % 10);
+    line2.text(" Idle ");
+    line2.number(getConcurrencyPercent(0, now));
+    line2.character('%');
+
+    // Total bell time and the line that did the biggest share of it
+    unsigned long total = 0;
+    unsigned long most = 0;
+    uint8_t busiest = 0;
+    for (uint8_t i = 0; i < MAX_LINES; i++) {
+        unsigned long seconds = getRingSeconds(i, now);
+        total += seconds;
+        if (seconds > most) {
+            most = seconds;
+            busiest = i;
+        }
+    }
+    LineWriter line3(lines[3], 21);
+    line3.text("Bell ");
+    if (total < 60000) {
+        line3.number(total / 60);
+        line3.character('m');
+    } else {
+        line3.number(total / 3600);
+        line3.character('h');
+    }
+    line3.text(" Top L");
+    line3.number(busiest + 1);
+    line3.character(' ');
+    line3.number(total ? (most * 100 + total / 2) / total : 0);
+    line3.character('%');
+}
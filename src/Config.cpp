@@ -1,3 +1,8 @@
+#include "Features.h"
+
+// Prototype settings store, superseded by SettingsManager - only built on request
+#if FEATURE_CONFIG_MANAGER
+
 #include "Config.h"
 #include <EEPROM.h>
 
@@ -192,3 +197,5 @@ void ConfigManager::getRingTiming(uint16_t& onDuration, uint16_t& offDuration, b
             break;
     }
 }
+
+#endif // FEATURE_CONFIG_MANAGER
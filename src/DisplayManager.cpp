@@ -1,14 +1,16 @@
 #include "DisplayManager.h"
 #include "RingerManager.h"
 #include "StringUtils.h"
+#include "Features.h"
+#include <new.h>
 
 // LCD geometry
 const int LCD_COLS = 20;
 const int LCD_ROWS = 4;
 
-// Update intervals
-const unsigned long NORMAL_UPDATE_INTERVAL = 500;  // 500ms when paused
-const unsigned long FAST_UPDATE_INTERVAL = 100;    // 100ms when active
+// Common PCF8574 backpack addresses
+const uint8_t LCD_ADDRESS_PRIMARY = 0x27;
+const uint8_t LCD_ADDRESS_ALTERNATE = 0x3F;
 
 // 🌪️ Custom character definitions for 4-frame storm animation (5x8 pixels)
 // Each byte represents a row, each bit a pixel (1=on, 0=off)
@@ -67,280 +69,321 @@ DisplayManager::DisplayManager() {
     lastUpdate = 0;
     currentScreen = 0;
     displayNeedsUpdate = true;
+    statusShown = false;
+    nextClockTick = 1000;
+    clockHours = 0;
+    clockMinutes = 0;
+    clockSeconds = 0;
+    enableSerialOutput = false;
+    lcd = &transport;
     lcdAvailable = false;  // Will be set to true if LCD initializes successfully
+    lcdAddress = 0;
+    frameCount = 0;
+    lastFrameMicros = 0;
+    maxFrameMicros = 0;
+    lastStatusPrint = 0;
     showingTempMessage = false;
     tempMessageStartTime = 0;
     tempMessageText[0] = '\0';
-    animationEnabled = true;
+    animationEnabled = Features::STORM_ANIMATION;
     lastAnimationUpdate = 0;
     currentAnimationFrame = 0;
+    for (uint8_t i = 0; i < ANIMATION_FRAME_COUNT; i++) {
+        stormGlyphs[i] = ' ';
+    }
 }
 
-void DisplayManager::initialize(bool enableSerialOutput) {
-    if (enableSerialOutput) {
-        Serial.println("Initializing 20x4 LCD Display...");
+void DisplayManager::initialize(bool enableSerialOutput, uint8_t cachedAddress) {
+    this->enableSerialOutput = enableSerialOutput;
+    // Headless build - no LCD code at all
+    if (!Features::LCD) {
+        lcdAvailable = false;
+        lcdAddress = 0;
+        return;
     }
     
-    // Add a timeout to prevent hanging if LCD is not connected
     if (enableSerialOutput) {
-        Serial.println("Scanning I2C bus for LCD...");
+        DebugSerial.println("Initializing 20x4 LCD Display...");
     }
     
-    // Try to initialize with a timeout approach
     int status = -1;
-    unsigned long startTime = millis();
-    const unsigned long INIT_TIMEOUT = 2000; // 2 second timeout
+    lcdAddress = 0;
+    Wire.begin();
     
-    // Attempt LCD initialization with timeout protection
-    bool initSuccess = false;
+    // Fast path: the address found last boot usually still answers
+    if (cachedAddress != 0 && probeI2CAddress(cachedAddress)) {
+        lcdAddress = cachedAddress;
+    } else {
+        if (enableSerialOutput) {
+            DebugSerial.println("Scanning I2C bus for LCD...");
+        }
+        // Try common address first, then the alternate
+        if (probeI2CAddress(LCD_ADDRESS_PRIMARY)) {
+            lcdAddress = LCD_ADDRESS_PRIMARY;
+        } else if (probeI2CAddress(LCD_ADDRESS_ALTERNATE)) {
+            lcdAddress = LCD_ADDRESS_ALTERNATE;
+        }
+    }
     
-    // First, try a simple I2C scan to see if anything responds
-    Wire.begin();
-    Wire.beginTransmission(0x27); // Try common address first
-    if (Wire.endTransmission() == 0) {
+    if (lcdAddress != 0) {
         if (enableSerialOutput) {
-            Serial.println("Found I2C device at 0x27");
+            DebugSerial.print("Found I2C device at 0x");
+            DebugSerial.println(lcdAddress, HEX);
         }
-        initSuccess = true;
-    } else {
-        Wire.beginTransmission(0x3F); // Try alternate address
-        if (Wire.endTransmission() == 0) {
+        
+        // begin() also picks the bus speed - 400 kHz if the expander keeps up
+        transport.setAddress(lcdAddress);
+        lcd = &transport;
+        status = lcd->begin(LCD_COLS, LCD_ROWS);
+        if (status == Lcd::RV_ENOTSUP) {
+            // Not the common PCF8574 wiring - let the library work out the
+            // pin map at the known address rather than scanning again
             if (enableSerialOutput) {
-                Serial.println("Found I2C device at 0x3F");
+                DebugSerial.println(F("Unrecognised backpack wiring, using hd44780_I2Cexp"));
             }
-            initSuccess = true;
+            genericLcd.~GenericLcd();
+            new (&genericLcd) GenericLcd(lcdAddress);
+            lcd = &genericLcd;
+            status = lcd->begin(LCD_COLS, LCD_ROWS);
         }
-    }
-    
-    if (initSuccess) {
-        status = lcd.begin(LCD_COLS, LCD_ROWS);
         if (status == 0) {
             lcdAvailable = true;  // Mark LCD as available
-            lcd.clear();
+            lcd->clear();
             
             // Initialize custom characters for storm animation
             initializeStormAnimation();
             
             showStartupMessage();
             if (enableSerialOutput) {
-                Serial.println("20x4 LCD Display initialized successfully");
-                Serial.println("Storm animation characters loaded");
+                DebugSerial.println("20x4 LCD Display initialized successfully");
+                DebugSerial.println("Storm animation characters loaded");
+                if (lcd == &transport) {
+                    DebugSerial.print("I2C clock: ");
+                    DebugSerial.print(transport.getClock() / 1000);
+                    DebugSerial.println(" kHz");
+                }
             }
         } else {
             if (enableSerialOutput) {
-                Serial.print("LCD initialization failed with status: ");
-                Serial.println(status);
-                Serial.println("Continuing without LCD...");
+                DebugSerial.print("LCD initialization failed with status: ");
+                DebugSerial.println(status);
+                DebugSerial.println("Continuing without LCD...");
             }
             lcdAvailable = false;
+            lcdAddress = 0;
         }
     } else {
         if (enableSerialOutput) {
-            Serial.println("No I2C LCD found at addresses 0x27 or 0x3F");
-            Serial.println("Continuing without LCD...");
+            DebugSerial.println("No I2C LCD found at addresses 0x27 or 0x3F");
+            DebugSerial.println("Continuing without LCD...");
         }
         lcdAvailable = false;
     }
 }
 
+uint8_t DisplayManager::getI2CAddress() const {
+    return lcdAddress;
+}
+
+bool DisplayManager::probeI2CAddress(uint8_t address) {
+    Wire.beginTransmission(address);
+    return Wire.endTransmission() == 0;
+}
+
 void DisplayManager::update(unsigned long currentTime, bool systemPaused, const RingerManager* ringerManager, int maxConcurrent) {
-    if (!lcdAvailable) return; // Skip if LCD not available
+    if (!lcdReady()) return; // Skip if LCD not available
     
     // Update storm animation (independent of display updates)
-    updateStormAnimation();
+    updateStormAnimation(currentTime);
     
-    // Determine update interval based on system state
-    unsigned long updateInterval = systemPaused ? NORMAL_UPDATE_INTERVAL : FAST_UPDATE_INTERVAL;
+    // Besides ringer events, the status screen changes when its clock ticks
+    // over or a temporary message runs out (the clock keeps counting while paused)
+    bool clockMoved = tickClock(currentTime);
+    if (!systemPaused) {
+        if (clockMoved) {
+            displayNeedsUpdate = true;
+        }
+        if (showingTempMessage && currentTime - tempMessageStartTime >= TEMP_MESSAGE_DURATION) {
+            displayNeedsUpdate = true;
+        }
+    }
     
-    if (currentTime - lastUpdate >= updateInterval || displayNeedsUpdate) {
+    if (displayNeedsUpdate) {
+        unsigned long frameStart = micros();
         if (systemPaused) {
             showPauseMessage();
         } else {
             showStatus(ringerManager, false, maxConcurrent);
         }
+        lastFrameMicros = micros() - frameStart;
+        maxFrameMicros = max(maxFrameMicros, lastFrameMicros);
+        frameCount++;
         
         lastUpdate = currentTime;
         displayNeedsUpdate = false;
     }
+    
+    // Periodically print status only if serial output is enabled
+    if (enableSerialOutput && currentTime - lastStatusPrint >= STATUS_PRINT_INTERVAL) {
+        printStatus();
+        lastStatusPrint = currentTime;
+    }
+}
+
+void DisplayManager::invalidate() {
+    displayNeedsUpdate = true;
 }
 
 void DisplayManager::setBrightness(uint8_t brightness) {
-    if (!lcdAvailable) return; // Skip if LCD not available
+    if (!lcdReady()) return; // Skip if LCD not available
     
-    // hd44780_I2Cexp automatically manages backlight
-    // Just turn on/off based on brightness value
+    // The expander only switches the backlight - just turn on/off based on brightness value
     if (brightness > 0) {
-        lcd.backlight();
+        lcd->backlight();
     } else {
-        lcd.noBacklight();
+        lcd->noBacklight();
     }
 }
 
 void DisplayManager::clear() {
-    if (!lcdAvailable) return; // Skip if LCD not available
+    if (!lcdReady()) return; // Skip if LCD not available
     
-    lcd.clear();
+    lcd->clear();
+    statusShown = false;
     displayNeedsUpdate = true;
 }
 
 void DisplayManager::showMessage(const char* line1, const char* line2, 
                                 const char* line3, const char* line4) {
-    if (!lcdAvailable) return; // Skip if LCD not available
+    if (!lcdReady()) return; // Skip if LCD not available
     
-    lcd.clear();
+    lcd->clear();
+    statusShown = false;
     
     if (line1 && strlen(line1) > 0) {
-        lcd.setCursor(0, 0);
+        lcd->setCursor(0, 0);
         padStringToGlobalBuffer(line1, 20);
-        lcd.print(globalStringBuffer);
+        lcd->print(globalStringBuffer);
     }
     if (line2 && strlen(line2) > 0) {
-        lcd.setCursor(0, 1);
+        lcd->setCursor(0, 1);
         padStringToGlobalBuffer(line2, 20);
-        lcd.print(globalStringBuffer);
+        lcd->print(globalStringBuffer);
     }
     if (line3 && strlen(line3) > 0) {
-        lcd.setCursor(0, 2);
+        lcd->setCursor(0, 2);
         padStringToGlobalBuffer(line3, 20);
-        lcd.print(globalStringBuffer);
+        lcd->print(globalStringBuffer);
     }
     if (line4 && strlen(line4) > 0) {
-        lcd.setCursor(0, 3);
+        lcd->setCursor(0, 3);
         padStringToGlobalBuffer(line4, 20);
-        lcd.print(globalStringBuffer);
+        lcd->print(globalStringBuffer);
     }
+    lcd->flush();
 }
 
 void DisplayManager::showMenuMessage(const char* line1, const char* line2, 
                                     const char* line3, const char* line4) {
-    if (!lcdAvailable) return; // Skip if LCD not available
+    if (!lcdReady()) return; // Skip if LCD not available
     
-    lcd.clear();
+    lcd->clear();
+    statusShown = false;
     
     if (line1 && strlen(line1) > 0) {
-        lcd.setCursor(0, 0);
+        lcd->setCursor(0, 0);
         centerStringToGlobalBuffer(line1, 20);  // Center the menu header
-        lcd.print(globalStringBuffer);
+        lcd->print(globalStringBuffer);
     }
     if (line2 && strlen(line2) > 0) {
-        lcd.setCursor(0, 1);
+        lcd->setCursor(0, 1);
         padStringToGlobalBuffer(line2, 20);
-        lcd.print(globalStringBuffer);
+        lcd->print(globalStringBuffer);
     }
     if (line3 && strlen(line3) > 0) {
-        lcd.setCursor(0, 2);
+        lcd->setCursor(0, 2);
         padStringToGlobalBuffer(line3, 20);
-        lcd.print(globalStringBuffer);
+        lcd->print(globalStringBuffer);
     }
     if (line4 && strlen(line4) > 0) {
-        lcd.setCursor(0, 3);
+        lcd->setCursor(0, 3);
         padStringToGlobalBuffer(line4, 20);
-        lcd.print(globalStringBuffer);
+        lcd->print(globalStringBuffer);
     }
+    lcd->flush();
+}
+
+void DisplayManager::writeField(uint8_t column, uint8_t row, const char* text, uint8_t width) {
+    if (!lcdReady()) return; // Skip if LCD not available
+    
+    lcd->setCursor(column, row);
+    padStringToGlobalBuffer(text, min((int)width, LCD_COLS - column));
+    lcd->print(globalStringBuffer);
+    lcd->flush();
 }
 
 void DisplayManager::showStatus(const RingerManager* ringerManager, bool paused, int maxConcurrent) {
-    if (!lcdAvailable) return; // Skip if LCD not available
+    if (!lcdReady()) return; // Skip if LCD not available
     
     // Line 1: CallStorm branding with storm icon and right-aligned timer (20 chars: "CallStorm🌪️    12:34")
-    lcd.setCursor(0, 0);
-    unsigned long totalSeconds = millis() / 1000;
-    unsigned long minutes = totalSeconds / 60;
-    unsigned long seconds = totalSeconds % 60;
+    lcd->setCursor(0, 0);
+    LineWriter line(globalStringBuffer, sizeof(globalStringBuffer));
+    line.text("CallStorm ");
+    line.character(stormGlyphs[currentAnimationFrame]);
+    line.text(" 2K ");
     
-    // Switch to HH:MM format when time exceeds 99:59 (6000 minutes)
-    if (minutes >= 100) {
-        unsigned long hours = minutes / 60;
-        minutes = minutes % 60;
-        // Format: "CallStorm" + storm icon (char 1) + spaces + timer (HH:MM)
-        snprintf(globalStringBuffer, sizeof(globalStringBuffer), "CallStorm \x01 2K %02lu:%02lu", hours % 100, minutes);
+    // Switch to HH:MM format when time exceeds 99:59 (100 minutes)
+    if (clockHours > 1 || (clockHours == 1 && clockMinutes >= 40)) {
+        line.paddedNumber(clockHours % 100, 2);
+        line.character(':');
+        line.paddedNumber(clockMinutes, 2);
     } else {
-        // Format: "CallStorm" + storm icon (char 1) + spaces + timer (MM:SS)
-        snprintf(globalStringBuffer, sizeof(globalStringBuffer), "CallStorm \x01 2K %02lu:%02lu", minutes, seconds);
-    }
-    // Ensure exactly 20 characters by padding with spaces
-    int len1 = strlen(globalStringBuffer);
-    for (int i = len1; i < 20; i++) {
-        globalStringBuffer[i] = ' ';
+        line.paddedNumber(clockHours * 60 + clockMinutes, 2);
+        line.character(':');
+        line.paddedNumber(clockSeconds, 2);
     }
-    globalStringBuffer[20] = '\0';
-    lcd.print(globalStringBuffer);
+    line.padTo(20);
+    lcd->print(globalStringBuffer);
     
     // Line 2: Show temporary message if active, otherwise leave blank for alerts
-    lcd.setCursor(0, 1);
+    lcd->setCursor(0, 1);
     unsigned long currentTime = millis();
-    
-    // Check if we should show a temporary message
+    line = LineWriter(globalStringBuffer, sizeof(globalStringBuffer));
     if (showingTempMessage) {
         if (currentTime - tempMessageStartTime < TEMP_MESSAGE_DURATION) {
-            // Still showing temp message
-            snprintf(globalStringBuffer, sizeof(globalStringBuffer), "%s", tempMessageText);
-            int len = strlen(globalStringBuffer);
-            for (int i = len; i < 20; i++) {
-                globalStringBuffer[i] = ' ';
-            }
-            globalStringBuffer[20] = '\0';
-            lcd.print(globalStringBuffer);
+            line.text(tempMessageText);
         } else {
-            // Temp message expired, clear it
-            showingTempMessage = false;
-            snprintf(globalStringBuffer, sizeof(globalStringBuffer), "                    ");
-            lcd.print(globalStringBuffer);
+            showingTempMessage = false;  // Expired - back to the blank alert line
         }
-    } else {
-        // No temp message, show normal blank line for future alerts
-        snprintf(globalStringBuffer, sizeof(globalStringBuffer), "                    ");
-        lcd.print(globalStringBuffer);
     }
+    line.padTo(20);
+    lcd->print(globalStringBuffer);
     
     // Line 3: Active calls and ringing phones with enabled relay count (20 chars max)
     // Format: "A:0 R:0 E:8 M:4" or "A:0 R:0 E:8" if no limit (center-justified)
-    lcd.setCursor(0, 2);
+    lcd->setCursor(0, 2);
+    char counts[21];
+    LineWriter countLine(counts, sizeof(counts));
+    countLine.text("A:");
+    countLine.number(ringerManager->getActiveCallCount());
+    countLine.text(" R:");
+    countLine.number(ringerManager->getRingingPhoneCount());
+    countLine.text(" E:");
+    countLine.number(ringerManager->getActivePhoneCount());
     if (maxConcurrent > 0 && maxConcurrent <= ringerManager->getTotalPhoneCount()) {
-        snprintf(globalStringBuffer, sizeof(globalStringBuffer), "A:%d R:%d E:%d M:%d", 
-                ringerManager->getActiveCallCount(),
-                ringerManager->getRingingPhoneCount(),
-                ringerManager->getActivePhoneCount(),
-                maxConcurrent);
-    } else {
-        snprintf(globalStringBuffer, sizeof(globalStringBuffer), "A:%d R:%d E:%d", 
-                ringerManager->getActiveCallCount(),
-                ringerManager->getRingingPhoneCount(),
-                ringerManager->getActivePhoneCount());
+        countLine.text(" M:");
+        countLine.number(maxConcurrent);
     }
-    // Center justify the string in 20 characters
-    int len = strlen(globalStringBuffer);
-    int spaces = (20 - len) / 2;
-    // Move string to center position
-    for (int i = len - 1; i >= 0; i--) {
-        globalStringBuffer[i + spaces] = globalStringBuffer[i];
-    }
-    // Fill leading spaces
-    for (int i = 0; i < spaces; i++) {
-        globalStringBuffer[i] = ' ';
-    }
-    // Fill trailing spaces
-    for (int i = len + spaces; i < 20; i++) {
-        globalStringBuffer[i] = ' ';
-    }
-    globalStringBuffer[20] = '\0';
-    lcd.print(globalStringBuffer);
+    centerStringToGlobalBuffer(counts, 20);
+    lcd->print(globalStringBuffer);
     
     // Line 4: Spaced and centered phone status (15 chars: "  R A - - X X X X  ")
-    lcd.setCursor(0, 3);
+    lcd->setCursor(0, 3);
     if (paused) {
-        snprintf(globalStringBuffer, sizeof(globalStringBuffer), "** PAUSED **");
-        // Center the text
-        int textLen = strlen(globalStringBuffer);
-        int spaces = (20 - textLen) / 2;
-        for (int i = 19; i >= 0; i--) {
-            if (i >= spaces && i < spaces + textLen) {
-                globalStringBuffer[i] = globalStringBuffer[i - spaces];
-            } else {
-                globalStringBuffer[i] = ' ';
-            }
-        }
-        globalStringBuffer[20] = '\0';
+        line = LineWriter(globalStringBuffer, sizeof(globalStringBuffer));
+        line.spaces(CENTER_OFFSET("** PAUSED **"));
+        line.text("** PAUSED **");
+        line.padTo(20);
     } else {
         // Create spaced phone status: each phone gets a char + space, then center it
         char phoneChars[8];
@@ -376,7 +419,10 @@ void DisplayManager::showStatus(const RingerManager* ringerManager, bool paused,
         globalStringBuffer[19] = ' ';
         globalStringBuffer[20] = '\0';
     }
-    lcd.print(globalStringBuffer);
+    lcd->print(globalStringBuffer);
+    lcd->flush();
+    
+    statusShown = true;
 }
 
 void DisplayManager::showStartupMessage() {
@@ -403,35 +449,17 @@ void DisplayManager::showResumeMessage() {
 }
 
 void DisplayManager::showChaosMessage() {
-    if (!lcdAvailable) return; // Skip if LCD not available
+    if (!lcdReady()) return; // Skip if LCD not available
     
-    lcd.clear();
+    lcd->clear();
+    statusShown = false;
     
     // Center-justified chaos message
-    const char* lines[4] = {
-        "Prepare For",
-        "** MAXIMUM CHAOS **",
-        "Max Settings Engaged",
-        "BRACE FOR IMPACT!"
-    };
-    
-    for (int lineNum = 0; lineNum < 4; lineNum++) {
-        lcd.setCursor(0, lineNum);
-        const char* text = lines[lineNum];
-        int len = strlen(text);
-        int spaces = (20 - len) / 2;
-        
-        // Center the text
-        for (int i = 0; i < 20; i++) {
-            if (i < spaces || i >= spaces + len) {
-                globalStringBuffer[i] = ' ';
-            } else {
-                globalStringBuffer[i] = text[i - spaces];
-            }
-        }
-        globalStringBuffer[20] = '\0';
-        lcd.print(globalStringBuffer);
-    }
+    writeCentered(0, CENTERED("Prepare For"));
+    writeCentered(1, CENTERED("** MAXIMUM CHAOS **"));
+    writeCentered(2, CENTERED("Max Settings Engaged"));
+    writeCentered(3, CENTERED("BRACE FOR IMPACT!"));
+    lcd->flush();
     
     delay(3000); // Show chaos message for 3 seconds
     displayNeedsUpdate = true;
@@ -439,7 +467,9 @@ void DisplayManager::showChaosMessage() {
 
 void DisplayManager::showRelayAdjustmentMessage(int newCount) {
     // Start showing a temporary message (non-blocking)
-    snprintf(tempMessageText, sizeof(tempMessageText), "Relays: %d", newCount);
+    LineWriter message(tempMessageText, sizeof(tempMessageText));
+    message.text("Relays: ");
+    message.number(newCount);
     showingTempMessage = true;
     tempMessageStartTime = millis();
     displayNeedsUpdate = true; // Trigger immediate display update
@@ -447,11 +477,10 @@ void DisplayManager::showRelayAdjustmentMessage(int newCount) {
 
 void DisplayManager::showRelayAdjustmentDirection(int newCount, bool increment) {
     // Start showing a temporary directional message (non-blocking)
-    if (increment) {
-        snprintf(tempMessageText, sizeof(tempMessageText), "Relays +1 (%d)", newCount);
-    } else {
-        snprintf(tempMessageText, sizeof(tempMessageText), "Relays -1 (%d)", newCount);
-    }
+    LineWriter message(tempMessageText, sizeof(tempMessageText));
+    message.text(increment ? "Relays +1 (" : "Relays -1 (");
+    message.number(newCount);
+    message.character(')');
     showingTempMessage = true;
     tempMessageStartTime = millis();
     displayNeedsUpdate = true; // Trigger immediate display update
@@ -459,37 +488,113 @@ void DisplayManager::showRelayAdjustmentDirection(int newCount, bool increment)
 
 void DisplayManager::showSaveExitMessage() {
     // Show brief "Settings Saved!" message before returning to operation
-    snprintf(tempMessageText, sizeof(tempMessageText), "Settings Saved!");
+    LineWriter message(tempMessageText, sizeof(tempMessageText));
+    message.text("Settings Saved!");
     showingTempMessage = true;
     tempMessageStartTime = millis();
     displayNeedsUpdate = true; // Trigger immediate display update
 }
 
+bool DisplayManager::tickClock(unsigned long currentTime) {
+    bool moved = false;
+    // Signed difference keeps this right across the millis() wrap
+    while ((long)(currentTime - nextClockTick) >= 0) {
+        nextClockTick += 1000;
+        moved = true;
+        if (++clockSeconds < 60) continue;
+        clockSeconds = 0;
+        if (++clockMinutes < 60) continue;
+        clockMinutes = 0;
+        clockHours++;
+    }
+    return moved;
+}
+
+void DisplayManager::writeCentered(uint8_t row, const char* text, int offset) {
+    lcd->setCursor(0, row);
+    LineWriter line(globalStringBuffer, sizeof(globalStringBuffer));
+    line.spaces(offset);
+    line.text(text);
+    line.padTo(LCD_COLS);
+    lcd->print(globalStringBuffer);
+}
+
 void DisplayManager::initializeStormAnimation() {
-    if (!lcdAvailable) return;
+    if (!lcdReady()) return;
     
-    // Load the first frame as custom character 1 (avoid \x00 null terminator issues)
-    lcd.createChar(1, stormFrames[0]);
+    // Load every frame once - lcd->begin() left CGRAM undefined
+    glyphs.initialize(lcd);
+    if (!Features::STORM_ANIMATION) {
+        return;  // Icon cell stays blank
+    }
+    for (uint8_t i = 0; i < ANIMATION_FRAME_COUNT; i++) {
+        stormGlyphs[i] = glyphs.pin(stormFrames[i]);
+    }
+    
+    lcd->flush();
     
     // Initialize animation state
     currentAnimationFrame = 0;
     lastAnimationUpdate = millis();
 }
 
-void DisplayManager::updateStormAnimation() {
-    if (!lcdAvailable || !animationEnabled) return;
-    
-    unsigned long currentTime = millis();
+void DisplayManager::updateStormAnimation(unsigned long currentTime) {
+    if (!lcdReady() || !Features::STORM_ANIMATION || !animationEnabled) return;
     
     // Check if it's time to update the animation frame
     if (currentTime - lastAnimationUpdate >= ANIMATION_FRAME_DURATION) {
         // Move to next frame
         currentAnimationFrame = (currentAnimationFrame + 1) % ANIMATION_FRAME_COUNT;
         
-        // Load the new frame into custom character slot 1
-        lcd.createChar(1, stormFrames[currentAnimationFrame]);
+        // The frame is already in CGRAM - just point the icon cell at it
+        if (statusShown) {
+            lcd->setCursor(STORM_ICON_COLUMN, 0);
+            lcd->write(stormGlyphs[currentAnimationFrame]);
+            lcd->flush();
+        }
         
         lastAnimationUpdate = currentTime;
-        displayNeedsUpdate = true; // Trigger display refresh
     }
 }
+
+void DisplayManager::resetStats() {
+    transport.resetStats();
+    frameCount = 0;
+    lastFrameMicros = 0;
+    maxFrameMicros = 0;
+}
+
+void DisplayManager::printStatus() const {
+    if (!lcdReady()) return;
+    if (lcd != &transport) {
+        DebugSerial.println(F("LCD: hd44780_I2Cexp, not batched"));
+        return;
+    }
+    
+    const Transport::Stats& stats = transport.getStats();
+    DebugSerial.print(F("LCD: "));
+    DebugSerial.print(transport.getClock() / 1000);
+    DebugSerial.print(F(" kHz, "));
+    DebugSerial.print(stats.transactions);
+    DebugSerial.print(F(" transactions, "));
+    DebugSerial.print(stats.bytes);
+    DebugSerial.print(F(" bytes for "));
+    DebugSerial.print(stats.characters);
+    DebugSerial.println(F(" chars"));
+    
+    // Bytes per character in tenths - instructions and padding included, so 4.0 (6.0 at 400 kHz) is the floor
+    unsigned long tenths = stats.characters ? (stats.bytes * 10UL) / stats.characters : 0;
+    DebugSerial.print(F("  "));
+    DebugSerial.print(tenths / 10);
+    DebugSerial.print(F("."));
+    DebugSerial.print(tenths % 10);
+    DebugSerial.print(F(" bytes/char, bus "));
+    DebugSerial.print(stats.busMicros / 1000);
+    DebugSerial.print(F("ms, "));
+    DebugSerial.print(frameCount);
+    DebugSerial.print(F(" frames, last "));
+    DebugSerial.print(lastFrameMicros);
+    DebugSerial.print(F("us, max "));
+    DebugSerial.print(maxFrameMicros);
+    DebugSerial.println(F("us"));
+}
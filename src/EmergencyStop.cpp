@@ -0,0 +1,155 @@
+#include "EmergencyStop.h"
+#include "RelayEdgeEngine.h"
+#include <Arduino.h>
+
+#ifdef ARDUINO
+// Trip state is shared with the pin change ISR
+#define STOP_LOCK() uint8_t savedSREG = SREG; cli()
+#define STOP_UNLOCK() SREG = savedSREG
+
+// Port C pin changes - the button and the zero-cross detector share the vector.
+// The stop goes first; the crossing's timestamp can wait a few microseconds.
+ISR(PCINT1_vect) {
+    EmergencyStop::handlePinChange();
+    RelayEdgeEngine::handlePinChange();
+}
+
+// Outputs grouped by port (B, C and D at most on the Nano), one OR per port
+static const uint8_t MAX_PORTS = 3;
+static volatile uint8_t* stopPorts[MAX_PORTS];
+static uint8_t stopMasks[MAX_PORTS];
+static uint8_t stopPortCount = 0;
+
+static volatile uint8_t* buttonInput = nullptr;
+static uint8_t buttonMask = 0;
+
+static void addOutput(uint8_t pin) {
+    volatile uint8_t* port = portOutputRegister(digitalPinToPort(pin));
+    uint8_t i = 0;
+    while (i < stopPortCount && stopPorts[i] != port) {
+        i++;
+    }
+    if (i == stopPortCount) {
+        if (stopPortCount == MAX_PORTS) {
+            return;
+        }
+        stopPorts[i] = port;
+        stopMasks[i] = 0;
+        stopPortCount++;
+    }
+    stopMasks[i] |= digitalPinToBitMask(pin);
+}
+#else
+#define STOP_LOCK()
+#define STOP_UNLOCK()
+
+static uint8_t stopPins[EmergencyStop::MAX_OUTPUTS];
+static uint8_t stopPinCount = 0;
+static uint8_t buttonPinNumber = 0;
+
+static void addOutput(uint8_t pin) {
+    if (stopPinCount < EmergencyStop::MAX_OUTPUTS) {
+        stopPins[stopPinCount++] = pin;
+    }
+}
+#endif
+
+volatile bool EmergencyStop::armed = false;
+volatile bool EmergencyStop::tripped = false;
+volatile unsigned long EmergencyStop::tripMicros = 0;
+volatile uint16_t EmergencyStop::tripCount = 0;
+unsigned long EmergencyStop::maxCatchUpMicros = 0;
+
+void EmergencyStop::begin(uint8_t buttonPin, const int* relayPins, uint8_t relayCount, uint8_t powerPin) {
+    STOP_LOCK();
+    armed = false;
+    tripped = false;
+    tripCount = 0;
+    maxCatchUpMicros = 0;
+    for (uint8_t i = 0; i < relayCount && i < MAX_OUTPUTS - 1; i++) {
+        addOutput(relayPins[i]);
+    }
+    addOutput(powerPin);
+#ifdef ARDUINO
+    buttonInput = portInputRegister(digitalPinToPort(buttonPin));
+    buttonMask = digitalPinToBitMask(buttonPin);
+    *digitalPinToPCMSK(buttonPin) |= (1 << digitalPinToPCMSKbit(buttonPin));
+    PCIFR = (1 << digitalPinToPCICRbit(buttonPin));
+    *digitalPinToPCICR(buttonPin) |= (1 << digitalPinToPCICRbit(buttonPin));
+#else
+    buttonPinNumber = buttonPin;
+#endif
+    STOP_UNLOCK();
+}
+
+void EmergencyStop::arm() {
+    armed = true;
+}
+
+bool EmergencyStop::isArmed() {
+    return armed;
+}
+
+bool EmergencyStop::isTripped() {
+    return tripped;
+}
+
+unsigned long EmergencyStop::acknowledge(unsigned long noticedMicros) {
+    unsigned long lag;
+    {
+        STOP_LOCK();
+        lag = noticedMicros - tripMicros;
+        tripped = false;
+        RelayEdgeEngine::releaseHold();
+        STOP_UNLOCK();
+    }
+    if (lag > maxCatchUpMicros) {
+        maxCatchUpMicros = lag;
+    }
+    return lag;
+}
+
+unsigned long EmergencyStop::getMaxCatchUpMicros() {
+    return maxCatchUpMicros;
+}
+
+uint16_t EmergencyStop::getTripCount() {
+    STOP_LOCK();
+    uint16_t count = tripCount;
+    STOP_UNLOCK();
+    return count;
+}
+
+void EmergencyStop::writeOutput(uint8_t pin, uint8_t level) {
+    STOP_LOCK();
+    if (level == HIGH || !tripped) {
+        digitalWrite(pin, level);
+    }
+    STOP_UNLOCK();
+}
+
+void EmergencyStop::handlePinChange() {
+#ifdef ARDUINO
+    // Released, or another port C pin changed
+    if (!armed || (*buttonInput & buttonMask)) {
+        return;
+    }
+    for (uint8_t i = 0; i < stopPortCount; i++) {
+        *stopPorts[i] |= stopMasks[i];
+    }
+#else
+    if (!armed || digitalRead(buttonPinNumber) != LOW) {
+        return;
+    }
+    for (uint8_t i = 0; i < stopPinCount; i++) {
+        digitalWrite(stopPins[i], HIGH);
+    }
+#endif
+    armed = false;
+    tripped = true;
+    tripMicros = micros();
+    tripCount++;
+
+    // Edges already queued would switch relays straight back on
+    RelayEdgeEngine::holdOff();
+}
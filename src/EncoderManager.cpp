@@ -1,218 +1,139 @@
 #include "EncoderManager.h"
+#include "Features.h"
 
 EncoderManager::EncoderManager() {
+    inputs = nullptr;
     encoderPinA = -1;
     encoderPinB = -1;
     encoderButtonPin = -1;
     lastA = false;
-    lastB = false;
-    currentA = false;
-    currentB = false;
-    lastButtonState = HIGH;
-    currentButtonState = HIGH;
-    lastRawButtonState = HIGH;
-    buttonPressed = false;
-    buttonPressTime = 0;
-    lastButtonDebounce = 0;
-    lastDebugPrint = 0;
+    acceleration.mediumInterval = 60;   // ~16 detents/s
+    acceleration.fastInterval = 25;     // ~40 detents/s - a flick
+    acceleration.mediumMultiplier = 5;
+    acceleration.fastMultiplier = 25;
+    lastDetentTime = 0;
+    averageInterval = 0;
+    lastDirection = NONE;
+    stepMultiplier = 1;
+    longPressReported = false;
 }
 
-void EncoderManager::initialize(int pinA, int pinB, int buttonPin, bool enableInitOutput) {
+void EncoderManager::initialize(InputDebouncer* inputs, int pinA, int pinB, int buttonPin, bool enableInitOutput) {
+    this->inputs = inputs;
     encoderPinA = pinA;
     encoderPinB = pinB;
     encoderButtonPin = buttonPin;
     
-    // Initialize pins (should already be done in main, but safe to repeat)
-    pinMode(encoderPinA, INPUT_PULLUP);
-    pinMode(encoderPinB, INPUT_PULLUP);
-    pinMode(encoderButtonPin, INPUT_PULLUP);
-    
-    // Read initial states
-    lastA = readEncoderA();
-    lastB = readEncoderB();
-    lastButtonState = readButton();
-    lastRawButtonState = lastButtonState;
-    currentButtonState = lastButtonState;
+    // Contacts get the short debounce, the button the long one
+    inputs->addEncoderLine(encoderPinA);
+    inputs->addEncoderLine(encoderPinB);
+    inputs->addButton(encoderButtonPin);
+    lastA = inputs->read(encoderPinA);
     
     if (enableInitOutput) {
-        Serial.println(F("EncoderManager initialized"));
-        Serial.print(F("Pin A: "));
-        Serial.print(encoderPinA);
-        Serial.print(F(", Pin B: "));
-        Serial.print(encoderPinB);
-        Serial.print(F(", Button: "));
-        Serial.println(encoderButtonPin);
+        DebugSerial.println(F("EncoderManager initialized"));
+        DebugSerial.print(F("Pin A: "));
+        DebugSerial.print(encoderPinA);
+        DebugSerial.print(F(", Pin B: "));
+        DebugSerial.print(encoderPinB);
+        DebugSerial.print(F(", Button: "));
+        DebugSerial.println(encoderButtonPin);
     }
 }
 
-EncoderManager::EncoderEvent EncoderManager::update() {
-    // Check for rotation first
+EncoderManager::EncoderEvent EncoderManager::update(unsigned long currentTime) {
+    // Button edges first - they only last until the next inputs->update(),
+    // while a missed rotation is still seen on the next call
+    EncoderEvent buttonEvent = checkButton();
+    if (buttonEvent != NONE) {
+        return buttonEvent;
+    }
+    
     EncoderEvent rotationEvent = checkRotation();
     if (rotationEvent != NONE) {
-        return rotationEvent;
+        updateAcceleration(rotationEvent, currentTime);
     }
-    
-    // Then check for button events
-    return checkButton();
+    return rotationEvent;
 }
 
 EncoderManager::EncoderEvent EncoderManager::checkRotation() {
-    currentA = readEncoderA();
-    currentB = readEncoderB();
-    
-    // Check if A pin changed
-    if (currentA != lastA) {
-        // A changed, check direction based on B
-        if (currentA == currentB) {
-            // Clockwise rotation
-            lastA = currentA;
-            lastB = currentB;
-            Serial.println(F("Encoder: CLOCKWISE"));
-            return CLOCKWISE;
-        } else {
-            // Counter-clockwise rotation
-            lastA = currentA;
-            lastB = currentB;
-            Serial.println(F("Encoder: COUNTER_CLOCKWISE"));
-            return COUNTER_CLOCKWISE;
-        }
+    bool currentA = inputs->read(encoderPinA);
+    if (currentA == lastA) {
+        return NONE;
     }
-    
-    // Update last states
     lastA = currentA;
-    lastB = currentB;
     
-    return NONE;
+    // A changed - B gives the direction
+    if (currentA == inputs->read(encoderPinB)) {
+        DebugSerial.println(F("Encoder: CLOCKWISE"));
+        return CLOCKWISE;
+    }
+    DebugSerial.println(F("Encoder: COUNTER_CLOCKWISE"));
+    return COUNTER_CLOCKWISE;
 }
 
-EncoderManager::EncoderEvent EncoderManager::checkButton() {
-    bool rawButtonState = readButton();
-    unsigned long currentTime = millis();
+void EncoderManager::updateAcceleration(EncoderEvent direction, unsigned long currentTime) {
+    unsigned long interval = currentTime - lastDetentTime;
+    lastDetentTime = currentTime;
     
-    // Debug: Print button state changes immediately (disabled for clean operation)
-    /*
-    static bool lastRawState = HIGH;
-    if (rawButtonState != lastRawState) {
-        Serial.println(F("=== ENCODER BUTTON EVENT ==="));
-        Serial.print(F("RAW BUTTON CHANGE: "));
-        Serial.print(lastRawState ? "HIGH" : "LOW");
-        Serial.print(F(" -> "));
-        Serial.println(rawButtonState ? "HIGH" : "LOW");
-        lastRawState = rawButtonState;
+    // Reversing or pausing starts again at single steps
+    if (direction != lastDirection || interval >= ACCELERATION_RESET_INTERVAL) {
+        lastDirection = direction;
+        averageInterval = 0;    // No rate yet
+        stepMultiplier = 1;
+        return;
     }
-    */
     
-    // Debug: Print button state periodically (disabled for focused debugging)
-    /*
-    if (currentTime - lastDebugPrint > DEBUG_INTERVAL) {
-        Serial.print(F("Button Debug - Raw: "));
-        Serial.print(rawButtonState ? "HIGH" : "LOW");
-        Serial.print(F(", Current: "));
-        Serial.print(currentButtonState ? "HIGH" : "LOW");
-        Serial.print(F(", Last: "));
-        Serial.println(lastButtonState ? "HIGH" : "LOW");
-        lastDebugPrint = currentTime;
+    // Smooth over the last couple of detents
+    if (averageInterval == 0) {
+        averageInterval = interval;
+    } else {
+        averageInterval = (averageInterval + interval) / 2;
     }
-    */
     
-    // Handle debouncing - only reset timer when raw state actually changes
-    if (rawButtonState != lastRawButtonState) {
-        lastButtonDebounce = currentTime; // Reset debounce timer on actual raw state change
-        lastRawButtonState = rawButtonState; // Update the raw state tracker
-        Serial.print(F("Button debounce reset, raw="));
-        Serial.println(rawButtonState ? "HIGH" : "LOW");
+    if (averageInterval <= acceleration.fastInterval) {
+        stepMultiplier = acceleration.fastMultiplier;
+    } else if (averageInterval <= acceleration.mediumInterval) {
+        stepMultiplier = acceleration.mediumMultiplier;
+    } else {
+        stepMultiplier = 1;
+    }
+}
+
+uint8_t EncoderManager::getStepMultiplier() const {
+    return stepMultiplier;
+}
+
+void EncoderManager::setAccelerationCurve(const AccelerationCurve& curve) {
+    acceleration = curve;
+}
+
+EncoderManager::EncoderEvent EncoderManager::checkButton() {
+    // A press is only reported once it's known to be short (on release) or long (while held)
+    if (inputs->pressed(encoderButtonPin)) {
+        longPressReported = false;
+        return NONE;
     }
     
-    // Check if button state has been stable for debounce time
-    if ((currentTime - lastButtonDebounce) > BUTTON_DEBOUNCE_TIME) {
-        // Update current state to the stable raw state
-        bool newState = rawButtonState;
-        
-        // Check for state transitions
-        if (newState != lastButtonState) {
-            Serial.println(F("=== BUTTON STATE TRANSITION ==="));
-            Serial.print(F("Button state change detected: "));
-            Serial.print(lastButtonState ? "HIGH" : "LOW");
-            Serial.print(F(" -> "));
-            Serial.println(newState ? "HIGH" : "LOW");
-            
-            currentButtonState = newState;
-            
-            if (newState == LOW && lastButtonState == HIGH) {
-                // Button just pressed - don't return BUTTON_PRESS immediately
-                // Wait to see if it becomes a long press
-                buttonPressed = true;
-                buttonPressTime = currentTime;
-                Serial.println(F("*** ENCODER BUTTON PRESSED (waiting for release/long-press) ***"));
-                lastButtonState = newState;
-                // Don't return BUTTON_PRESS here - wait for release or long press
-                return NONE;
-            }
-            
-            if (newState == HIGH && lastButtonState == LOW) {
-                // Button just released - check if it was a short press
-                unsigned long pressDuration = currentTime - buttonPressTime;
-                buttonPressed = false;
-                Serial.print(F("*** ENCODER BUTTON RELEASED after "));
-                Serial.print(pressDuration);
-                Serial.println(F("ms ***"));
-                lastButtonState = newState;
-                
-                // Only return BUTTON_PRESS if it was a short press (not a long press)
-                if (pressDuration < LONG_PRESS_TIME) {
-                    Serial.println(F("Short press detected on release"));
-                    return BUTTON_PRESS;
-                } else {
-                    Serial.println(F("Long press already handled, ignoring release"));
-                    return BUTTON_RELEASE;
-                }
-            }
-            
-            Serial.println(F("=== DEBUG CONDITION CHECK ==="));
-            Serial.print(F("newState="));
-            Serial.print(newState);
-            Serial.print(F(", lastButtonState="));
-            Serial.print(lastButtonState);
-            Serial.print(F(", LOW="));
-            Serial.print(LOW);
-            Serial.print(F(", HIGH="));
-            Serial.println(HIGH);
-            Serial.println(F("=== END DEBUG ==="));
-            
-            lastButtonState = newState;
-        } else {
-            // State is stable, just update current state
-            currentButtonState = rawButtonState;
-        }
+    if (inputs->longPressed(encoderButtonPin)) {
+        DebugSerial.println(F("Encoder Button: LONG_PRESS"));
+        longPressReported = true;
+        return BUTTON_LONG_PRESS;
     }
     
-    // Check for long press while button is held (only if button is currently pressed)
-    if (currentButtonState == LOW && buttonPressed) {
-        unsigned long pressDuration = currentTime - buttonPressTime;
-        if (pressDuration >= LONG_PRESS_TIME) {
-            Serial.println(F("Encoder Button: LONG_PRESS"));
-            buttonPressed = false; // Prevent repeated long press events
-            return BUTTON_LONG_PRESS;
+    if (inputs->released(encoderButtonPin)) {
+        if (longPressReported) {
+            return BUTTON_RELEASE;  // Long press already handled
         }
+        DebugSerial.println(F("Encoder Button: PRESS"));
+        return BUTTON_PRESS;
     }
     
     return NONE;
 }
 
-bool EncoderManager::readEncoderA() {
-    return digitalRead(encoderPinA);
-}
-
-bool EncoderManager::readEncoderB() {
-    return digitalRead(encoderPinB);
-}
-
-bool EncoderManager::readButton() {
-    return digitalRead(encoderButtonPin);
-}
-
 bool EncoderManager::getButtonState() const {
-    return currentButtonState;
+    return inputs ? inputs->read(encoderButtonPin) : HIGH;
 }
 
 const char* EncoderManager::getEventString(EncoderEvent event) const {
@@ -0,0 +1,125 @@
+#include "EntropyPool.h"
+#include <Arduino.h>
+
+#ifdef ARDUINO
+// Pool is shared with the ADC ISR
+#define POOL_LOCK() uint8_t savedSREG = SREG; cli()
+#define POOL_UNLOCK() SREG = savedSREG
+
+ISR(ADC_vect) {
+    // Timer0 runs the millis() clock - its count when this fires carries latency jitter
+    EntropyPool::handleConversion(ADC, TCNT0);
+}
+#else
+#define POOL_LOCK()
+#define POOL_UNLOCK()
+#endif
+
+volatile uint8_t EntropyPool::pool[EntropyPool::POOL_SIZE];
+volatile uint8_t EntropyPool::position = 0;
+volatile uint8_t EntropyPool::quality = 0;
+volatile uint16_t EntropyPool::lastReading = 0;
+volatile unsigned long EntropyPool::sampleCount = 0;
+volatile bool EntropyPool::harvesting = false;
+uint8_t EntropyPool::analogPin = 0;
+
+void EntropyPool::begin(uint8_t pin) {
+    analogPin = pin;
+#ifdef ARDUINO
+    // AVcc reference, 125 kHz ADC clock (~104us per conversion), interrupt on completion
+    uint8_t channel = (pin >= A0 ? pin - A0 : pin) & 0x07;
+    ADMUX = (1 << REFS0) | channel;
+    ADCSRA = (1 << ADEN) | (1 << ADIE) | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
+#endif
+    startConversion();
+}
+
+void EntropyPool::startConversion() {
+    harvesting = true;
+#ifdef ARDUINO
+    ADCSRA |= (1 << ADSC);
+#else
+    // No ADC interrupt on the host - do the whole background harvest now
+    while (harvesting) {
+        handleConversion(analogRead(analogPin), (uint8_t)micros());
+    }
+#endif
+}
+
+void EntropyPool::handleConversion(uint16_t reading, uint8_t jitter) {
+    // Rotate-add-xor stir: each byte absorbs the sample and its neighbour
+    uint8_t index = position;
+    uint8_t input = (uint8_t)reading ^ (uint8_t)(reading >> 8) ^ jitter;
+    uint8_t current = pool[index];
+    uint8_t previous = pool[(index - 1) & (POOL_SIZE - 1)];
+    pool[index] = (uint8_t)((current << 3) | (current >> 5)) + (input ^ previous);
+    position = (index + 1) & (POOL_SIZE - 1);
+    sampleCount++;
+
+    // Only a reading that moved shows noise - a stuck input earns nothing
+    if (reading != lastReading && quality < POOL_TARGET_BITS) {
+        quality++;
+    }
+    lastReading = reading;
+
+    if (quality < POOL_TARGET_BITS) {
+#ifdef ARDUINO
+        ADCSRA |= (1 << ADSC);
+#endif
+    } else {
+        harvesting = false;
+    }
+}
+
+uint32_t EntropyPool::takeSeed() {
+    uint8_t snapshot[POOL_SIZE];
+    {
+        POOL_LOCK();
+        for (uint8_t i = 0; i < POOL_SIZE; i++) {
+            snapshot[i] = pool[i];
+        }
+        POOL_UNLOCK();
+    }
+
+    // FNV-1a over the pool and the time, then MurmurHash3's finalizer to spread it
+    uint32_t hash = 2166136261UL;
+    for (uint8_t i = 0; i < POOL_SIZE; i++) {
+        hash = (hash ^ snapshot[i]) * 16777619UL;
+    }
+    uint32_t stamp = micros();
+    for (uint8_t i = 0; i < 4; i++) {
+        hash = (hash ^ (uint8_t)(stamp >> (i * 8))) * 16777619UL;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6BUL;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35UL;
+    hash ^= hash >> 16;
+
+    // Stir the seed back in so the next one differs even if no new noise arrives,
+    // and start collecting again
+    {
+        POOL_LOCK();
+        for (uint8_t i = 0; i < 4; i++) {
+            pool[(position + i) & (POOL_SIZE - 1)] ^= (uint8_t)(hash >> (i * 8));
+        }
+        quality = 0;
+        POOL_UNLOCK();
+    }
+    if (!harvesting) {
+        startConversion();
+    }
+
+    return hash ? hash : 1;  // 0 means "no fixed seed" to the caller
+}
+
+uint8_t EntropyPool::getQuality() {
+    return quality;
+}
+
+unsigned long EntropyPool::getSampleCount() {
+    POOL_LOCK();
+    unsigned long count = sampleCount;
+    POOL_UNLOCK();
+    return count;
+}
@@ -0,0 +1,62 @@
+#include "EventBus.h"
+
+EventBus::Subscriber EventBus::subscribers[EventBus::MAX_SUBSCRIBERS];
+uint8_t EventBus::subscriberCount = 0;
+
+EVENT_QUEUE_STORAGE EventBus::Event EventBus::queue[EventBus::QUEUE_SIZE];
+EVENT_QUEUE_STORAGE uint8_t EventBus::queueHead = 0;
+EVENT_QUEUE_STORAGE uint8_t EventBus::queueCount = 0;
+EVENT_QUEUE_STORAGE unsigned long EventBus::droppedCount = 0;
+
+bool EventBus::subscribe(uint8_t mask, EventHandler handler) {
+    if (subscriberCount >= MAX_SUBSCRIBERS || handler == nullptr) {
+        return false;
+    }
+    
+    subscribers[subscriberCount].mask = mask;
+    subscribers[subscriberCount].handler = handler;
+    subscriberCount++;
+    return true;
+}
+
+bool EventBus::publish(EventType type, uint8_t line) {
+    if (queueCount >= QUEUE_SIZE) {
+        droppedCount++;
+        return false;
+    }
+    
+    Event& event = queue[(queueHead + queueCount) % QUEUE_SIZE];
+    event.type = type;
+    event.line = line;
+    queueCount++;
+    return true;
+}
+
+uint8_t EventBus::dispatch() {
+    uint8_t delivered = 0;
+    
+    // Handlers may publish - those events are delivered in this same pass
+    while (queueCount > 0) {
+        Event event = queue[queueHead];
+        queueHead = (queueHead + 1) % QUEUE_SIZE;
+        queueCount--;
+        
+        uint8_t bit = 1 << event.type;
+        for (uint8_t i = 0; i < subscriberCount; i++) {
+            if (subscribers[i].mask & bit) {
+                subscribers[i].handler(event);
+            }
+        }
+        delivered++;
+    }
+    
+    return delivered;
+}
+
+uint8_t EventBus::getPendingCount() {
+    return queueCount;
+}
+
+unsigned long EventBus::getDroppedCount() {
+    return droppedCount;
+}
@@ -0,0 +1,105 @@
+#include "GlyphManager.h"
+
+GlyphManager::GlyphManager() {
+    lcd = nullptr;
+    useCounter = 0;
+    loadCount = 0;
+    for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+        slots[i].bitmap = nullptr;
+        slots[i].lastUse = 0;
+        slots[i].pinned = false;
+    }
+}
+
+void GlyphManager::initialize(hd44780* lcd) {
+    this->lcd = lcd;
+    useCounter = 0;
+    for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+        slots[i].bitmap = nullptr;
+        slots[i].lastUse = 0;
+        slots[i].pinned = false;
+    }
+}
+
+uint8_t GlyphManager::pin(const uint8_t* bitmap) {
+    int8_t slot = findSlot(bitmap);
+    if (slot < 0) {
+        slot = findVictim();
+        if (slot < 0) {
+            return NO_GLYPH;
+        }
+        load(slot, bitmap);
+    }
+    slots[slot].pinned = true;
+    return charCode(slot);
+}
+
+uint8_t GlyphManager::acquire(const uint8_t* bitmap) {
+    int8_t slot = findSlot(bitmap);
+    if (slot < 0) {
+        slot = findVictim();
+        if (slot < 0) {
+            return NO_GLYPH;
+        }
+        load(slot, bitmap);
+    }
+    slots[slot].lastUse = ++useCounter;
+    return charCode(slot);
+}
+
+uint8_t GlyphManager::find(const uint8_t* bitmap) const {
+    int8_t slot = findSlot(bitmap);
+    return slot < 0 ? NO_GLYPH : charCode(slot);
+}
+
+uint8_t GlyphManager::getFreeSlotCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+        if (!slots[i].pinned) {
+            count++;
+        }
+    }
+    return count;
+}
+
+unsigned long GlyphManager::getLoadCount() const {
+    return loadCount;
+}
+
+int8_t GlyphManager::findSlot(const uint8_t* bitmap) const {
+    for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+        if (slots[i].bitmap == bitmap) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int8_t GlyphManager::findVictim() const {
+    // Empty slot first, otherwise the unpinned slot unused for longest
+    int8_t victim = -1;
+    uint8_t oldestAge = 0;
+    for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+        if (slots[i].pinned) {
+            continue;
+        }
+        if (slots[i].bitmap == nullptr) {
+            return i;
+        }
+        uint8_t age = useCounter - slots[i].lastUse;  // Wraps safely
+        if (victim < 0 || age > oldestAge) {
+            victim = i;
+            oldestAge = age;
+        }
+    }
+    return victim;
+}
+
+void GlyphManager::load(uint8_t slot, const uint8_t* bitmap) {
+    if (lcd) {
+        lcd->createChar(slot, bitmap);
+    }
+    slots[slot].bitmap = bitmap;
+    slots[slot].lastUse = useCounter;
+    loadCount++;
+}
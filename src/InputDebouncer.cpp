@@ -0,0 +1,118 @@
+#include "InputDebouncer.h"
+
+InputDebouncer::InputDebouncer() {
+    encoderLanes = 0;
+    buttonLanes = 0;
+    state = 0;
+    count0 = 0;
+    count1 = 0;
+    buttonTick = 0;
+    pressedLanes = 0;
+    releasedLanes = 0;
+    longPressLanes = 0;
+    buttonCount = 0;
+    longPending = 0;
+}
+
+void InputDebouncer::addEncoderLine(uint8_t pin) {
+    uint32_t lane = laneOf(pin);
+    pinMode(pin, INPUT_PULLUP);
+    encoderLanes |= lane;
+    if (digitalRead(pin)) state |= lane; else state &= ~lane;
+}
+
+bool InputDebouncer::addButton(uint8_t pin) {
+    uint32_t lane = laneOf(pin);
+    if (buttonCount >= MAX_BUTTONS || lane == 0) {
+        return false;
+    }
+    pinMode(pin, INPUT_PULLUP);
+    buttonPins[buttonCount] = pin;
+    pressTime[buttonCount] = 0;
+    buttonCount++;
+    buttonLanes |= lane;
+    if (digitalRead(pin)) state |= lane; else state &= ~lane;
+    return true;
+}
+
+void InputDebouncer::update(unsigned long currentTime) {
+    uint32_t raw = sample();
+
+    uint32_t clocked = encoderLanes;
+    if (++buttonTick >= BUTTON_SAMPLE_DIVIDER) {
+        buttonTick = 0;
+        clocked |= buttonLanes;
+    }
+
+    // Lanes that agree with their debounced level reset; clocked lanes that
+    // disagree count up, and the ones that were already at 3 flip
+    uint32_t differs = (raw ^ state) & (encoderLanes | buttonLanes);
+    uint32_t toggled = differs & clocked & count0 & count1;
+    count1 = differs & (count1 ^ (count0 & clocked));
+    count0 = differs & (count0 ^ clocked);
+    state ^= toggled;
+
+    pressedLanes = toggled & buttonLanes & ~state;
+    releasedLanes = toggled & buttonLanes & state;
+    longPressLanes = 0;
+    longPending &= ~releasedLanes;
+
+    if (pressedLanes == 0 && longPending == 0) {
+        return;  // Nothing held - the usual case
+    }
+    for (uint8_t i = 0; i < buttonCount; i++) {
+        uint32_t lane = laneOf(buttonPins[i]);
+        if (pressedLanes & lane) {
+            pressTime[i] = currentTime;
+            longPending |= lane;
+        } else if ((longPending & lane) && currentTime - pressTime[i] >= LONG_PRESS_TIME) {
+            longPressLanes |= lane;
+            longPending &= ~lane;
+        }
+    }
+}
+
+uint8_t InputDebouncer::read(uint8_t pin) const {
+    return (state & laneOf(pin)) ? HIGH : LOW;
+}
+
+bool InputDebouncer::pressed(uint8_t pin) const {
+    return (pressedLanes & laneOf(pin)) != 0;
+}
+
+bool InputDebouncer::released(uint8_t pin) const {
+    return (releasedLanes & laneOf(pin)) != 0;
+}
+
+bool InputDebouncer::longPressed(uint8_t pin) const {
+    return (longPressLanes & laneOf(pin)) != 0;
+}
+
+uint32_t InputDebouncer::laneOf(uint8_t pin) {
+    // D0-D7 = PIND bits 0-7, D8-D13 = PINB bits 0-5, A0-A5 = PINC bits 0-5
+    if (pin < 14) {
+        return 1UL << pin;
+    }
+    if (pin < 20) {
+        return 1UL << (pin + 2);
+    }
+    return 0;  // A6/A7 are analog only
+}
+
+uint32_t InputDebouncer::sample() const {
+#ifdef ARDUINO
+    // Three register reads, however many inputs there are
+    return PIND | ((uint32_t)PINB << 8) | ((uint32_t)PINC << 16);
+#else
+    // Virtual board has no port registers - read the registered pins one by one
+    uint32_t used = encoderLanes | buttonLanes;
+    uint32_t raw = 0;
+    for (uint8_t pin = 0; pin < 20; pin++) {
+        uint32_t lane = laneOf(pin);
+        if ((used & lane) && digitalRead(pin)) {
+            raw |= lane;
+        }
+    }
+    return raw;
+#endif
+}
@@ -0,0 +1,195 @@
+#include "LcdTransport.h"
+
+LcdTransport::LcdTransport() {
+    address = 0;
+    backlightOnMask = PIN_BACKLIGHT;
+    backlightMask = PIN_BACKLIGHT;
+    padBytes = 0;
+    clock = STANDARD_CLOCK;
+    queueLength = 0;
+    resetStats();
+}
+
+void LcdTransport::setAddress(uint8_t address) {
+    this->address = address;
+}
+
+int LcdTransport::begin(uint8_t cols, uint8_t rows) {
+    int status = hd44780::begin(cols, rows);
+    if (status == RV_ENOERR) {
+        // Clear/home still need their wait - they're sent immediately, so it's
+        // timed right. Everything else is spaced out by the padding bytes.
+        setExecTimes(HD44780_CHEXECTIME, 0);
+    }
+    return status;
+}
+
+void LcdTransport::flush() {
+    send();
+}
+
+uint32_t LcdTransport::getClock() const {
+    return clock;
+}
+
+const LcdTransport::Stats& LcdTransport::getStats() const {
+    return stats;
+}
+
+void LcdTransport::resetStats() {
+    stats.transactions = 0;
+    stats.bytes = 0;
+    stats.characters = 0;
+    stats.busMicros = 0;
+}
+
+int LcdTransport::ioinit() {
+    if (address == 0) {
+        return RV_ENXIO;
+    }
+
+    // Everything on the bus has to manage the standard rate
+    Wire.begin();
+    Wire.setClock(STANDARD_CLOCK);
+    clock = STANDARD_CLOCK;
+    if (!writePort(0)) {
+        return RV_EIO;
+    }
+
+    // Anything but the common wiring is left to hd44780_I2Cexp
+    if (!readsBusyFlag()) {
+        return RV_ENOTSUP;
+    }
+
+    // Backlight polarity, as hd44780_I2Cexp tells it: set high, the pin
+    // reads back low if it drives an NPN base (active high) and high if it
+    // drives a PNP or FET (active low)
+    uint8_t value;
+    if (!writePort(PIN_BACKLIGHT) || !readPort(value)) {
+        return RV_EIO;
+    }
+    backlightOnMask = (value & PIN_BACKLIGHT) ? 0 : PIN_BACKLIGHT;
+    backlightMask = backlightOnMask;
+
+    // Try fast mode - E and RW stay low so the LCD ignores the test patterns
+    Wire.setClock(FAST_CLOCK);
+    if (portReadsBack(0xA1) && portReadsBack(0x50)) {
+        clock = FAST_CLOCK;
+    } else {
+        Wire.setClock(STANDARD_CLOCK);
+    }
+
+    // Bytes (9 bits each) from one write's latch to the next one's, two without padding
+    uint8_t gapBytes = (EXEC_MICROS * (clock / 1000) + 8999) / 9000;
+    padBytes = gapBytes > 2 ? gapBytes - 2 : 0;
+    return writePort(backlightMask) ? RV_ENOERR : RV_EIO;
+}
+
+int LcdTransport::iowrite(hd44780::iotype type, uint8_t value) {
+    uint8_t length = (type == HD44780_IOcmd4bit) ? 2 : 4 + padBytes;
+    if (queueLength + length > QUEUE_SIZE && !send()) {
+        return RV_EIO;
+    }
+
+    uint8_t control = backlightMask;
+    if (type == HD44780_IOdata) {
+        control |= PIN_RS;
+        stats.characters++;
+    }
+    if (type != HD44780_IOcmd4bit) {
+        queueNibble(value >> 4, control);
+    }
+    queueNibble(value & 0x0F, control);
+    if (type != HD44780_IOcmd4bit) {
+        // Hold E low until the instruction has had time to execute
+        for (uint8_t i = 0; i < padBytes; i++) {
+            queue[queueLength++] = control;
+        }
+    }
+
+    // Initialisation steps and clear/home are followed by long waits - send them now
+    if (type == HD44780_IOcmd4bit || (type == HD44780_IOcmd && value <= 0x03)) {
+        return send() ? RV_ENOERR : RV_EIO;
+    }
+    return RV_ENOERR;
+}
+
+int LcdTransport::iosetbacklight(uint8_t dimvalue) {
+    uint8_t mask = dimvalue ? backlightOnMask : (backlightOnMask ^ PIN_BACKLIGHT);
+    if (mask == backlightMask) {
+        return RV_ENOERR;  // Already there - nothing to send
+    }
+    backlightMask = mask;
+
+    // Queued bytes carry the old backlight bit - send them first
+    if (!send() || !writePort(backlightMask)) {
+        return RV_EIO;
+    }
+    return RV_ENOERR;
+}
+
+bool LcdTransport::send() {
+    if (queueLength == 0) {
+        return true;
+    }
+    unsigned long start = micros();
+    Wire.beginTransmission(address);
+    Wire.write(queue, queueLength);
+    bool ok = Wire.endTransmission() == 0;
+    stats.busMicros += micros() - start;
+    stats.transactions++;
+    stats.bytes += queueLength;
+    queueLength = 0;
+    return ok;
+}
+
+bool LcdTransport::writePort(uint8_t value) {
+    Wire.beginTransmission(address);
+    Wire.write(value);
+    return Wire.endTransmission() == 0;
+}
+
+bool LcdTransport::readPort(uint8_t& value) {
+    if (Wire.requestFrom(address, (uint8_t)1) != 1) {
+        return false;
+    }
+    value = Wire.read();
+    return true;
+}
+
+bool LcdTransport::portReadsBack(uint8_t value) {
+    uint8_t port;
+    if (!writePort(value) || !readPort(port)) {
+        return false;
+    }
+    return (port & READBACK_MASK) == (value & READBACK_MASK);
+}
+
+bool LcdTransport::readsBusyFlag() {
+    // Data lines released (written high) and RW high: with E low nothing
+    // drives them, so D7 reads high
+    uint8_t value;
+    if (!writePort(DATA_PINS | PIN_RW) || !readPort(value) || !(value & PIN_D7)) {
+        return false;
+    }
+
+    // With E high too the LCD drives its status onto D4-D7 - D7 is the busy
+    // flag and drops once any reset or instruction has finished. In 4-bit
+    // mode every other strobe reads the address counter's low bits instead;
+    // begin()'s initialisation resynchronises the nibbles afterwards.
+    bool ready = false;
+    unsigned long start = millis();
+    do {
+        if (!writePort(DATA_PINS | PIN_RW | PIN_E) || !readPort(value) || !writePort(DATA_PINS | PIN_RW)) {
+            return false;
+        }
+        ready = !(value & PIN_D7);
+    } while (!ready && millis() - start < READY_TIMEOUT_MS);
+    return ready && writePort(0);
+}
+
+void LcdTransport::queueNibble(uint8_t nibble, uint8_t control) {
+    uint8_t value = (nibble << 4) | control;
+    queue[queueLength++] = value | PIN_E;
+    queue[queueLength++] = value;
+}
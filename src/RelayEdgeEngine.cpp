@@ -0,0 +1,396 @@
+#include "RelayEdgeEngine.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+// Queue is shared with the compare-match ISR
+#define ENGINE_LOCK() uint8_t savedSREG = SREG; cli()
+#define ENGINE_UNLOCK() SREG = savedSREG
+
+ISR(TIMER1_OVF_vect) {
+    RelayEdgeEngine::handleOverflow();
+}
+
+ISR(TIMER1_COMPA_vect) {
+    RelayEdgeEngine::handleCompare();
+}
+
+// Zero-cross input (port C) - read directly, the ISR fires on both edges.
+// The PCINT1 vector itself is in EmergencyStop.cpp, shared with the pause button.
+static volatile uint8_t* zeroCrossInput = nullptr;
+static uint8_t zeroCrossMask = 0;
+
+void RelayEdgeEngine::handlePinChange() {
+    if (zeroCrossInput && (*zeroCrossInput & zeroCrossMask)) {
+        handleZeroCross();
+    }
+}
+#else
+// Host emulation - the "hardware" is a tick counter and a compare target
+#define ENGINE_LOCK()
+#define ENGINE_UNLOCK()
+
+void digitalWrite(uint8_t pin, uint8_t val);  // Provided by the host program
+
+static uint32_t emulatedTicks = 0;
+static uint32_t emulatedCompare = 0;
+static bool emulatedCompareArmed = false;
+static uint32_t emulatedHalfCycle = 0;
+static uint32_t emulatedNextCrossing = 0;
+#endif
+
+static const uint8_t LEVEL_LOW = 0;  // LOW energizes an active-LOW relay
+
+RelayEdgeEngine::Edge RelayEdgeEngine::queue[RelayEdgeEngine::MAX_EDGES];
+volatile uint8_t RelayEdgeEngine::edgeCount = 0;
+volatile uint16_t RelayEdgeEngine::overflowCount = 0;
+volatile uint32_t RelayEdgeEngine::maxLatenessTicks = 0;
+volatile bool RelayEdgeEngine::heldOff = false;
+bool RelayEdgeEngine::zeroCrossEnabled = false;
+uint16_t RelayEdgeEngine::operateTicks = 0;
+uint16_t RelayEdgeEngine::releaseTicks = 0;
+volatile uint32_t RelayEdgeEngine::lastCrossing = 0;
+volatile uint32_t RelayEdgeEngine::halfCycleTicks = 0;
+volatile bool RelayEdgeEngine::halfCycleConfirmed = false;
+volatile uint16_t RelayEdgeEngine::syncedBatches = 0;
+uint32_t RelayEdgeEngine::syncedCrossing = 0;
+
+void RelayEdgeEngine::begin() {
+    edgeCount = 0;
+    overflowCount = 0;
+    maxLatenessTicks = 0;
+#ifdef ARDUINO
+    ENGINE_LOCK();
+    TCCR1A = 0;                                 // Normal mode, OC1A/OC1B disconnected
+    TCCR1B = (1 << CS11) | (1 << CS10);         // clk/64 = 4us per tick
+    TCNT1 = 0;
+    TIFR1 = (1 << TOV1) | (1 << OCF1A);
+    TIMSK1 = (1 << TOIE1);                      // Compare match armed on demand
+    ENGINE_UNLOCK();
+#else
+    emulatedTicks = 0;
+    emulatedCompareArmed = false;
+#endif
+}
+
+uint32_t RelayEdgeEngine::now() {
+#ifdef ARDUINO
+    ENGINE_LOCK();
+    uint16_t low = TCNT1;
+    uint16_t high = overflowCount;
+    // Overflow happened but its interrupt hasn't run yet
+    if ((TIFR1 & (1 << TOV1)) && low < 0x8000) {
+        high++;
+    }
+    ENGINE_UNLOCK();
+    return ((uint32_t)high << 16) | low;
+#else
+    return emulatedTicks;
+#endif
+}
+
+uint32_t RelayEdgeEngine::msToTicks(unsigned long ms) {
+    return (uint32_t)ms * TICKS_PER_MS;
+}
+
+bool RelayEdgeEngine::scheduleEdge(uint8_t pin, uint8_t level, uint32_t atTicks) {
+    ENGINE_LOCK();
+    if (edgeCount >= MAX_EDGES) {
+        ENGINE_UNLOCK();
+        return false;
+    }
+    
+    // Insertion sort from the back - equal times keep their scheduling order
+    uint8_t i = edgeCount;
+    while (i > 0 && (int32_t)(queue[i - 1].time - atTicks) > 0) {
+        queue[i] = queue[i - 1];
+        i--;
+    }
+    queue[i].time = atTicks;
+    queue[i].pin = pin;
+    queue[i].level = level;
+    queue[i].synced = false;
+    edgeCount++;
+    
+    // New soonest edge - fire it now if due, otherwise move the compare match
+    if (i == 0) {
+        applyDueEdges();
+        armCompare();
+    }
+    ENGINE_UNLOCK();
+    return true;
+}
+
+void RelayEdgeEngine::cancelEdges(uint8_t pin) {
+    ENGINE_LOCK();
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < edgeCount; i++) {
+        if (queue[i].pin != pin) {
+            queue[kept++] = queue[i];
+        }
+    }
+    edgeCount = kept;
+    armCompare();
+    ENGINE_UNLOCK();
+}
+
+void RelayEdgeEngine::cancelAll() {
+    ENGINE_LOCK();
+    edgeCount = 0;
+    armCompare();
+    ENGINE_UNLOCK();
+}
+
+void RelayEdgeEngine::holdOff() {
+    ENGINE_LOCK();
+    heldOff = true;
+    edgeCount = 0;
+    armCompare();
+    ENGINE_UNLOCK();
+}
+
+void RelayEdgeEngine::releaseHold() {
+    heldOff = false;
+}
+
+uint8_t RelayEdgeEngine::getPendingCount() {
+    return edgeCount;
+}
+
+uint32_t RelayEdgeEngine::getMaxLatenessMicros() {
+    ENGINE_LOCK();
+    uint32_t lateness = maxLatenessTicks;
+    ENGINE_UNLOCK();
+    return lateness * (1000UL / TICKS_PER_MS);
+}
+
+void RelayEdgeEngine::resetStats() {
+    ENGINE_LOCK();
+    maxLatenessTicks = 0;
+    syncedBatches = 0;
+    ENGINE_UNLOCK();
+}
+
+void RelayEdgeEngine::enableZeroCross(uint8_t pin, uint16_t operateMicros, uint16_t releaseMicros) {
+#ifdef ARDUINO
+    pinMode(pin, INPUT_PULLUP);  // Opto-isolated detectors pull down between pulses
+#endif
+    ENGINE_LOCK();
+    operateTicks = operateMicros / (1000 / TICKS_PER_MS);
+    releaseTicks = releaseMicros / (1000 / TICKS_PER_MS);
+    lastCrossing = now();
+    halfCycleTicks = 0;
+    halfCycleConfirmed = false;
+    zeroCrossEnabled = true;
+#ifdef ARDUINO
+    zeroCrossInput = portInputRegister(digitalPinToPort(pin));
+    zeroCrossMask = digitalPinToBitMask(pin);
+    *digitalPinToPCMSK(pin) |= (1 << digitalPinToPCMSKbit(pin));
+    PCIFR = (1 << digitalPinToPCICRbit(pin));
+    *digitalPinToPCICR(pin) |= (1 << digitalPinToPCICRbit(pin));
+#else
+    (void)pin;
+#endif
+    ENGINE_UNLOCK();
+}
+
+uint32_t RelayEdgeEngine::getHalfCycleMicros() {
+    ENGINE_LOCK();
+    uint32_t halfCycle = zeroCrossLocked(now()) ? halfCycleTicks : 0;
+    ENGINE_UNLOCK();
+    return halfCycle * (1000UL / TICKS_PER_MS);
+}
+
+uint16_t RelayEdgeEngine::getSyncedBatches() {
+    ENGINE_LOCK();
+    uint16_t batches = syncedBatches;
+    ENGINE_UNLOCK();
+    return batches;
+}
+
+void RelayEdgeEngine::handleOverflow() {
+    overflowCount++;
+}
+
+void RelayEdgeEngine::handleCompare() {
+    applyDueEdges();
+    armCompare();
+}
+
+void RelayEdgeEngine::handleZeroCross() {
+    uint32_t currentTicks = now();
+    uint32_t interval = currentTicks - lastCrossing;
+    if (interval < MIN_HALF_CYCLE_TICKS) {
+        return;  // Noise on the detector
+    }
+    
+    uint32_t tolerance = halfCycleTicks / 16;
+    if (halfCycleTicks != 0 && interval > halfCycleTicks - tolerance && interval < halfCycleTicks + tolerance) {
+        if (halfCycleConfirmed) {
+            // Follow slow drift of the supply frequency
+            halfCycleTicks += ((int32_t)interval - (int32_t)halfCycleTicks) / 4;
+        } else {
+            halfCycleTicks = interval;  // Two matching intervals - locked
+            halfCycleConfirmed = true;
+        }
+    } else {
+        // First crossing, a missed one or a new frequency - start over from this interval
+        halfCycleTicks = interval <= MAX_HALF_CYCLE_TICKS ? interval : 0;
+        halfCycleConfirmed = false;
+    }
+    lastCrossing = currentTicks;
+}
+
+// Interrupts must already be off
+void RelayEdgeEngine::applyDueEdges() {
+    uint32_t currentTicks = now();
+    while (edgeCount > 0 && (int32_t)(queue[0].time - currentTicks) <= 0) {
+        if (!queue[0].synced && zeroCrossLocked(currentTicks)) {
+            syncDueEdges(currentTicks);  // Everything due moves to the next crossing
+            continue;
+        }
+        const Edge& edge = queue[0];
+        
+        // Held off - nothing may switch a relay back on
+        if (edge.level == LEVEL_LOW && heldOff) {
+            removeAt(0);
+            continue;
+        }
+        
+        uint32_t lateness = currentTicks - edge.time;
+        if (lateness > maxLatenessTicks) {
+            maxLatenessTicks = lateness;
+        }
+        
+#ifdef ARDUINO
+        // Direct port write - digitalWrite() is too slow for an ISR
+        volatile uint8_t* port = portOutputRegister(digitalPinToPort(edge.pin));
+        uint8_t mask = digitalPinToBitMask(edge.pin);
+        if (edge.level == LOW) {
+            *port &= ~mask;
+        } else {
+            *port |= mask;
+        }
+#else
+        digitalWrite(edge.pin, edge.level);
+#endif
+        removeAt(0);
+    }
+}
+
+// Interrupts must already be off
+void RelayEdgeEngine::armCompare() {
+#ifdef ARDUINO
+    if (edgeCount == 0) {
+        TIMSK1 &= ~(1 << OCIE1A);
+        return;
+    }
+    
+    int32_t delta = (int32_t)(queue[0].time - now());
+    if (delta < MIN_ARM_TICKS) delta = MIN_ARM_TICKS;  // Don't arm behind the counter
+    if (delta > MAX_ARM_TICKS) delta = MAX_ARM_TICKS;  // Far edge - wake early and re-arm
+    OCR1A = TCNT1 + (uint16_t)delta;
+    TIFR1 = (1 << OCF1A);
+    TIMSK1 |= (1 << OCIE1A);
+#else
+    if (edgeCount == 0) {
+        emulatedCompareArmed = false;
+        return;
+    }
+    
+    int32_t delta = (int32_t)(queue[0].time - now());
+    if (delta < MIN_ARM_TICKS) delta = MIN_ARM_TICKS;
+    if (delta > MAX_ARM_TICKS) delta = MAX_ARM_TICKS;
+    emulatedCompare = emulatedTicks + (uint32_t)delta;
+    emulatedCompareArmed = true;
+#endif
+}
+
+// Interrupts must already be off
+bool RelayEdgeEngine::zeroCrossLocked(uint32_t currentTicks) {
+    // A couple of missed crossings are tolerated, then edges go back to firing on time
+    return zeroCrossEnabled && halfCycleConfirmed &&
+           currentTicks - lastCrossing < halfCycleTicks * 5 / 2;
+}
+
+// Interrupts must already be off
+void RelayEdgeEngine::syncDueEdges(uint32_t currentTicks) {
+    // First predicted crossing the slower of operate and release can still make
+    uint16_t lead = operateTicks > releaseTicks ? operateTicks : releaseTicks;
+    uint32_t crossing = lastCrossing + halfCycleTicks;
+    while ((int32_t)(crossing - lead - currentTicks) < 0) {
+        crossing += halfCycleTicks;
+    }
+    
+    for (uint8_t i = 0; i < edgeCount; i++) {
+        Edge& edge = queue[i];
+        if (edge.synced || (int32_t)(edge.time - currentTicks) > 0) {
+            continue;
+        }
+        edge.time = crossing - (edge.level == LEVEL_LOW ? operateTicks : releaseTicks);
+        edge.synced = true;
+        // Edges for one pin still switch in the order they were scheduled.
+        // Earlier ones sit ahead of this edge, or anywhere if already synced -
+        // moved to a crossing, they may now sort after it (release leads by
+        // less than operate), so this one goes a tick after them.
+        for (uint8_t j = 0; j < edgeCount; j++) {
+            const Edge& earlier = queue[j];
+            if (j == i || earlier.pin != edge.pin || (j > i && !earlier.synced)) {
+                continue;
+            }
+            int32_t ahead = (int32_t)(earlier.time - edge.time);
+            if (j < i ? ahead > 0 : ahead >= 0) {
+                edge.time = earlier.time + (j > i ? 1 : 0);
+            }
+        }
+    }
+    
+    // Stable insertion sort - the queue is short and nearly in order
+    for (uint8_t i = 1; i < edgeCount; i++) {
+        Edge edge = queue[i];
+        uint8_t j = i;
+        while (j > 0 && (int32_t)(queue[j - 1].time - edge.time) > 0) {
+            queue[j] = queue[j - 1];
+            j--;
+        }
+        queue[j] = edge;
+    }
+    
+    if (crossing != syncedCrossing || syncedBatches == 0) {
+        syncedCrossing = crossing;
+        syncedBatches++;
+    }
+}
+
+void RelayEdgeEngine::removeAt(uint8_t index) {
+    for (uint8_t i = index + 1; i < edgeCount; i++) {
+        queue[i - 1] = queue[i];
+    }
+    edgeCount--;
+}
+
+#ifndef ARDUINO
+void RelayEdgeEngine::emulateAdvance(uint32_t ticks) {
+    uint32_t target = emulatedTicks + ticks;
+    for (;;) {
+        bool compareDue = emulatedCompareArmed && (int32_t)(emulatedCompare - target) <= 0;
+        bool crossingDue = emulatedHalfCycle != 0 && (int32_t)(emulatedNextCrossing - target) <= 0;
+        if (crossingDue && (!compareDue || (int32_t)(emulatedNextCrossing - emulatedCompare) <= 0)) {
+            emulatedTicks = emulatedNextCrossing;
+            emulatedNextCrossing += emulatedHalfCycle;
+            handleZeroCross();
+        } else if (compareDue) {
+            emulatedTicks = emulatedCompare;
+            handleCompare();
+        } else {
+            break;
+        }
+    }
+    emulatedTicks = target;
+}
+
+void RelayEdgeEngine::emulateZeroCross(uint32_t halfCycleTicks) {
+    emulatedHalfCycle = halfCycleTicks;
+    emulatedNextCrossing = emulatedTicks + halfCycleTicks;
+}
+#endif
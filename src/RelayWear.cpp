@@ -0,0 +1,131 @@
+#include "RelayWear.h"
+#include "SettingsManager.h"
+#include "Features.h"
+
+RelayWear::RelayWear() {
+    memset(counts, 0, sizeof(counts));
+    memset(bucketMasks, 0, sizeof(bucketMasks));
+    relayCount = 0;
+    baseLevel = 0;
+    sequence = 0;
+    nextSlot = 0;
+    dirty = false;
+}
+
+void RelayWear::begin(uint8_t relayCount) {
+    this->relayCount = relayCount < MAX_RELAYS ? relayCount : MAX_RELAYS;
+    memset(counts, 0, sizeof(counts));
+    sequence = 0;
+    nextSlot = 0;
+
+    // Newest valid slot wins - a save cut short by a reset leaves the previous one intact
+    bool found = false;
+    for (uint8_t slot = 0; slot < SAVE_SLOTS; slot++) {
+        Record record;
+        EEPROM.get(slotAddress(slot), record);
+        if (record.version != WEAR_RECORD_VERSION || record.checksum != calculateChecksum(record)) {
+            continue;
+        }
+        if (!found || (int16_t)(record.sequence - sequence) > 0) {
+            memcpy(counts, record.counts, sizeof(counts));
+            sequence = record.sequence;
+            nextSlot = (slot + 1) % SAVE_SLOTS;
+            found = true;
+        }
+    }
+
+    dirty = false;
+    rebuildBuckets();
+}
+
+void RelayWear::recordOperation(uint8_t relay) {
+    if (relay >= relayCount) {
+        return;
+    }
+    counts[relay]++;
+    dirty = true;
+    if (counts[relay] % LEVEL_SIZE == 0) {
+        rebuildBuckets();  // Moved up a level
+    }
+}
+
+uint8_t RelayWear::leastWorn(uint8_t candidates) const {
+    for (uint8_t bucket = 0; bucket < BUCKETS; bucket++) {
+        uint8_t matches = bucketMasks[bucket] & candidates;
+        if (matches) {
+            return __builtin_ctz(matches);
+        }
+    }
+    return NO_RELAY;
+}
+
+uint32_t RelayWear::getCount(uint8_t relay) const {
+    return relay < relayCount ? counts[relay] : 0;
+}
+
+uint8_t RelayWear::getRelayCount() const {
+    return relayCount;
+}
+
+void RelayWear::save() {
+    if (!dirty) {
+        return;
+    }
+
+    Record record;
+    record.version = WEAR_RECORD_VERSION;
+    record.sequence = ++sequence;
+    memcpy(record.counts, counts, sizeof(counts));
+    record.checksum = calculateChecksum(record);
+
+    // EEPROM.put() only rewrites bytes that changed
+    EEPROM.put(slotAddress(nextSlot), record);
+    nextSlot = (nextSlot + 1) % SAVE_SLOTS;
+    dirty = false;
+}
+
+bool RelayWear::isDirty() const {
+    return dirty;
+}
+
+void RelayWear::printStatus() const {
+    DebugSerial.print(F("Relay wear:"));
+    for (uint8_t relay = 0; relay < relayCount; relay++) {
+        DebugSerial.print(F(" "));
+        DebugSerial.print(relay + 1);
+        DebugSerial.print(F(":"));
+        DebugSerial.print(counts[relay]);
+    }
+    DebugSerial.println();
+}
+
+void RelayWear::rebuildBuckets() {
+    memset(bucketMasks, 0, sizeof(bucketMasks));
+    if (relayCount == 0) {
+        return;
+    }
+
+    baseLevel = counts[0] / LEVEL_SIZE;
+    for (uint8_t relay = 1; relay < relayCount; relay++) {
+        baseLevel = min(baseLevel, counts[relay] / LEVEL_SIZE);
+    }
+    for (uint8_t relay = 0; relay < relayCount; relay++) {
+        uint32_t offset = counts[relay] / LEVEL_SIZE - baseLevel;
+        uint8_t bucket = offset < BUCKETS ? offset : BUCKETS - 1;
+        bucketMasks[bucket] |= (1 << relay);
+    }
+}
+
+int RelayWear::slotAddress(uint8_t slot) {
+    return EEPROM_WEAR_ADDR + slot * sizeof(Record);
+}
+
+uint8_t RelayWear::calculateChecksum(const Record& record) {
+    // XOR of every byte before the checksum, seeded so a blank record is invalid
+    const uint8_t* bytes = (const uint8_t*)&record;
+    uint8_t checksum = 0x5A;
+    for (size_t i = 0; i < offsetof(Record, checksum); i++) {
+        checksum ^= bytes[i];
+    }
+    return checksum;
+}
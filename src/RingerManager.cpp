@@ -1,4 +1,5 @@
 #include "RingerManager.h"
+#include "Features.h"
 // #include "Config.h"  // Commented out for now to avoid dependencies
 
 RingerManager::RingerManager() {
@@ -7,6 +8,17 @@ RingerManager::RingerManager() {
     lastStatusPrint = 0;
     enableSerialOutput = true;  // Default to enabled
     activeRelayCount = 8;       // Default to all relays active
+    randomSeedValue = 1;
+    arrivalMode = false;
+    blockedArrivals = 0;
+    maxConcurrent = 8;
+    activeCallCount = 0;
+    waitQueueHead = 0;
+    waitQueueCount = 0;
+    relayPins = nullptr;
+    wear = nullptr;
+    stats = nullptr;
+    busyRelays = 0;
 }
 
 RingerManager::~RingerManager() {
@@ -22,29 +34,85 @@ void RingerManager::initialize(const int* relayPins, int numPhones, const System
     }
     
     this->enableSerialOutput = enableSerialOutput;  // Store the flag
-    phoneCount = numPhones;
+    phoneCount = min(numPhones, (int)RelayWear::MAX_RELAYS);
     systemConfig = config;
+    this->relayPins = relayPins;
+    busyRelays = 0;
+    for (int i = 0; i < phoneCount; i++) {
+        relayOf[i] = i;
+        lineOf[i] = i;
+    }
     ringers = new TelephoneRinger[phoneCount];
     
-    // Initialize each ringer with its relay pin and configuration
+    // Initialize each ringer with its own random stream, relay pin and configuration
     for (int i = 0; i < phoneCount; i++) {
+        ringers[i].seedRandom(randomSeedValue, i);
+        ringers[i].setClock(&clock);
         ringers[i].initialize(relayPins[i], config, enableSerialOutput);
     }
     
-    lastStatusPrint = millis();
+    lastStatusPrint = clock.now();
     
     if (enableSerialOutput) {
-        Serial.print("RingerManager initialized with ");
-        Serial.print(phoneCount);
-        Serial.println(" phones");
+        DebugSerial.print("RingerManager initialized with ");
+        DebugSerial.print(phoneCount);
+        DebugSerial.println(" phones");
     }
 }
 
-void RingerManager::step(unsigned long currentTime) {
+void RingerManager::seedRandom(uint32_t seed) {
+    randomSeedValue = seed;
+    for (int i = 0; i < phoneCount; i++) {
+        ringers[i].seedRandom(seed, i);
+    }
+    // Arrival stream sits after the last line's stream
+    arrivals.seed(seed, 0xFF);
+}
+
+uint32_t RingerManager::getRandomSeed() const {
+    return randomSeedValue;
+}
+
+void RingerManager::step(unsigned long realTime) {
+    if (clock.isPaused()) {
+        return;  // Even work that fell due at the moment of pausing waits for resume
+    }
+    unsigned long currentTime = clock.toVirtual(realTime);
+    
     // Step only active relays
     int activeCount = min(activeRelayCount, phoneCount);
     for (int i = 0; i < activeCount; i++) {
-        ringers[i].step(currentTime);
+        switch (ringers[i].step(currentTime)) {
+            case TelephoneRinger::EVENT_CALL_REQUEST:
+                requestSlot(i, currentTime);
+                break;
+            case TelephoneRinger::EVENT_RING_ON:
+                ringStarted(i, currentTime);
+                break;
+            case TelephoneRinger::EVENT_RING_OFF:
+                if (stats) {
+                    stats->ringOff(i, currentTime);
+                }
+                EventBus::publish(EventBus::RING_OFF, i);
+                break;
+            case TelephoneRinger::EVENT_CALL_ENDED:
+                callFinished(i, ringers[i].isCutShort(), currentTime);
+                releaseRelay(i);
+                EventBus::publish(EventBus::CALL_ENDED, i);
+                // Longest-waiting line gets the slot on this same pass, started at
+                // this pass's time - a later line is stepped with it just below
+                releaseSlot(currentTime);
+                break;
+            default:
+                break;
+        }
+    }
+    
+    // Hand due arrivals to a free line - a caller who finds every line busy hangs up
+    if (arrivalMode && arrivals.poll(currentTime)) {
+        if (!routeArrival(currentTime)) {
+            blockedArrivals++;
+        }
     }
     
     // Periodically print status only if serial output is enabled
@@ -54,58 +122,321 @@ void RingerManager::step(unsigned long currentTime) {
     }
 }
 
+unsigned long RingerManager::getTimeToNextEvent(unsigned long realTime) const {
+    if (clock.isPaused()) {
+        return TelephoneRinger::NO_DEADLINE;
+    }
+    unsigned long currentTime = clock.toVirtual(realTime);
+    unsigned long next = TelephoneRinger::NO_DEADLINE;
+    
+    int activeCount = min(activeRelayCount, phoneCount);
+    for (int i = 0; i < activeCount; i++) {
+        unsigned long lineNext = ringers[i].getTimeToNextEvent(currentTime);
+        if (lineNext < next) next = lineNext;
+    }
+    
+    if (arrivalMode) {
+        unsigned long arrivalNext = arrivals.getTimeToNextArrival(currentTime);
+        if (arrivalNext < next) next = arrivalNext;
+    }
+    
+    if (enableSerialOutput) {
+        unsigned long sincePrint = currentTime - lastStatusPrint;
+        unsigned long printNext = (sincePrint >= STATUS_PRINT_INTERVAL) ? 0 : STATUS_PRINT_INTERVAL - sincePrint;
+        if (printNext < next) next = printNext;
+    }
+    
+    return next;
+}
+
 void RingerManager::startCall(int phoneIndex, int ringCount, bool cutShort, bool useUKStyle) {
     if (phoneIndex >= 0 && phoneIndex < phoneCount) {
+        if (!ringers[phoneIndex].isActive()) {
+            removeFromWaitQueue(phoneIndex);
+            activeCallCount++;
+            claimRelay(phoneIndex);
+        }
         ringers[phoneIndex].startCall(ringCount, cutShort, useUKStyle);
+        unsigned long currentTime = clock.now();
+        if (stats) {
+            stats->callStarted(phoneIndex, currentTime);
+        }
+        EventBus::publish(EventBus::CALL_STARTED, phoneIndex);
+        ringStarted(phoneIndex, currentTime);
     }
 }
 
 void RingerManager::startCall(int phoneIndex) {
     if (phoneIndex >= 0 && phoneIndex < phoneCount) {
-        ringers[phoneIndex].startCall();
+        if (!ringers[phoneIndex].isActive()) {
+            removeFromWaitQueue(phoneIndex);
+            activeCallCount++;
+            claimRelay(phoneIndex);
+        }
+        beginCall(phoneIndex, clock.now());
     }
 }
 
 void RingerManager::stopCall(int phoneIndex) {
     if (phoneIndex >= 0 && phoneIndex < phoneCount) {
+        bool wasActive = ringers[phoneIndex].isActive();
+        removeFromWaitQueue(phoneIndex);
         ringers[phoneIndex].stopCall();
+        if (wasActive) {
+            callFinished(phoneIndex, false, clock.now());
+            releaseRelay(phoneIndex);
+            EventBus::publish(EventBus::CALL_ENDED, phoneIndex);
+            releaseSlot(clock.now());
+        }
     }
 }
 
 void RingerManager::stopAllCalls() {
+    // Empty the queue first so freed slots aren't handed straight back out
+    waitQueueCount = 0;
     for (int i = 0; i < phoneCount; i++) {
+        if (ringers[i].isActive()) {
+            callFinished(i, false, clock.now());
+            EventBus::publish(EventBus::CALL_ENDED, i);
+        }
         ringers[i].stopCall();
     }
+    activeCallCount = 0;
+    busyRelays = 0;
 }
 
-void RingerManager::setCanStartCallCallback(bool (*callback)()) {
-    // This method sets the callback for the manager itself (future use)
-    // For now, we'll implement the method that sets it for all phones
+void RingerManager::setMaxConcurrent(int limit) {
+    maxConcurrent = max(1, limit);
+    
+    // A raised limit admits waiting lines right away
+    admitWaitingLines(clock.now());
+}
+
+int RingerManager::getMaxConcurrent() const {
+    return maxConcurrent;
+}
+
+int RingerManager::getQueuedLineCount() const {
+    return waitQueueCount;
 }
 
-void RingerManager::setCanStartCallCallbackForAllPhones(bool (*callback)()) {
+void RingerManager::requestSlot(int phoneIndex, unsigned long currentTime) {
+    if (activeCallCount < maxConcurrent && waitQueueCount == 0) {
+        activeCallCount++;
+        claimRelay(phoneIndex);
+        beginCall(phoneIndex, currentTime);
+        return;
+    }
+    
+    // No slot (or others are already waiting) - join the back of the queue
+    if (waitQueueCount < MAX_WAITING_LINES) {
+        ringers[phoneIndex].queueCall();
+        waitQueue[(waitQueueHead + waitQueueCount) % MAX_WAITING_LINES] = phoneIndex;
+        waitQueueCount++;
+    }
+}
+
+void RingerManager::releaseSlot(unsigned long currentTime) {
+    if (activeCallCount > 0) {
+        activeCallCount--;
+    }
+    admitWaitingLines(currentTime);
+}
+
+void RingerManager::admitWaitingLines(unsigned long currentTime) {
+    while (waitQueueCount > 0 && activeCallCount < maxConcurrent) {
+        uint8_t phoneIndex = waitQueue[waitQueueHead];
+        waitQueueHead = (waitQueueHead + 1) % MAX_WAITING_LINES;
+        waitQueueCount--;
+        
+        activeCallCount++;
+        claimRelay(phoneIndex);
+        beginCall(phoneIndex, currentTime);
+    }
+}
+
+void RingerManager::beginCall(int phoneIndex, unsigned long currentTime) {
+    ringers[phoneIndex].startCallAt(currentTime);
+    if (stats) {
+        stats->callStarted(phoneIndex, currentTime);
+    }
+    // The first ring starts with the call
+    EventBus::publish(EventBus::CALL_STARTED, phoneIndex);
+    ringStarted(phoneIndex, currentTime);
+}
+
+void RingerManager::claimRelay(int phoneIndex) {
+    if (wear) {
+        // The line's own relay is free too, so there is always a candidate
+        uint8_t relay = wear->leastWorn(~busyRelays & ((1 << phoneCount) - 1));
+        uint8_t current = relayOf[phoneIndex];
+        if (relay != RelayWear::NO_RELAY && relay != current) {
+            // Its line is idle (or beyond the active count) - trade relays with it
+            uint8_t other = lineOf[relay];
+            relayOf[phoneIndex] = relay;
+            lineOf[relay] = phoneIndex;
+            relayOf[other] = current;
+            lineOf[current] = other;
+            ringers[phoneIndex].setRelayPin(relayPins[relay]);
+            ringers[other].setRelayPin(relayPins[current]);
+        }
+    }
+    busyRelays |= 1 << relayOf[phoneIndex];
+}
+
+void RingerManager::releaseRelay(int phoneIndex) {
+    busyRelays &= ~(1 << relayOf[phoneIndex]);
+}
+
+void RingerManager::ringStarted(int phoneIndex, unsigned long currentTime) {
+    if (wear) {
+        wear->recordOperation(relayOf[phoneIndex]);
+    }
+    if (stats) {
+        stats->ringOn(phoneIndex, currentTime);
+    }
+    EventBus::publish(EventBus::RING_ON, phoneIndex);
+}
+
+// Stopped calls never count as answered, whatever their plan said
+void RingerManager::callFinished(int phoneIndex, bool answered, unsigned long currentTime) {
+    if (stats) {
+        stats->callEnded(phoneIndex, ringers[phoneIndex].getRingCount(), answered, currentTime);
+    }
+}
+
+void RingerManager::removeFromWaitQueue(int phoneIndex) {
+    // Compact the ring buffer in place, keeping everyone else's order
+    uint8_t kept = 0;
+    for (uint8_t n = 0; n < waitQueueCount; n++) {
+        uint8_t entry = waitQueue[(waitQueueHead + n) % MAX_WAITING_LINES];
+        if (entry != phoneIndex) {
+            waitQueue[(waitQueueHead + kept) % MAX_WAITING_LINES] = entry;
+            kept++;
+        }
+    }
+    waitQueueCount = kept;
+}
+
+void RingerManager::setArrivalMode(bool enabled) {
+    arrivalMode = enabled;
     for (int i = 0; i < phoneCount; i++) {
-        ringers[i].setCanStartCallCallback(callback);
+        ringers[i].setAutoCall(!enabled);
     }
+    arrivals.reset(clock.now());
+}
+
+void RingerManager::setHardwareEdges(bool enabled) {
+    for (int i = 0; i < phoneCount; i++) {
+        ringers[i].setHardwareEdges(enabled);
+    }
+}
+
+void RingerManager::pause(unsigned long currentTime) {
+    clock.pause(currentTime);
+    // Relays off now, but the call state machines stay where they are
+    RelayEdgeEngine::cancelAll();
+    for (int i = 0; i < phoneCount; i++) {
+        digitalWrite(relayPins[i], HIGH); // HIGH = inactive for active-LOW relay modules
+    }
+}
+
+void RingerManager::resume(unsigned long currentTime) {
+    clock.resume(currentTime);
+    unsigned long virtualTime = clock.toVirtual(currentTime);
+    int activeCount = min(activeRelayCount, phoneCount);
+    for (int i = 0; i < activeCount; i++) {
+        ringers[i].resyncRelay(virtualTime);
+    }
+}
+
+bool RingerManager::isPaused() const {
+    return clock.isPaused();
+}
+
+const VirtualClock& RingerManager::getClock() const {
+    return clock;
+}
+
+void RingerManager::setWearBalancing(RelayWear* wear) {
+    this->wear = wear;
+}
+
+void RingerManager::setStatistics(CallStats* stats) {
+    this->stats = stats;
+    if (stats) {
+        stats->reset(clock.now());
+    }
+}
+
+int RingerManager::getRelayForLine(int phoneIndex) const {
+    if (phoneIndex >= 0 && phoneIndex < phoneCount) {
+        return relayOf[phoneIndex];
+    }
+    return -1;
+}
+
+bool RingerManager::isArrivalMode() const {
+    return arrivalMode;
+}
+
+void RingerManager::setCallsPerHour(uint16_t callsPerHour) {
+    arrivals.setCallsPerHour(callsPerHour);
+}
+
+unsigned long RingerManager::getArrivalCount() const {
+    return arrivals.getArrivalCount();
+}
+
+unsigned long RingerManager::getBlockedArrivalCount() const {
+    return blockedArrivals;
+}
+
+bool RingerManager::routeArrival(unsigned long currentTime) {
+    int activeCount = min(activeRelayCount, phoneCount);
+    if (activeCount <= 0) {
+        return false;
+    }
+    
+    // Start the scan at a random line so free lines are picked evenly
+    int start = arrivals.pickLine(activeCount);
+    for (int n = 0; n < activeCount; n++) {
+        int i = (start + n) % activeCount;
+        if (!ringers[i].isActive() && !ringers[i].isQueued()) {
+            // Rings now if a slot is free, otherwise holds in the queue
+            requestSlot(i, currentTime);
+            return true;
+        }
+    }
+    return false;
 }
 
 void RingerManager::setActiveRelayCount(int count) {
+    int previousCount = activeRelayCount;
     activeRelayCount = max(0, min(count, phoneCount));
     
+    for (int i = previousCount; i < activeRelayCount; i++) {
+        EventBus::publish(EventBus::LINE_ENABLED, i);
+    }
+    
+    // Drop disabled phones from the queue first so a freed slot can't go to one of them
+    for (int i = activeRelayCount; i < phoneCount; i++) {
+        removeFromWaitQueue(i);
+    }
+    
     // Stop calls on phones that are now inactive
     for (int i = activeRelayCount; i < phoneCount; i++) {
-        ringers[i].stopCall();
+        stopCall(i);
+    }
+    
+    for (int i = activeRelayCount; i < previousCount && i < phoneCount; i++) {
+        EventBus::publish(EventBus::LINE_DISABLED, i);
     }
 }
 
 int RingerManager::getActiveCallCount() const {
-    int count = 0;
-    for (int i = 0; i < phoneCount; i++) {
-        if (ringers[i].isActive()) {
-            count++;
-        }
-    }
-    return count;
+    // Maintained by the admission counter, no need to scan the lines
+    return activeCallCount;
 }
 
 int RingerManager::getRingingPhoneCount() const {
@@ -147,31 +478,56 @@ void RingerManager::printStatus() const {
     int activeCalls = getActiveCallCount();
     int ringingPhones = getRingingPhoneCount();
     
-    Serial.print(F("Status: "));
-    Serial.print(activeCalls);
-    Serial.print(F(" active calls, "));
-    Serial.print(ringingPhones);
-    Serial.print(F(" phones ringing out of "));
-    Serial.print(phoneCount);
-    Serial.println(F(" total phones"));
+    DebugSerial.print(F("Status: "));
+    DebugSerial.print(activeCalls);
+    DebugSerial.print(F(" active calls, "));
+    DebugSerial.print(ringingPhones);
+    DebugSerial.print(F(" phones ringing out of "));
+    DebugSerial.print(phoneCount);
+    DebugSerial.println(F(" total phones"));
     
     // Print individual phone status (cap at 8 phones for safety)
-    Serial.print(F("Phones: "));
+    DebugSerial.print(F("Phones: "));
     int maxPhonesToShow = min(phoneCount, 8);  // Safety cap
     for (int i = 0; i < maxPhonesToShow; i++) {
         if (ringers[i].isRinging()) {
-            Serial.print(F("R"));
+            DebugSerial.print(F("R"));
         } else if (ringers[i].isActive()) {
-            Serial.print(F("A"));
+            DebugSerial.print(F("A"));
+        } else if (ringers[i].isQueued()) {
+            DebugSerial.print(F("Q"));
         } else {
-            Serial.print(F("."));
+            DebugSerial.print(F("."));
         }
     }
-    Serial.println(F(" (R=Ringing, A=Active, .=Idle)"));
+    DebugSerial.println(F(" (R=Ringing, A=Active, Q=Queued, .=Idle)"));
     
     // Show concurrent limit information
-    Serial.print(F("Concurrent: "));
-    Serial.print(activeCalls);
-    Serial.print(F(" active (limit enforced by callback system)"));
-    Serial.println();
+    DebugSerial.print(F("Concurrent: "));
+    DebugSerial.print(activeCalls);
+    DebugSerial.print(F("/"));
+    DebugSerial.print(maxConcurrent);
+    DebugSerial.print(F(" active, "));
+    DebugSerial.print(waitQueueCount);
+    DebugSerial.println(F(" lines waiting for a slot"));
+    
+    if (arrivalMode) {
+        DebugSerial.print(F("Arrivals: "));
+        DebugSerial.print(arrivals.getArrivalCount());
+        DebugSerial.print(F(" total, "));
+        DebugSerial.print(blockedArrivals);
+        DebugSerial.print(F(" blocked, rate "));
+        DebugSerial.print(arrivals.getCallsPerHour());
+        DebugSerial.println(F("/hour"));
+    }
+    
+    if (wear) {
+        DebugSerial.print(F("Line relays:"));
+        for (int i = 0; i < phoneCount; i++) {
+            DebugSerial.print(F(" "));
+            DebugSerial.print(relayOf[i] + 1);
+        }
+        DebugSerial.println();
+        wear->printStatus();
+    }
 }
@@ -0,0 +1,175 @@
+#include "ScenarioPlayer.h"
+#include "RingerManager.h"
+
+// Limits of the settings a show can change (same as the menu)
+static const int MAX_LINES = 8;
+static const int MIN_CONCURRENT = 1;
+static const int MIN_CALL_DELAY = 10;
+static const int MAX_CALL_DELAY = 1000;
+
+ScenarioPlayer::ScenarioPlayer() {
+    ringerManager = nullptr;
+    targets.activeLines = nullptr;
+    targets.maxConcurrent = nullptr;
+    targets.callDelay = nullptr;
+    code = nullptr;
+    codeLength = 0;
+    pc = 0;
+    running = false;
+    startTime = 0;
+    waitStart = 0;
+    waitDuration = 0;
+    callsPerHour = 0;
+}
+
+void ScenarioPlayer::initialize(RingerManager* ringerManager, const ScenarioTargets& targets) {
+    this->ringerManager = ringerManager;
+    this->targets = targets;
+}
+
+bool ScenarioPlayer::start(const uint8_t* script, unsigned long currentTime) {
+    if (script == nullptr ||
+        pgm_read_byte(&script[0]) != Scenario::MAGIC ||
+        pgm_read_byte(&script[1]) != Scenario::VERSION) {
+        return false;
+    }
+    code = script + Scenario::HEADER_SIZE;
+    codeLength = pgm_read_byte(&script[2]) | (pgm_read_byte(&script[3]) << 8);
+    pc = 0;
+    startTime = currentTime;
+    waitStart = currentTime;
+    waitDuration = 0;
+    callsPerHour = 0;
+    running = true;
+    return true;
+}
+
+void ScenarioPlayer::stop() {
+    running = false;
+    callsPerHour = 0;
+}
+
+bool ScenarioPlayer::isRunning() const {
+    return running;
+}
+
+unsigned long ScenarioPlayer::step(unsigned long currentTime) {
+    if (!running) {
+        return IDLE_INTERVAL;
+    }
+
+    for (uint8_t ops = 0; ops < MAX_OPS_PER_STEP; ops++) {
+        unsigned long waited = currentTime - waitStart;
+        if (waited < waitDuration) {
+            return waitDuration - waited;
+        }
+
+        // Running off the end is an implicit END, a bad opcode stops the show too
+        uint8_t opcode = pc < codeLength ? fetch8(pc) : (uint8_t)Scenario::OP_END;
+        uint8_t length = Scenario::instructionLength(opcode);
+        if (length == 0 || pc + length > codeLength) {
+            stop();
+            return IDLE_INTERVAL;
+        }
+        execute(opcode, currentTime);
+        if (!running) {
+            return IDLE_INTERVAL;
+        }
+    }
+    return 0;  // Budget used up - carry on next frame
+}
+
+uint16_t ScenarioPlayer::getCallsPerHour() const {
+    return callsPerHour;
+}
+
+unsigned long ScenarioPlayer::getElapsed(unsigned long currentTime) const {
+    return currentTime - startTime;
+}
+
+uint8_t ScenarioPlayer::fetch8(uint16_t offset) const {
+    return pgm_read_byte(&code[offset]);
+}
+
+uint16_t ScenarioPlayer::fetch16(uint16_t offset) const {
+    return fetch8(offset) | (fetch8(offset + 1) << 8);
+}
+
+void ScenarioPlayer::execute(uint8_t opcode, unsigned long currentTime) {
+    uint16_t operand = pc + 1;
+    pc += Scenario::instructionLength(opcode);
+
+    switch (opcode) {
+        case Scenario::OP_END:
+            stop();
+            break;
+
+        case Scenario::OP_WAIT_MS:
+        case Scenario::OP_WAIT_S: {
+            // Waits follow on from the previous one's end, so a late step doesn't shift the whole show
+            unsigned long duration = fetch16(operand);
+            if (opcode == Scenario::OP_WAIT_S) {
+                duration *= 1000UL;
+            }
+            waitStart += waitDuration;
+            if (currentTime - waitStart > duration) {
+                waitStart = currentTime;  // Already a whole wait behind - restart from now
+            }
+            waitDuration = duration;
+            break;
+        }
+
+        case Scenario::OP_LINES:
+            if (targets.activeLines) {
+                *targets.activeLines = min((int)fetch8(operand), MAX_LINES);
+            }
+            break;
+
+        case Scenario::OP_CONCURRENT:
+            if (targets.maxConcurrent) {
+                *targets.maxConcurrent = constrain((int)fetch8(operand), MIN_CONCURRENT, MAX_LINES);
+            }
+            break;
+
+        case Scenario::OP_DELAY:
+            if (targets.callDelay) {
+                *targets.callDelay = constrain((int)fetch16(operand), MIN_CALL_DELAY, MAX_CALL_DELAY);
+            }
+            break;
+
+        case Scenario::OP_RATE:
+            callsPerHour = fetch16(operand);
+            break;
+
+        case Scenario::OP_CALL: {
+            uint8_t line = fetch8(operand);
+            uint8_t rings = fetch8(operand + 1);
+            uint8_t flags = fetch8(operand + 2);
+            // A disabled line is never stepped - its call would ring and hold a slot for good.
+            // Checked against the setting, so a "lines" earlier in the same step counts.
+            if (targets.activeLines && line >= *targets.activeLines) {
+                break;
+            }
+            if (rings == 0) {
+                ringerManager->startCall(line);
+            } else {
+                ringerManager->startCall(line, rings, flags & Scenario::CALL_CUT_SHORT, flags & Scenario::CALL_UK_STYLE);
+            }
+            break;
+        }
+
+        case Scenario::OP_HANGUP: {
+            uint8_t line = fetch8(operand);
+            if (line == Scenario::ALL_LINES) {
+                ringerManager->stopAllCalls();
+            } else {
+                ringerManager->stopCall(line);
+            }
+            break;
+        }
+
+        case Scenario::OP_JUMP:
+            pc = fetch16(operand);
+            break;
+    }
+}
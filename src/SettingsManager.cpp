@@ -105,3 +105,37 @@ uint8_t SettingsManager::calculateChecksum(const Settings& settings) {
     
     return checksum;
 }
+
+bool SettingsManager::loadBootCache(BootCache& cache) {
+    EEPROM.get(EEPROM_BOOT_CACHE_ADDR, cache);
+    
+    if (cache.version != BOOT_CACHE_VERSION || cache.checksum != calculateChecksum(cache)) {
+        // Uninitialized or corrupted - nothing cached, probe everything
+        cache.version = BOOT_CACHE_VERSION;
+        cache.lcdAddress = 0;
+        cache.checksum = 0;
+        return false;
+    }
+    
+    return true;
+}
+
+bool SettingsManager::saveBootCache(const BootCache& cache) {
+    BootCache cacheToSave = cache;
+    cacheToSave.version = BOOT_CACHE_VERSION;
+    cacheToSave.checksum = calculateChecksum(cacheToSave);
+    
+    // EEPROM.put() only rewrites bytes that changed
+    EEPROM.put(EEPROM_BOOT_CACHE_ADDR, cacheToSave);
+    
+    return true;
+}
+
+uint8_t SettingsManager::calculateChecksum(const BootCache& cache) {
+    // Same XOR scheme as settings, seeded so an all-zero record is invalid
+    uint8_t checksum = 0xA5;
+    checksum ^= cache.version;
+    checksum ^= cache.lcdAddress;
+    
+    return checksum;
+}
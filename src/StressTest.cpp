@@ -0,0 +1,230 @@
+#include "StressTest.h"
+#include "Features.h"
+#include "StringUtils.h"
+
+// Upper bounds (us) of the loop period buckets
+const uint16_t StressTest::PERIOD_LIMITS[PERIOD_BUCKETS - 1] = { 100, 250, 500, 1000, 2000, 5000, 10000 };
+
+// Scripted input: after the menu round trip, this many idle steps let the status screen run
+static const uint8_t IDLE_INPUT_STEPS = 25;
+
+// Pattern left in free RAM by paintStack()
+static const uint8_t STACK_PAINT = 0xC5;
+static const uint16_t STACK_UNKNOWN = 0xFFFF;
+
+#ifdef ARDUINO
+extern uint8_t __heap_start;
+extern void* __brkval;
+#endif
+
+StressTest::StressTest() {
+    running = false;
+    startTime = 0;
+    duration = DEFAULT_DURATION;
+    elapsed = 0;
+    lastLoopMicros = 0;
+    loopCount = 0;
+    maxPeriod = 0;
+    lcdFrames = 0;
+    lcdTotalMicros = 0;
+    lcdMaxMicros = 0;
+    inputStep = 0;
+    freeStack = STACK_UNKNOWN;
+    memset(periodCounts, 0, sizeof(periodCounts));
+}
+
+void StressTest::start(unsigned long now, unsigned long duration) {
+    this->duration = duration;
+    startTime = now;
+    elapsed = 0;
+    memset(periodCounts, 0, sizeof(periodCounts));
+    loopCount = 0;
+    maxPeriod = 0;
+    lcdFrames = 0;
+    lcdTotalMicros = 0;
+    lcdMaxMicros = 0;
+    inputStep = 0;
+    freeStack = STACK_UNKNOWN;
+
+    paintStack();
+    lastLoopMicros = micros();
+    running = true;
+}
+
+void StressTest::stop() {
+    if (!running) return;
+    running = false;
+    elapsed = millis() - startTime;
+    freeStack = measureStack();
+}
+
+bool StressTest::isRunning() const {
+    return running;
+}
+
+bool StressTest::isFinished(unsigned long now) const {
+    return running && now - startTime >= duration;
+}
+
+void StressTest::recordLoop(unsigned long nowMicros) {
+    unsigned long period = nowMicros - lastLoopMicros;
+    lastLoopMicros = nowMicros;
+
+    uint8_t bucket = 0;
+    while (bucket < PERIOD_BUCKETS - 1 && period >= PERIOD_LIMITS[bucket]) {
+        bucket++;
+    }
+    periodCounts[bucket]++;
+    loopCount++;
+    maxPeriod = max(maxPeriod, period);
+}
+
+void StressTest::recordLcd(unsigned long lcdMicros) {
+    lcdFrames++;
+    lcdTotalMicros += lcdMicros;
+    lcdMaxMicros = max(lcdMaxMicros, lcdMicros);
+}
+
+EncoderManager::EncoderEvent StressTest::nextInput(uint8_t menuItemCount) {
+    // Press, scroll down, up, down again, press - then idle
+    uint8_t scroll = menuItemCount > 1 ? menuItemCount - 1 : 1;
+    uint8_t cycle = 3 * scroll + 2 + IDLE_INPUT_STEPS;
+    uint8_t step = inputStep;
+    inputStep = (inputStep + 1) % cycle;
+
+    if (step == 0) {
+        return EncoderManager::BUTTON_PRESS;
+    }
+    step--;
+    if (step < scroll) {
+        return EncoderManager::CLOCKWISE;
+    }
+    step -= scroll;
+    if (step < scroll) {
+        return EncoderManager::COUNTER_CLOCKWISE;
+    }
+    step -= scroll;
+    if (step < scroll) {
+        return EncoderManager::CLOCKWISE;
+    }
+    step -= scroll;
+    return step == 0 ? EncoderManager::BUTTON_PRESS : EncoderManager::NONE;
+}
+
+bool StressTest::passed(unsigned long edgeLatenessMicros) const {
+    if (edgeLatenessMicros > MAX_EDGE_LATENESS) {
+        return false;
+    }
+    return freeStack == STACK_UNKNOWN || freeStack >= MIN_FREE_STACK;
+}
+
+uint16_t StressTest::getFreeStack() const {
+    return freeStack;
+}
+
+void StressTest::printReport(unsigned long edgeLatenessMicros, uint16_t overruns) const {
+    DebugSerial.print(F("Stress test: "));
+    DebugSerial.print(passed(edgeLatenessMicros) ? F("PASS") : F("FAIL"));
+    DebugSerial.print(F(", "));
+    DebugSerial.print(elapsed);
+    DebugSerial.println(F("ms"));
+
+    DebugSerial.print(F("  Loops: "));
+    DebugSerial.print(loopCount);
+    DebugSerial.print(F(", avg period "));
+    DebugSerial.print(loopCount ? (elapsed * 1000UL) / loopCount : 0);
+    DebugSerial.print(F("us, max "));
+    DebugSerial.print(maxPeriod);
+    DebugSerial.println(F("us"));
+
+    DebugSerial.print(F("  Periods:"));
+    for (uint8_t i = 0; i < PERIOD_BUCKETS; i++) {
+        DebugSerial.print(i < PERIOD_BUCKETS - 1 ? F(" <") : F(" >="));
+        DebugSerial.print(PERIOD_LIMITS[i < PERIOD_BUCKETS - 1 ? i : i - 1]);
+        DebugSerial.print(F("us:"));
+        DebugSerial.print(periodCounts[i]);
+    }
+    DebugSerial.println();
+
+    DebugSerial.print(F("  Relay edge max late: "));
+    DebugSerial.print(edgeLatenessMicros);
+    DebugSerial.print(F("us (limit "));
+    DebugSerial.print(MAX_EDGE_LATENESS);
+    DebugSerial.print(F("us), task overruns: "));
+    DebugSerial.println(overruns);
+
+    DebugSerial.print(F("  LCD: "));
+    DebugSerial.print(lcdFrames);
+    DebugSerial.print(F(" redraws, avg "));
+    DebugSerial.print(lcdFrames ? lcdTotalMicros / lcdFrames : 0);
+    DebugSerial.print(F("us, max "));
+    DebugSerial.print(lcdMaxMicros);
+    DebugSerial.println(F("us"));
+
+    DebugSerial.print(F("  Free stack: "));
+    if (freeStack == STACK_UNKNOWN) {
+        DebugSerial.println(F("n/a"));
+    } else {
+        DebugSerial.print(freeStack);
+        DebugSerial.print(F(" bytes (limit "));
+        DebugSerial.print(MIN_FREE_STACK);
+        DebugSerial.println(F(")"));
+    }
+}
+
+void StressTest::formatSummary(char lines[4][21], unsigned long edgeLatenessMicros, uint16_t overruns) const {
+    LineWriter line0(lines[0], 21);
+    line0.text(passed(edgeLatenessMicros) ? "STRESS PASS " : "STRESS FAIL ");
+    line0.number(elapsed / 1000);
+    line0.character('s');
+    
+    LineWriter line1(lines[1], 21);
+    line1.text("Loop max ");
+    line1.number(maxPeriod);
+    line1.text("us");
+    
+    LineWriter line2(lines[2], 21);
+    line2.text("Edge ");
+    line2.number(edgeLatenessMicros);
+    line2.text("us Ovr ");
+    line2.number(overruns);
+    
+    LineWriter line3(lines[3], 21);
+    line3.text("LCD ");
+    line3.number(lcdMaxMicros);
+    line3.text("us");
+    if (freeStack != STACK_UNKNOWN) {
+        line3.text(" Stk ");
+        line3.number(freeStack);
+    }
+}
+
+#ifdef ARDUINO
+void StressTest::paintStack() {
+    // Everything between the top of the heap and this frame is free right now
+    uint8_t* p = __brkval ? (uint8_t*)__brkval : &__heap_start;
+    uint8_t* top = (uint8_t*)SP - 16;
+    while (p < top) {
+        *p++ = STACK_PAINT;
+    }
+}
+
+uint16_t StressTest::measureStack() {
+    // The stack grows down into the paint - count what it never reached
+    const uint8_t* p = __brkval ? (const uint8_t*)__brkval : &__heap_start;
+    uint16_t untouched = 0;
+    while (p < (const uint8_t*)SP && *p == STACK_PAINT) {
+        p++;
+        untouched++;
+    }
+    return untouched;
+}
+#else
+// Host build - the stack isn't the firmware's, so there's nothing to measure
+void StressTest::paintStack() {
+}
+
+uint16_t StressTest::measureStack() {
+    return STACK_UNKNOWN;
+}
+#endif
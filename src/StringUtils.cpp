@@ -46,3 +46,69 @@ void centerStringToGlobalBuffer(const char* str, int length) {
     // Null terminate
     globalStringBuffer[length] = '\0';
 }
+
+LineWriter::LineWriter(char* buffer, uint8_t size) : buffer(buffer), size(size), used(0) {
+    if (size > 0) {
+        buffer[0] = '\0';
+    }
+}
+
+void LineWriter::text(const char* str) {
+    while (*str) {
+        character(*str++);
+    }
+}
+
+void LineWriter::character(char c) {
+    if (used + 1 < size) {
+        buffer[used++] = c;
+        buffer[used] = '\0';
+    }
+}
+
+void LineWriter::spaces(uint8_t count) {
+    while (count-- > 0) {
+        character(' ');
+    }
+}
+
+void LineWriter::number(long value) {
+    if (value < 0) {
+        character('-');
+        digits(0UL - (unsigned long)value, 0, '0');
+    } else {
+        digits(value, 0, '0');
+    }
+}
+
+void LineWriter::paddedNumber(unsigned long value, uint8_t width, char fill) {
+    digits(value, width, fill);
+}
+
+void LineWriter::padTo(uint8_t width) {
+    while (used < width && used + 1 < size) {
+        character(' ');
+    }
+}
+
+uint8_t LineWriter::length() const {
+    return used;
+}
+
+void LineWriter::digits(unsigned long value, uint8_t width, char fill) {
+    // Generated backwards - an unsigned long has at most 10 digits
+    char reversed[10];
+    uint8_t count = 0;
+    do {
+        reversed[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+    
+    while (width > count) {
+        character(fill);
+        width--;
+    }
+    while (count > 0) {
+        character(reversed[--count]);
+    }
+}
@@ -0,0 +1,125 @@
+#include "TaskScheduler.h"
+#include "Features.h"
+
+TaskScheduler::TaskScheduler() {
+    taskCount = 0;
+    frameTime = 0;
+    frameCount = 0;
+}
+
+int8_t TaskScheduler::addTask(const __FlashStringHelper* name, TaskFunction function, unsigned long initialDelay) {
+    if (taskCount >= MAX_TASKS || function == nullptr) {
+        return INVALID_TASK;
+    }
+    
+    Task& task = tasks[taskCount];
+    task.name = name;
+    task.function = function;
+    task.lastRun = millis();
+    task.interval = initialDelay;
+    task.overruns = 0;
+    task.maxLateness = 0;
+    task.maxRunTime = 0;
+    task.runCount = 0;
+    
+    return taskCount++;
+}
+
+void TaskScheduler::run() {
+    // One clock reading per frame, shared by every task
+    frameTime = millis();
+    frameCount++;
+    
+    for (uint8_t i = 0; i < taskCount; i++) {
+        Task& task = tasks[i];
+        unsigned long elapsed = frameTime - task.lastRun;
+        if ((long)elapsed < 0) {
+            elapsed = 0;    // Woken by an earlier task in this frame, after the clock was read
+        }
+        if (elapsed < task.interval) {
+            continue;
+        }
+        
+        // Late by a whole interval (or more) means at least one run was missed
+        unsigned long lateness = elapsed - task.interval;
+        if (task.interval > 0 && lateness >= task.interval) {
+            task.overruns++;
+        }
+        if (lateness > task.maxLateness) {
+            task.maxLateness = min(lateness, 0xFFFFUL);
+        }
+        
+        unsigned long startMicros = micros();
+        unsigned long nextInterval = task.function(frameTime);
+        unsigned long runTime = micros() - startMicros;
+        
+        if (runTime > task.maxRunTime) {
+            task.maxRunTime = min(runTime, 0xFFFFUL);
+        }
+        if (nextInterval > 0 && runTime / 1000 >= nextInterval) {
+            task.overruns++;
+        }
+        
+        task.lastRun = frameTime;
+        task.interval = nextInterval;
+        task.runCount++;
+    }
+}
+
+void TaskScheduler::wakeTask(int8_t taskId) {
+    if (taskId >= 0 && taskId < taskCount) {
+        // Due now - lateness counts from here, not from the sleep it cut short
+        tasks[taskId].lastRun = millis();
+        tasks[taskId].interval = 0;
+    }
+}
+
+unsigned long TaskScheduler::getFrameTime() const {
+    return frameTime;
+}
+
+uint16_t TaskScheduler::getOverrunCount(int8_t taskId) const {
+    if (taskId >= 0 && taskId < taskCount) {
+        return tasks[taskId].overruns;
+    }
+    return 0;
+}
+
+uint16_t TaskScheduler::getTotalOverruns() const {
+    uint16_t total = 0;
+    for (uint8_t i = 0; i < taskCount; i++) {
+        total += tasks[i].overruns;
+    }
+    return total;
+}
+
+void TaskScheduler::resetStats() {
+    frameCount = 0;
+    for (uint8_t i = 0; i < taskCount; i++) {
+        tasks[i].overruns = 0;
+        tasks[i].maxLateness = 0;
+        tasks[i].maxRunTime = 0;
+        tasks[i].runCount = 0;
+    }
+}
+
+void TaskScheduler::printStatus() const {
+    DebugSerial.print(F("Scheduler: "));
+    DebugSerial.print(frameCount);
+    DebugSerial.println(F(" frames"));
+    
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const Task& task = tasks[i];
+        DebugSerial.print(F("  "));
+        DebugSerial.print(task.name);
+        DebugSerial.print(F(": runs "));
+        DebugSerial.print(task.runCount);
+        DebugSerial.print(F(", overruns "));
+        DebugSerial.print(task.overruns);
+        DebugSerial.print(F(", max late "));
+        DebugSerial.print(task.maxLateness);
+        DebugSerial.print(F("ms, max run "));
+        DebugSerial.print(task.maxRunTime);
+        DebugSerial.println(F("us"));
+    }
+}
@@ -1,20 +1,22 @@
 #include "TelephoneRinger.h"
+#include "Features.h"
+#include "EmergencyStop.h"
 // #include "Config.h"  // Commented out for now to avoid dependencies
 
 TelephoneRinger::TelephoneRinger() {
     state = IDLE;
     relayPin = -1;
     lastStateChange = 0;
+    stateDuration = 0;
     currentRingCount = 0;
-    totalRingsToMake = 0;
-    finalRingCutShort = false;
     useUKRingStyle = false;
-    waitDuration = 0;
+    autoCall = true;
+    useEdgeEngine = false;
+    nextEdgeTime = 0;
     enableSerialOutput = true;  // Default to enabled
     systemConfig = nullptr;
-    canStartCallCallback = nullptr;
-    currentRingOnDuration = 2000;   // Default 2 seconds
-    currentRingOffDuration = 4000;  // Default 4 seconds
+    clock = nullptr;
+    compilePlan(0, false);
 }
 
 void TelephoneRinger::initialize(int pin, const SystemConfig* config, bool enableSerialOutput) {
@@ -22,196 +24,207 @@ void TelephoneRinger::initialize(int pin, const SystemConfig* config, bool enabl
     systemConfig = config;
     this->enableSerialOutput = enableSerialOutput;  // Store the flag
     state = IDLE;
-    lastStateChange = millis();
+    lastStateChange = now();
     useUKRingStyle = false;
-    // Set default timing values
-    currentRingOnDuration = 2000;   // 2 seconds
-    currentRingOffDuration = 4000;  // 4 seconds
     // Start with a random delay before first call
-    waitDuration = getRandomWaitTime();
+    stateDuration = getRandomWaitTime();
     if (enableSerialOutput) {
-        Serial.print("Phone initialized on pin ");
-        Serial.println(relayPin);
+        DebugSerial.print("Phone initialized on pin ");
+        DebugSerial.println(relayPin);
     }
 }
 
-void TelephoneRinger::setCanStartCallCallback(CanStartCallCallback callback) {
-    canStartCallCallback = callback;
+void TelephoneRinger::seedRandom(uint32_t seed, uint8_t stream) {
+    rng.seed(seed, stream);
 }
 
-void TelephoneRinger::step(unsigned long currentTime) {
-    unsigned long elapsed = currentTime - lastStateChange;
+void TelephoneRinger::setAutoCall(bool enabled) {
+    autoCall = enabled;
+}
+
+void TelephoneRinger::setHardwareEdges(bool enabled) {
+    useEdgeEngine = enabled;
+}
+
+void TelephoneRinger::setClock(const VirtualClock* clock) {
+    this->clock = clock;
+}
+
+void TelephoneRinger::setRelayPin(int pin) {
+    relayPin = pin;
+}
+
+void TelephoneRinger::resyncRelay(unsigned long currentTime) {
+    if (relayPin < 0) {
+        return;
+    }
+    if (!useEdgeEngine) {
+        setRelayState(state == RING_ON);
+        return;
+    }
+    
+    RelayEdgeEngine::cancelEdges(relayPin);
+    if (state == RING_ON || state == RING_OFF) {
+        // Put the relay back where the state says and finish the state on time
+        setRelayState(state == RING_ON);
+        nextEdgeTime = RelayEdgeEngine::now() + RelayEdgeEngine::msToTicks(getTimeToNextEvent(currentTime));
+        RelayEdgeEngine::scheduleEdge(relayPin, state == RING_ON ? HIGH : LOW, nextEdgeTime);
+    } else {
+        setRelayState(false);
+    }
+}
+
+TelephoneRinger::StepEvent TelephoneRinger::step(unsigned long currentTime) {
+    // Nothing to do until the current state's deadline - the common case
+    if (currentTime - lastStateChange < stateDuration) {
+        return EVENT_NONE;
+    }
+    
+    StepEvent event = EVENT_NONE;
     
     switch (state) {
         case IDLE:
-            // Check if it's time to start a new call AND if we're allowed to start one
-            if (elapsed >= waitDuration) {
-                // Check if callback allows starting a new call
-                if (canStartCallCallback == nullptr || canStartCallCallback()) {
-                    startCall();
-                } else {
-                    // Can't start a call now due to concurrent limit, wait a bit longer
-                    waitDuration = getRandomWaitTime() / 4;  // Shorter wait before trying again
-                    lastStateChange = currentTime;
-                }
+            // Lines driven by the arrival model never start calls on their own
+            if (!autoCall) {
+                break;
             }
+            // Time for a new call - ask the owner for a concurrent call slot
+            queueCall();
+            event = EVENT_CALL_REQUEST;
+            break;
+            
+        case QUEUED:
+            // Stays here until the owner calls startCall()
             break;
             
         case RING_ON:
-            // Check if ring duration is complete
-            {
-                unsigned long ringDuration = currentRingOnDuration;
-                
-                // If this is the final ring and it should be cut short, reduce the duration
-                if (currentRingCount == totalRingsToMake && finalRingCutShort) {
-                    // Cut the ring short by 25-75% (random)
-                    ringDuration = currentRingOnDuration * random(25, 76) / 100;
-                    if (enableSerialOutput) {
-                        Serial.print("Phone pin ");
-                        Serial.print(relayPin);
-                        Serial.print(" final ring cut short to ");
-                        Serial.print(ringDuration);
-                        Serial.println("ms");
-                    }
+            // Ring duration is complete
+            event = EVENT_RING_OFF;
+            if (!useEdgeEngine) {
+                setRelayState(false); // Turn off ring (edge engine already did)
+            }
+            if (enableSerialOutput) {
+                DebugSerial.print("Phone pin ");
+                DebugSerial.print(relayPin);
+                DebugSerial.print(" ring ");
+                DebugSerial.print(currentRingCount);
+                DebugSerial.print("/");
+                DebugSerial.print(plan.ringCount);
+                DebugSerial.println(" OFF");
+            }
+            
+            if (currentRingCount >= plan.ringCount) {
+                // Call sequence complete
+                state = CALL_ANSWERED;
+                stateDuration = CALL_END_PAUSE;
+                if (enableSerialOutput) {
+                    DebugSerial.print("Phone pin ");
+                    DebugSerial.print(relayPin);
+                    DebugSerial.println(" call complete");
                 }
-                
-                if (elapsed >= ringDuration) {
-                    setRelayState(false); // Turn off ring
-                    if (enableSerialOutput) {
-                        Serial.print("Phone pin ");
-                        Serial.print(relayPin);
-                        Serial.print(" ring ");
-                        Serial.print(currentRingCount);
-                        Serial.print("/");
-                        Serial.print(totalRingsToMake);
-                        Serial.println(" OFF");
-                    }
-                    
-                    if (currentRingCount >= totalRingsToMake) {
-                        // Call sequence complete
-                        state = CALL_ANSWERED;
-                        if (enableSerialOutput) {
-                            Serial.print("Phone pin ");
-                            Serial.print(relayPin);
-                            Serial.println(" call complete");
-                        }
-                    } else {
-                        // More rings to go
-                        state = RING_OFF;
-                    }
-                    lastStateChange = currentTime;
+            } else {
+                // More rings to go
+                state = RING_OFF;
+                stateDuration = plan.ringOffDuration;
+                if (useEdgeEngine) {
+                    lastStateChange = scheduleStateEndEdge(currentTime, stateDuration);
+                    break;
                 }
             }
+            lastStateChange = currentTime;
             break;
             
         case RING_OFF:
-            // Check if silence duration is complete
-            if (elapsed >= currentRingOffDuration) {
-                currentRingCount++;
-                if (enableSerialOutput) {
-                    Serial.print("Phone pin ");
-                    Serial.print(relayPin);
-                    Serial.print(" starting ring ");
-                    Serial.print(currentRingCount);
-                    Serial.print("/");
-                    Serial.println(totalRingsToMake);
-                }
-                setRelayState(true); // Turn on next ring
-                state = RING_ON;
-                lastStateChange = currentTime;
+            // Silence duration is complete
+            currentRingCount++;
+            if (enableSerialOutput) {
+                DebugSerial.print("Phone pin ");
+                DebugSerial.print(relayPin);
+                DebugSerial.print(" starting ring ");
+                DebugSerial.print(currentRingCount);
+                DebugSerial.print("/");
+                DebugSerial.println(plan.ringCount);
             }
+            state = RING_ON;
+            stateDuration = getRingDuration();
+            event = EVENT_RING_ON;
+            if (useEdgeEngine) {
+                lastStateChange = scheduleStateEndEdge(currentTime, stateDuration);
+                break;
+            }
+            setRelayState(true); // Turn on next ring
+            lastStateChange = currentTime;
             break;
             
         case CALL_ANSWERED:
-            // Brief pause after call ends, then wait for next call
-            if (elapsed >= 1000) { // 1 second pause
-                state = WAITING;
-                waitDuration = getRandomWaitTime();
+            // Brief pause after call ends is over
+            event = EVENT_CALL_ENDED;
+            if (!autoCall) {
+                // Line is free again for the next arrival
+                state = IDLE;
                 lastStateChange = currentTime;
-                if (enableSerialOutput) {
-                    Serial.print("Phone pin ");
-                    Serial.print(relayPin);
-                    Serial.print(" waiting ");
-                    Serial.print(waitDuration);
-                    Serial.println("ms for next call");
-                }
+                break;
+            }
+            // Now wait for next call
+            state = WAITING;
+            stateDuration = getRandomWaitTime();
+            lastStateChange = currentTime;
+            if (enableSerialOutput) {
+                DebugSerial.print("Phone pin ");
+                DebugSerial.print(relayPin);
+                DebugSerial.print(" waiting ");
+                DebugSerial.print(stateDuration);
+                DebugSerial.println("ms for next call");
             }
             break;
             
         case WAITING:
-            // Wait for the specified duration before going idle (ready for next call)
-            if (elapsed >= waitDuration) {
-                state = IDLE;
-                waitDuration = getRandomWaitTime();
-                lastStateChange = currentTime;
-                if (enableSerialOutput) {
-                    Serial.print("Phone pin ");
-                    Serial.print(relayPin);
-                    Serial.println(" ready for next call");
-                }
+            // Waited the specified duration, go idle (ready for next call)
+            state = IDLE;
+            stateDuration = getRandomWaitTime();
+            lastStateChange = currentTime;
+            if (enableSerialOutput) {
+                DebugSerial.print("Phone pin ");
+                DebugSerial.print(relayPin);
+                DebugSerial.println(" ready for next call");
             }
             break;
     }
+    
+    return event;
+}
+
+void TelephoneRinger::queueCall() {
+    state = QUEUED;
+    stateDuration = 0;
+    lastStateChange = now();
 }
 
 void TelephoneRinger::startCall() {
+    startCallAt(now());
+}
+
+void TelephoneRinger::startCallAt(unsigned long currentTime) {
     // Original simple logic: 1-8 random rings, last ring sometimes cut short
-    totalRingsToMake = random(1, 9); // 1 to 8 rings
-    currentRingCount = 1;
-    
     // 50% chance that the final ring gets cut short (to simulate someone answering)
-    finalRingCutShort = (random(100) < 50);
-    
-    if (enableSerialOutput) {
-        Serial.print("Phone on pin ");
-        Serial.print(relayPin);
-        Serial.print(" starting call: ");
-        Serial.print(totalRingsToMake);
-        Serial.print(" rings");
-        if (finalRingCutShort) {
-            Serial.print(" (last ring may be cut short)");
-        }
-        Serial.println();
-    }
-    
-    setRelayState(true); // Turn on first ring
-    state = RING_ON;
-    lastStateChange = millis(); // Reset timer for the RING_ON state
+    compilePlan(rng.range(1, 9), rng.chance(50));
+    beginCall(currentTime);
 }
 
 void TelephoneRinger::startCall(int ringCount, bool cutShort, bool useUKStyleRing) {
-    totalRingsToMake = ringCount;
-    currentRingCount = 1;
-    finalRingCutShort = cutShort;
     useUKRingStyle = useUKStyleRing;
-    
-    // Set default ring timing (simplified)
-    currentRingOnDuration = 2000;   // 2 seconds
-    currentRingOffDuration = 4000;  // 4 seconds
-    
-    setRelayState(true); // Turn on first ring
-    state = RING_ON;
-    lastStateChange = millis(); // Reset timer for the RING_ON state
-    
-    // Debug output using safe char buffer instead of String concatenation
-    if (enableSerialOutput) {
-        Serial.print(F("Phone on pin "));
-        Serial.print(relayPin);
-        Serial.print(F(" starting call: "));
-        Serial.print(totalRingsToMake);
-        Serial.print(F(" rings"));
-        if (finalRingCutShort) {
-            Serial.print(F(" (final ring cut short)"));
-        }
-        Serial.println();
-    }
+    compilePlan(ringCount, cutShort);
+    beginCall(now());
 }
 
 void TelephoneRinger::stopCall() {
+    if (useEdgeEngine && relayPin >= 0) {
+        RelayEdgeEngine::cancelEdges(relayPin);
+    }
     setRelayState(false);
     state = IDLE;
-    waitDuration = getRandomWaitTime();
-    lastStateChange = millis();
+    stateDuration = getRandomWaitTime();
+    lastStateChange = now();
 }
 
 bool TelephoneRinger::isRinging() const {
@@ -219,22 +232,128 @@ bool TelephoneRinger::isRinging() const {
 }
 
 bool TelephoneRinger::isActive() const {
-    return state != IDLE && state != WAITING;
+    return state != IDLE && state != WAITING && state != QUEUED;
+}
+
+bool TelephoneRinger::isQueued() const {
+    return state == QUEUED;
+}
+
+uint8_t TelephoneRinger::getRingCount() const {
+    return currentRingCount;
+}
+
+bool TelephoneRinger::isCutShort() const {
+    return plan.finalRingCutShort;
+}
+
+unsigned long TelephoneRinger::getTimeToNextEvent(unsigned long currentTime) const {
+    // Queued lines and arrival-driven idle lines only move when the owner starts them
+    if (state == QUEUED || (state == IDLE && !autoCall)) {
+        return NO_DEADLINE;
+    }
+    
+    unsigned long elapsed = currentTime - lastStateChange;
+    return (elapsed >= stateDuration) ? 0 : stateDuration - elapsed;
+}
+
+void TelephoneRinger::compilePlan(int ringCount, bool cutShort) {
+    plan.ringCount = constrain(ringCount, 0, 255);
+    plan.finalRingCutShort = cutShort;
+    
+    // Set default ring timing (simplified)
+    plan.ringOnDuration = DEFAULT_RING_ON_DURATION;
+    plan.ringOffDuration = DEFAULT_RING_OFF_DURATION;
+    
+    // Cut the final ring short by 25-75% (random), decided once per call
+    plan.finalRingDuration = plan.ringOnDuration;
+    if (cutShort) {
+        plan.finalRingDuration = (uint32_t)plan.ringOnDuration * rng.range(25, 76) / 100;
+    }
+}
+
+void TelephoneRinger::beginCall(unsigned long currentTime) {
+    currentRingCount = 1;
+    
+    // Debug output using safe char buffer instead of String concatenation
+    if (enableSerialOutput) {
+        DebugSerial.print(F("Phone on pin "));
+        DebugSerial.print(relayPin);
+        DebugSerial.print(F(" starting call: "));
+        DebugSerial.print(plan.ringCount);
+        DebugSerial.print(F(" rings"));
+        if (plan.finalRingCutShort) {
+            DebugSerial.print(F(" (final ring cut short to "));
+            DebugSerial.print(plan.finalRingDuration);
+            DebugSerial.print(F("ms)"));
+        }
+        DebugSerial.println();
+    }
+    
+    if (useEdgeEngine && relayPin >= 0) {
+        RelayEdgeEngine::cancelEdges(relayPin);
+    }
+    setRelayState(true); // Turn on first ring
+    state = RING_ON;
+    stateDuration = getRingDuration();
+    lastStateChange = currentTime; // Reset timer for the RING_ON state
+    
+    if (useEdgeEngine && relayPin >= 0) {
+        // Edges for this call are timed from the first ring
+        nextEdgeTime = RelayEdgeEngine::now();
+        scheduleStateEndEdge(currentTime, stateDuration);
+    }
+}
+
+unsigned long TelephoneRinger::getRingDuration() const {
+    // The final ring uses the planned (possibly cut short) length
+    return (currentRingCount >= plan.ringCount) ? plan.finalRingDuration : plan.ringOnDuration;
 }
 
 void TelephoneRinger::setRelayState(bool active) {
     if (relayPin >= 0) {
         // Most relay modules are active LOW, so invert the logic
-        digitalWrite(relayPin, active ? LOW : HIGH);
+        uint8_t level = active ? LOW : HIGH;
+        // The edge engine may hold it for a zero crossing; a full queue falls back to switching now
+        // (still refused while a tripped emergency stop holds the relays off)
+        if (!useEdgeEngine || !RelayEdgeEngine::scheduleEdge(relayPin, level, RelayEdgeEngine::now())) {
+            EmergencyStop::writeOutput(relayPin, level);
+        }
         if (enableSerialOutput) {
-            Serial.print("Relay pin ");
-            Serial.print(relayPin);
-            Serial.print(" set to ");
-            Serial.println(active ? "ON (LOW)" : "OFF (HIGH)");
+            DebugSerial.print("Relay pin ");
+            DebugSerial.print(relayPin);
+            DebugSerial.print(" set to ");
+            DebugSerial.println(active ? "ON (LOW)" : "OFF (HIGH)");
         }
     }
 }
 
+// Queue the edge that ends the state just entered, chained from the edge that
+// started it so loop latency doesn't accumulate over a call. Returns the
+// time (on the line's clock) the state really began, for step()'s deadline.
+unsigned long TelephoneRinger::scheduleStateEndEdge(unsigned long currentTime, unsigned long duration) {
+    uint32_t ticks = RelayEdgeEngine::msToTicks(duration);
+    int32_t behind = (int32_t)(RelayEdgeEngine::now() - nextEdgeTime);
+    
+    if (behind > (int32_t)ticks) {
+        // Too far behind to catch up (e.g. just resumed) - start the state now
+        nextEdgeTime += behind;
+        behind = 0;
+    } else if (behind < 0) {
+        // Starting edge still pending - millis() and Timer1 drift slightly
+        behind = 0;
+    }
+    
+    nextEdgeTime += ticks;
+    // RING_ON ends with the relay off, RING_OFF with it on (active LOW)
+    RelayEdgeEngine::scheduleEdge(relayPin, state == RING_ON ? HIGH : LOW, nextEdgeTime);
+    return currentTime - (unsigned long)behind / RelayEdgeEngine::TICKS_PER_MS;
+}
+
+unsigned long TelephoneRinger::now() const {
+    return clock ? clock->now() : millis();
+}
+
 unsigned long TelephoneRinger::getRandomWaitTime() {
     // Use global maxCallDelaySetting from main.cpp
     // Convert seconds to milliseconds and create random range from 5s to maxCallDelaySetting
@@ -246,5 +365,5 @@ unsigned long TelephoneRinger::getRandomWaitTime() {
         minDelay = maxDelay / 2;  // Set minimum to half of maximum if needed
     }
     
-    return random(minDelay, maxDelay + 1);
+    return rng.range(minDelay, maxDelay + 1);
 }
@@ -0,0 +1,188 @@
+#include "UIManager.h"
+#include "DisplayManager.h"
+#include "StringUtils.h"
+
+UIManager::UIManager() {
+    display = nullptr;
+    items = nullptr;
+    itemCount = 0;
+    onSave = nullptr;
+    menuOpen = false;
+    adjusting = false;
+    currentItem = 0;
+}
+
+void UIManager::initialize(DisplayManager* display, const MenuItem* items, uint8_t itemCount, MenuHook onSave) {
+    this->display = display;
+    this->items = items;
+    this->itemCount = itemCount;
+    this->onSave = onSave;
+}
+
+void UIManager::open() {
+    menuOpen = true;
+    adjusting = false;
+    currentItem = 0;
+    drawItemList();
+}
+
+void UIManager::close() {
+    menuOpen = false;
+    adjusting = false;
+}
+
+bool UIManager::isOpen() const {
+    return menuOpen;
+}
+
+bool UIManager::isAdjusting() const {
+    return adjusting;
+}
+
+uint8_t UIManager::getCurrentItem() const {
+    return currentItem;
+}
+
+bool UIManager::handleEvent(EncoderManager::EncoderEvent event, uint8_t stepMultiplier) {
+    if (!menuOpen || itemCount == 0) {
+        return false;
+    }
+    
+    switch (event) {
+        case EncoderManager::CLOCKWISE:
+        case EncoderManager::COUNTER_CLOCKWISE: {
+            int8_t direction = (event == EncoderManager::CLOCKWISE) ? 1 : -1;
+            if (adjusting) {
+                adjust(direction, stepMultiplier);
+            } else {
+                currentItem = (currentItem + itemCount + direction) % itemCount;
+                drawItemName();
+            }
+            return true;
+        }
+        
+        case EncoderManager::BUTTON_PRESS: {
+            if (adjusting) {
+                // Confirm the value and go back to the item list
+                if (onSave) {
+                    onSave();
+                }
+                adjusting = false;
+                drawItemList();
+                return true;
+            }
+            
+            MenuItem item;
+            loadItem(currentItem, item);
+            if (item.value == nullptr) {
+                // Action item (e.g. Exit)
+                if (item.onChange) {
+                    item.onChange();
+                }
+            } else {
+                adjusting = true;
+                drawSetting();
+            }
+            return true;
+        }
+        
+        default:
+            return false;
+    }
+}
+
+void UIManager::formatSeconds(char* buffer, uint8_t size, int value) {
+    LineWriter out(buffer, size);
+    out.number(value);
+    out.character('s');
+}
+
+void UIManager::formatOnOff(char* buffer, uint8_t size, int value) {
+    strncpy(buffer, value ? "On" : "Off", size - 1);
+    buffer[size - 1] = '\0';
+}
+
+void UIManager::loadItem(uint8_t index, MenuItem& item) const {
+    memcpy_P(&item, &items[index], sizeof(MenuItem));
+}
+
+void UIManager::drawItemList() {
+    MenuItem item;
+    loadItem(currentItem, item);
+    
+    char label[LINE_LENGTH + 1];
+    strncpy_P(label, item.label, LINE_LENGTH);
+    label[LINE_LENGTH] = '\0';
+    display->showMenuMessage("* SETTINGS *", label, "Turn: Navigate", "Press: Select/Exit");
+}
+
+void UIManager::drawItemName() {
+    MenuItem item;
+    loadItem(currentItem, item);
+    
+    char label[LINE_LENGTH + 1];
+    strncpy_P(label, item.label, LINE_LENGTH);
+    label[LINE_LENGTH] = '\0';
+    display->writeField(0, NAME_ROW, label, LINE_LENGTH);
+}
+
+void UIManager::drawSetting() {
+    MenuItem item;
+    loadItem(currentItem, item);
+    
+    char label[LINE_LENGTH + 1];
+    char hint[LINE_LENGTH + 1];
+    char valueLine[LINE_LENGTH + 1];
+    char valueText[LINE_LENGTH - VALUE_COLUMN + 1];
+    
+    strncpy_P(label, item.label, LINE_LENGTH);
+    label[LINE_LENGTH] = '\0';
+    hint[0] = '\0';
+    if (item.hint) {
+        strncpy_P(hint, item.hint, LINE_LENGTH);
+        hint[LINE_LENGTH] = '\0';
+    }
+    formatValue(item, valueText, sizeof(valueText));
+    LineWriter line(valueLine, sizeof(valueLine));
+    line.text("Setting: ");
+    line.text(valueText);
+    
+    display->showMessage(label, valueLine, hint, "Press: Save & Back");
+}
+
+void UIManager::drawValue(const MenuItem& item) {
+    char valueText[LINE_LENGTH - VALUE_COLUMN + 1];
+    formatValue(item, valueText, sizeof(valueText));
+    display->writeField(VALUE_COLUMN, VALUE_ROW, valueText, LINE_LENGTH - VALUE_COLUMN);
+}
+
+void UIManager::formatValue(const MenuItem& item, char* buffer, uint8_t size) const {
+    if (item.format) {
+        item.format(buffer, size, *item.value);
+    } else {
+        LineWriter out(buffer, size);
+        out.number(*item.value);
+    }
+}
+
+void UIManager::adjust(int8_t direction, uint8_t stepMultiplier) {
+    MenuItem item;
+    loadItem(currentItem, item);
+    
+    if ((item.maxValue - item.minValue) / item.step < ACCELERATION_MIN_STEPS) {
+        stepMultiplier = 1;
+    }
+    
+    // Stop at the limits rather than wrapping - a fast spin lands exactly on them
+    long newValue = *item.value + (long)direction * item.step * stepMultiplier;
+    newValue = constrain(newValue, (long)item.minValue, (long)item.maxValue);
+    if (newValue == *item.value) {
+        return;
+    }
+    
+    *item.value = newValue;
+    if (item.onChange) {
+        item.onChange();
+    }
+    drawValue(item);
+}
@@ -0,0 +1,37 @@
+#include "VirtualClock.h"
+
+VirtualClock::VirtualClock() {
+    pausedTotal = 0;
+    pausedAt = 0;
+    paused = false;
+}
+
+unsigned long VirtualClock::toVirtual(unsigned long realTime) const {
+    return (paused ? pausedAt : realTime) - pausedTotal;
+}
+
+unsigned long VirtualClock::now() const {
+    return toVirtual(millis());
+}
+
+void VirtualClock::pause(unsigned long realTime) {
+    if (!paused) {
+        paused = true;
+        pausedAt = realTime;
+    }
+}
+
+void VirtualClock::resume(unsigned long realTime) {
+    if (paused) {
+        pausedTotal += realTime - pausedAt;
+        paused = false;
+    }
+}
+
+bool VirtualClock::isPaused() const {
+    return paused;
+}
+
+unsigned long VirtualClock::getPausedTotal() const {
+    return pausedTotal;
+}
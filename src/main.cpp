@@ -2,8 +2,21 @@
 #include "RingerManager.h"
 #include "DisplayManager.h"
 #include "EncoderManager.h"
+#include "InputDebouncer.h"
 #include "SettingsManager.h"
-#include "RandomSeed.h"
+#include "BootManager.h"
+#include "TaskScheduler.h"
+#include "RelayEdgeEngine.h"
+#include "EmergencyStop.h"
+#include "EventBus.h"
+#include "UIManager.h"
+#include "Features.h"
+#include "EntropyPool.h"
+#include "StressTest.h"
+#include "RelayWear.h"
+#include "CallStats.h"
+#include "ScenarioPlayer.h"
+#include "ShowScenario.h"  // Compiled from host/scenarios/office_day.txt
 
 // Hardware pin definitions - Updated for your specific setup
 const int RELAY_PINS[] = {5, 6, 7, 8, 9, 10, 11, 12}; // Digital pins 5-12 for 8-relay module
@@ -15,43 +28,51 @@ const int NUM_PHONES = 8;
                                          // Set to 1 for single-phone testing
                                          // Set to 8 to disable concurrent limiting
 
+// Fast Boot - skip the relay self-test after a warm reset (brown-out, watchdog, reset button)
+#define FAST_BOOT_ENABLED 1              // Set to 0 to always run the relay self-test
+
+// Random Seed - nonzero replays exactly the same call pattern on every boot
+#define FIXED_RANDOM_SEED 0UL            // 0 = seed from the entropy pool (analog noise on ENTROPY_PIN)
+#define BOOT_ENTROPY_BITS 32             // Boot seed waits for this many pool bits...
+#define BOOT_ENTROPY_WAIT_MS 10          // ...but never longer than this (reseeds never wait)
+
+// Call Arrivals - how new calls are generated
+#define POISSON_ARRIVALS 1               // 1 = one Poisson arrival stream feeds free lines
+                                         // 0 = each line schedules its own calls (original model)
+
+// Relay Timing - who switches the ring cadence
+#define HARDWARE_RELAY_EDGES 1           // 1 = Timer1 compare match switches each edge on time
+                                         // 0 = relays switched from the main loop
+
+// Zero-Cross Sync - relay contacts meet the ring voltage at a zero crossing (needs HARDWARE_RELAY_EDGES)
+#define ZERO_CROSS_SYNC 1                // 1 = hold edges for the detector on ZERO_CROSS_PIN (on time without a signal)
+#define RELAY_OPERATE_US 7000            // Coil on to contacts closed, measured on the relay module
+#define RELAY_RELEASE_US 3000            // Coil off to contacts open
+
+// Relay Wear - spread ring cycles evenly over all relays, even when fewer lines are active
+#define WEAR_BALANCING 1                 // 1 = calls go to the least-worn free relay, 0 = line N is always relay N
+
+// Emergency Stop - the pause button cuts relays and ringer power from its pin change interrupt
+#define EMERGENCY_STOP 1                 // 1 = cut at the press, 0 = pause only when the main loop sees it
+#define STOP_PRESS_HOLDOFF_MS 250        // Debounced press this soon after a trip is that same press
+
 // Maximum Chaos Mode Settings - The ultimate CallStorm 2000 experience!
 #define CHAOS_ACTIVE_RELAYS 8        // All relays enabled
 #define CHAOS_MAX_CONCURRENT 8       // All phones can ring simultaneously  
 #define CHAOS_MIN_CALL_DELAY 10      // Minimum delay = maximum frequency
 
-// Menu System State
-bool inMenu = false;
-bool inAdjustmentMode = false;  // Track if we're adjusting a setting
-int currentMenuItem = 0;
+// Stress Test - acceptance benchmark, started by a long press on "Exit Menu" or from Serial
+#define STRESS_TEST_COMMAND 'b'          // Serial character that starts (or aborts) a run
+
+// Call Statistics - LCD page from the menu ("Call Stats"), full dump on Serial
+#define CALL_STATS_COMMAND 's'           // Serial character that prints the statistics
+
+// Settings (edited from the menu, saved to EEPROM)
 int maxConcurrentSetting = MAX_CONCURRENT_ACTIVE_PHONES;  // Local copy for menu editing
 int activeRelaySetting = NUM_PHONES;  // Number of active relays (0-8)
 int maxCallDelaySetting = 30;  // Maximum delay between calls in seconds (10-1000, increments of 10)
 int ringerHangTimeSetting = 2;  // Ringer power hang time in seconds (0-60)
-
-// Static buffers for menu display - avoid String concatenation
-char menuBuffer1[21];  // LCD line buffer (20 chars + null terminator)
-char menuBuffer2[21];  // LCD line buffer
-char menuBuffer3[21];  // LCD line buffer
-char menuBuffer4[21];  // LCD line buffer
-
-// Menu Items
-enum MenuItems {
-  MENU_CONCURRENT_LIMIT = 0,
-  MENU_ACTIVE_RELAYS,  // Number of active relays (0-8)
-  MENU_CALL_FREQUENCY, // Maximum delay between calls (10-1000 seconds)
-  MENU_RINGER_HANG_TIME, // Ringer power hang time (0-60 seconds)
-  MENU_EXIT,
-  MENU_ITEM_COUNT
-};
-
-const char* menuItemNames[] = {
-  "Max Concurrent",
-  "Active Phones",  
-  "Call Timing",
-  "Ringer Hang Time",
-  "Exit Menu"
-};
+int showSetting = 0;  // Scripted show playing (0/1) - not saved, every boot starts without one
 
 // UI Hardware pins
 const int ENCODER_PIN_A = 3;      // Encoder A
@@ -61,51 +82,146 @@ const int PAUSE_BUTTON = A0;      // System pause button (moved from pin 13)
 const int STATUS_LED = 13;        // System status LED (onboard LED)
 const int RINGER_POWER_PIN = A2;  // Ringer power control (Pin 16/A2)
 const int READY_LED = A3;         // System ready LED (on when operational)
+const int ZERO_CROSS_PIN = A1;    // Optional zero-cross detector
+const int ENTROPY_PIN = A6;       // Unconnected analog-only input - ADC noise for the entropy pool
 // I2C pins A4 (SDA) and A5 (SCL) for 20x4 LCD display
 
 // System state
 bool systemPaused = false;
-bool lastPauseButtonState = HIGH;  // Assuming pull-up resistor
-bool pauseButtonPressed = false;   // Track if button was just pressed
-unsigned long lastPauseDebounce = 0;
-const unsigned long DEBOUNCE_DELAY = 50;
+unsigned long stopCaughtUpAt = 0;  // When the main loop last caught up with an emergency stop
 
 // Ringer Power Control state
 bool ringerPowerActive = false;
-unsigned long ringerPowerStartTime = 0;
+unsigned long ringerPowerStartTime = 0;  // When the last call ended (hang timer start)
+bool ringerCallsActive = false;          // Any call in progress at the last check
 const unsigned long RINGER_POWER_HANG_TIME = 2000;  // 2 seconds hang time after last call
 
 // Status LED variables
 bool statusLedState = false;
-unsigned long lastStatusLedToggle = 0;
 const unsigned long PAUSE_BLINK_INTERVAL = 100;  // 100ms = 10Hz toggle = 5Hz blink rate
 
-// Global access to ringer manager for concurrent phone limit checking
-RingerManager* globalRingerManager = nullptr;
+// Task rates - each subsystem runs only as often as it needs
+const unsigned long INPUT_TASK_INTERVAL = 1;      // Encoder/buttons sampled at 1 kHz
+const unsigned long DISPLAY_TASK_INTERVAL = 100;  // LCD refreshed at 10 Hz
+const unsigned long OUTPUT_TASK_INTERVAL = 1000;  // Fallback only - call start/end events wake it
+const unsigned long STATUS_LED_INTERVAL = 1000;   // Fallback only - ring events wake it
+const unsigned long RINGER_MAX_SLEEP = 1000;      // Upper bound between ringer steps
+const unsigned long STRESS_DISPLAY_INTERVAL = 20; // Stress test: full redraw at 50 Hz
+const unsigned long STRESS_IDLE_INTERVAL = 1000;  // Fallback only - woken when a run starts
+const unsigned long WEAR_SAVE_INTERVAL = 3600000; // Relay wear counters saved hourly (and on pause)
+const unsigned long STATS_PAGE_INTERVAL = 1000;   // Call stats page refreshed once a second
 
 // Create the system components
 RingerManager ringerManager;
 DisplayManager displayManager;
+InputDebouncer inputs;
 EncoderManager encoderManager;
+TaskScheduler scheduler;
+UIManager ui;
+StressTest stressTest;
+RelayWear relayWear;
+ScenarioPlayer scenario;
+CallStats callStats;
+
+// Stress test state - settings to restore afterwards, results held on the LCD until the knob is touched
+Settings stressSavedSettings;
+bool stressResultsShown = false;
+
+// Call stats page is up (from the menu) - live until the knob is touched
+bool callStatsShown = false;
+
+// Settings from before the show started - restored when it ends, and what gets saved meanwhile
+Settings showSavedSettings;
+
+// Task ids, for waking a task early
+int8_t ringerTaskId = TaskScheduler::INVALID_TASK;
+int8_t displayTaskId = TaskScheduler::INVALID_TASK;
+int8_t outputTaskId = TaskScheduler::INVALID_TASK;
+int8_t statusLedTaskId = TaskScheduler::INVALID_TASK;
+int8_t stressTaskId = TaskScheduler::INVALID_TASK;
+int8_t scenarioTaskId = TaskScheduler::INVALID_TASK;
 
 // Function declarations
+unsigned long inputTask(unsigned long now);
+unsigned long ringerTask(unsigned long now);
+unsigned long displayTask(unsigned long now);
+unsigned long outputTask(unsigned long now);
+unsigned long statusLedTask(unsigned long now);
+unsigned long stressTask(unsigned long now);
+unsigned long scenarioTask(unsigned long now);
+unsigned long wearTask(unsigned long now);
+void applySettingChanges(); // Push changed settings into the ringer manager
 void checkPauseButton();
-void updateStatusLED();
-void updateRingerPowerControl(); // Control ringer power with hang time
-bool canStartNewCall();  // Check if a new call can start (respects concurrent limit)
-void handleEncoderEvents();  // Handle rotary encoder input
+void togglePause();
+bool relaysHeld();  // Paused, or the emergency stop is holding the relays off
+unsigned long updateRingerPowerControl(unsigned long currentTime); // Control ringer power with hang time
+void onDisplayEvent(const EventBus::Event& event);  // Ringer event subscribers
+void onPowerEvent(const EventBus::Event& event);
+void onStatusLedEvent(const EventBus::Event& event);
+bool handleEncoderEvents(unsigned long currentTime);  // Handle rotary encoder input
+bool handleInputEvent(EncoderManager::EncoderEvent event, uint8_t stepMultiplier);  // Real or scripted encoder event
+void checkSerialCommands();
+void updateArrivalRate();  // Derive the arrival rate from the current settings
 void loadSettingsFromEEPROM();
 void saveSettingsToEEPROM();
 void activateMaximumChaos(); // 🌪️ Maximum Chaos Easter Egg!
 void showRelayAdjustmentFeedback(); // Show brief relay adjustment confirmation
 void saveAndExitMenu(); // 💾 Menu Long-Press: Save & Exit
+void exitMenu(); // Menu "Exit Menu" item
+void showCallStats(); // Menu "Call Stats" item
+void wakeOutputTask(); // Re-check ringer power after the hang time changes
+void startStressTest(); // Acceptance benchmark - every line busy, display and input hammered
+void finishStressTest(); // End (or abort) the run, report and restore the settings
+void applyShowSetting(); // Start or stop the scripted show from the menu
+void stopShow(); // Stop the show and put the settings back
+
+// Settings menu - one row per setting, interpreted by UIManager
+const char MENU_LABEL_CONCURRENT[] PROGMEM = "Max Concurrent";
+const char MENU_LABEL_ACTIVE[] PROGMEM = "Active Phones";
+const char MENU_LABEL_TIMING[] PROGMEM = "Call Timing";
+const char MENU_LABEL_HANG_TIME[] PROGMEM = "Ringer Hang Time";
+const char MENU_LABEL_SHOW[] PROGMEM = "Show Script";
+const char MENU_LABEL_STATS[] PROGMEM = "Call Stats";
+const char MENU_LABEL_EXIT[] PROGMEM = "Exit Menu";
+const char MENU_HINT_CONCURRENT[] PROGMEM = "Turn: Adjust (1-8)";
+const char MENU_HINT_ACTIVE[] PROGMEM = "Turn: Adjust (0-8)";
+const char MENU_HINT_TIMING[] PROGMEM = "Turn: +/-10s (10-1000)";
+const char MENU_HINT_HANG_TIME[] PROGMEM = "Turn: +/-1s (0-60)";
+const char MENU_HINT_SHOW[] PROGMEM = "Turn: Off/On";
+
+const MenuItem MENU_ITEMS[] PROGMEM = {
+  // label                 hint                  value                   min  max   step format                    onChange
+  { MENU_LABEL_CONCURRENT, MENU_HINT_CONCURRENT, &maxConcurrentSetting,  1,   8,    1,   nullptr,                  applySettingChanges },
+  { MENU_LABEL_ACTIVE,     MENU_HINT_ACTIVE,     &activeRelaySetting,    0,   8,    1,   nullptr,                  applySettingChanges },
+  { MENU_LABEL_TIMING,     MENU_HINT_TIMING,     &maxCallDelaySetting,   10,  1000, 10,  UIManager::formatSeconds, applySettingChanges },
+  { MENU_LABEL_HANG_TIME,  MENU_HINT_HANG_TIME,  &ringerHangTimeSetting, 0,   60,   1,   UIManager::formatSeconds, wakeOutputTask },
+  { MENU_LABEL_SHOW,       MENU_HINT_SHOW,       &showSetting,           0,   1,    1,   UIManager::formatOnOff,   applyShowSetting },
+  { MENU_LABEL_STATS,      nullptr,              nullptr,                0,   0,    0,   nullptr,                  showCallStats },
+  { MENU_LABEL_EXIT,       nullptr,              nullptr,                0,   0,    0,   nullptr,                  exitMenu }
+};
+const uint8_t MENU_ITEM_COUNT = sizeof(MENU_ITEMS) / sizeof(MENU_ITEMS[0]);
 
 void setup() {
-  Serial.begin(115200);
+  // Capture the reset cause before anything else touches MCUSR
+  BootManager::captureResetCause();
+  
+  // Noise collection runs in the background from here on
+  EntropyPool::begin(ENTROPY_PIN);
   
-  // Seed the random number generator with atmospheric noise using improved randomizer
-  RandomSeed<A1> atmosphericRNG;  // Use A1 for dedicated random seeding (A0 is pause button)
-  atmosphericRNG.randomize();
+  DebugSerial.begin(115200);
+  
+  // Seed the per-line random streams from the entropy pool (or the fixed replay seed).
+  // Boot is the only time worth a short wait for the pool to fill.
+  uint32_t masterSeed = FIXED_RANDOM_SEED;
+  uint8_t seedBits = 0;
+  if (masterSeed == 0) {
+    unsigned long waitStart = millis();
+    while (EntropyPool::getQuality() < BOOT_ENTROPY_BITS && millis() - waitStart < BOOT_ENTROPY_WAIT_MS) {
+    }
+    seedBits = EntropyPool::getQuality();
+    masterSeed = EntropyPool::takeSeed();
+  }
+  ringerManager.seedRandom(masterSeed);
   
   // Initialize relay pins as outputs (active LOW for most relay modules)
   for (int i = 0; i < NUM_PHONES; i++) {
@@ -125,152 +241,385 @@ void setup() {
   digitalWrite(RINGER_POWER_PIN, HIGH);  // Ensure ringer power is off initially (active LOW)
   digitalWrite(READY_LED, LOW);       // Start with ready LED off during initialization
   
+  // Load settings from EEPROM (before initializing the ringers, which use maxCallDelaySetting)
+  loadSettingsFromEEPROM();
+  
   // Initialize the ringer manager with phone instances (using nullptr for config for now)
   ringerManager.initialize(RELAY_PINS, NUM_PHONES, nullptr, false);
-
-  // Load settings from EEPROM (before applying them)
-  loadSettingsFromEEPROM();
+  
+  // Ring on/off edges timed by Timer1 so slow LCD or EEPROM work can't stretch them
+  if (HARDWARE_RELAY_EDGES) {
+    RelayEdgeEngine::begin();
+    ringerManager.setHardwareEdges(true);
+    if (ZERO_CROSS_SYNC) {
+      RelayEdgeEngine::enableZeroCross(ZERO_CROSS_PIN, RELAY_OPERATE_US, RELAY_RELEASE_US);
+    }
+  }
   
   // Set initial active relay count from loaded settings
   ringerManager.setActiveRelayCount(activeRelaySetting);
   
-  // Set global pointer for concurrent phone limit checking
-  globalRingerManager = &ringerManager;
+  // Concurrent phone limit - enforced by the ringer manager's admission queue
+  ringerManager.setMaxConcurrent(maxConcurrentSetting);
   
-  // Set callback for each phone to check concurrent limit
-  ringerManager.setCanStartCallCallbackForAllPhones(canStartNewCall);
+  // Relay switch counts from EEPROM - they decide which relay each call gets
+  relayWear.begin(NUM_PHONES);
+  if (WEAR_BALANCING) {
+    ringerManager.setWearBalancing(&relayWear);
+  }
+  ringerManager.setStatistics(&callStats);
+  
+  // Choose how calls are generated
+  ringerManager.setArrivalMode(POISSON_ARRIVALS);
+  updateArrivalRate();
+  
+  // Initialize the display, going straight to the LCD address found last boot
+  BootCache bootCache;
+  SettingsManager::loadBootCache(bootCache);
+  displayManager.initialize(false, bootCache.lcdAddress);
+  if (displayManager.getI2CAddress() != bootCache.lcdAddress) {
+    bootCache.lcdAddress = displayManager.getI2CAddress();
+    SettingsManager::saveBootCache(bootCache);
+  }
   
-  // Initialize the display
-  displayManager.initialize(false);
+  // Scripted shows drive the same settings the menu does
+  ScenarioTargets showTargets = { &activeRelaySetting, &maxConcurrentSetting, &maxCallDelaySetting };
+  scenario.initialize(&ringerManager, showTargets);
   
-  // Initialize the encoder
-  encoderManager.initialize(ENCODER_PIN_A, ENCODER_PIN_B, ENCODER_BUTTON, false);
+  // Every front panel input is debounced together - the pause button here,
+  // the encoder's contacts and button by the encoder manager
+  inputs.addButton(PAUSE_BUTTON);
   
-  // Load settings from EEPROM
-  loadSettingsFromEEPROM();
+  // Initialize the encoder and the settings menu it drives
+  encoderManager.initialize(&inputs, ENCODER_PIN_A, ENCODER_PIN_B, ENCODER_BUTTON, false);
+  ui.initialize(&displayManager, MENU_ITEMS, MENU_ITEM_COUNT, saveSettingsToEEPROM);
   
-  // Test each relay briefly to verify connections
-  for (int i = 0; i < NUM_PHONES; i++) {
-    digitalWrite(RELAY_PINS[i], LOW);  // LOW = active for active-LOW modules
-    delay(200);
-    digitalWrite(RELAY_PINS[i], HIGH); // HIGH = inactive for active-LOW modules
-    delay(100);
+  // Test each relay briefly to verify connections (relays were already proven on a warm reset)
+  if (!FAST_BOOT_ENABLED || !BootManager::isWarmBoot()) {
+    BootManager::runRelaySelfTest(RELAY_PINS, NUM_PHONES);
+  }
+  
+  // From here on a press stops the bells at once - armed once the button reads released
+  if (EMERGENCY_STOP) {
+    EmergencyStop::begin(PAUSE_BUTTON, RELAY_PINS, NUM_PHONES, RINGER_POWER_PIN);
   }
   
+  // Register the tasks - order is the run order within a frame
+  scheduler.addTask(F("input"), inputTask);
+  ringerTaskId = scheduler.addTask(F("ringers"), ringerTask);
+  displayTaskId = scheduler.addTask(F("display"), displayTask);
+  outputTaskId = scheduler.addTask(F("outputs"), outputTask);
+  statusLedTaskId = scheduler.addTask(F("status LED"), statusLedTask);
+  stressTaskId = scheduler.addTask(F("stress"), stressTask, STRESS_IDLE_INTERVAL);
+  scenarioTaskId = scheduler.addTask(F("show"), scenarioTask, ScenarioPlayer::IDLE_INTERVAL);
+  scheduler.addTask(F("wear"), wearTask, WEAR_SAVE_INTERVAL);
+  
+  // Ringer state changes wake the tasks that show or act on them
+  EventBus::subscribe(EventBus::ALL_EVENTS, onDisplayEvent);
+  EventBus::subscribe(EventBus::maskOf(EventBus::CALL_STARTED) | EventBus::maskOf(EventBus::CALL_ENDED), onPowerEvent);
+  EventBus::subscribe(EventBus::maskOf(EventBus::RING_ON) | EventBus::maskOf(EventBus::RING_OFF) |
+                      EventBus::maskOf(EventBus::CALL_ENDED), onStatusLedEvent);
+  
   // System initialization complete - turn on ready LED
   digitalWrite(READY_LED, HIGH);
+  BootManager::markReady();
+  
+  relayWear.printStatus();
+  DebugSerial.print(F("Boot to ready: "));
+  DebugSerial.print(BootManager::getBootTime());
+  DebugSerial.print(F("ms (reset: "));
+  DebugSerial.print(BootManager::getResetCauseString());
+  DebugSerial.print(F(", seed: "));
+  DebugSerial.print(ringerManager.getRandomSeed());
+  if (seedBits > 0) {
+    DebugSerial.print(F(" from "));
+    DebugSerial.print(seedBits);
+    DebugSerial.print(F(" pool bits"));
+  }
+  DebugSerial.println(F(")"));
 }
 
 void loop() {
-  unsigned long currentTime = millis();
+  // Run whatever is due this frame
+  scheduler.run();
   
-  // Check pause button
+  // Hand this frame's ringer events to their subscribers
+  EventBus::dispatch();
+  
+  // Loop period distribution for the stress test
+  if (stressTest.isRunning()) {
+    stressTest.recordLoop(micros());
+  }
+}
+
+// Input - pause button, encoder and the settings they change
+unsigned long inputTask(unsigned long now) {
+  inputs.update(now);  // One sample of every button and encoder line
   checkPauseButton();
+  checkSerialCommands();
   
-  // Handle encoder events
-  handleEncoderEvents();
+  // Redraw right away after user input instead of waiting for the next refresh
+  if (handleEncoderEvents(now)) {
+    scheduler.wakeTask(displayTaskId);
+  }
   
+  applySettingChanges();
+  return INPUT_TASK_INTERVAL;
+}
+
+// Ringers - sleeps until the next ring edge, arrival or wait expiry
+unsigned long ringerTask(unsigned long now) {
   // Only step the ringer manager if not paused AND we have active relays
-  if (!systemPaused && activeRelaySetting > 0) {
-    ringerManager.step(currentTime);
+  if (relaysHeld() || activeRelaySetting == 0) {
+    return RINGER_MAX_SLEEP;  // Woken when this changes
   }
   
+  ringerManager.step(now);
+  unsigned long nextEvent = ringerManager.getTimeToNextEvent(now);
+  return min(nextEvent, RINGER_MAX_SLEEP);
+}
+
+// Display - only when not in menu mode (menu screens are drawn by the input handler)
+unsigned long displayTask(unsigned long now) {
+  if (ui.isOpen() || stressResultsShown) {
+    return DISPLAY_TASK_INTERVAL;
+  }
+  
+  if (callStatsShown) {
+    char lines[4][21];
+    callStats.formatPage(lines, ringerManager.getClock().now());
+    displayManager.showMessage(lines[0], lines[1], lines[2], lines[3]);
+    return STATS_PAGE_INTERVAL;
+  }
+  
+  // Stress test: redraw the whole status screen every time, and time it
+  if (stressTest.isRunning()) {
+    displayManager.invalidate();
+    unsigned long start = micros();
+    displayManager.update(now, systemPaused, &ringerManager, maxConcurrentSetting);
+    stressTest.recordLcd(micros() - start);
+    return STRESS_DISPLAY_INTERVAL;
+  }
+  
+  displayManager.update(now, systemPaused, &ringerManager, maxConcurrentSetting);
+  return DISPLAY_TASK_INTERVAL;
+}
+
+// Outputs - ringer power supply with hang time
+unsigned long outputTask(unsigned long now) {
+  return updateRingerPowerControl(now);
+}
+
+// Relay wear - counters to EEPROM now and then (each save goes to the next of its slots)
+unsigned long wearTask(unsigned long now) {
+  (void)now;
+  relayWear.save();
+  return WEAR_SAVE_INTERVAL;
+}
+
+// Status LED - blinks at 5 Hz while paused, solid ON while any phone rings
+unsigned long statusLedTask(unsigned long now) {
+  (void)now;
+  TASK_BEGIN();
+  for (;;) {
+    if (systemPaused) {
+      digitalWrite(STATUS_LED, HIGH);
+      statusLedState = true;
+      TASK_DELAY(PAUSE_BLINK_INTERVAL);
+      digitalWrite(STATUS_LED, LOW);
+      statusLedState = false;
+      TASK_DELAY(PAUSE_BLINK_INTERVAL);
+    } else {
+      // Only update LED if state needs to change (avoid unnecessary writes) - ring events wake us
+      // No locals here - they wouldn't survive TASK_DELAY()
+      if (statusLedState != (ringerManager.getRingingPhoneCount() > 0)) {
+        statusLedState = !statusLedState;
+        digitalWrite(STATUS_LED, statusLedState ? HIGH : LOW);
+      }
+      TASK_DELAY(STATUS_LED_INTERVAL);
+    }
+  }
+  TASK_END();
+}
+
+// Stress test - keeps every line in a call and plays the encoder script until the run is over
+unsigned long stressTask(unsigned long now) {
+  if (!stressTest.isRunning()) {
+    return STRESS_IDLE_INTERVAL;
+  }
+  
+  // Pausing kills the relays, so the run would measure nothing - treat it as an abort
+  if (relaysHeld() || stressTest.isFinished(now)) {
+    finishStressTest();
+    return STRESS_IDLE_INTERVAL;
+  }
+  
+  bool callStarted = false;
+  for (int i = 0; i < NUM_PHONES; i++) {
+    if (!ringerManager.isPhoneActive(i)) {
+      ringerManager.startCall(i);
+      callStarted = true;
+    }
+  }
+  if (callStarted) {
+    scheduler.wakeTask(ringerTaskId);
+  }
+  
+  // Scripted turns and presses go through the same handler as the real encoder
+  EncoderManager::EncoderEvent event = stressTest.nextInput(MENU_ITEM_COUNT);
+  if (event != EncoderManager::NONE && handleInputEvent(event, 1)) {
+    scheduler.wakeTask(displayTaskId);
+  }
+  return StressTest::INPUT_INTERVAL;
+}
+
+// Show - runs the script's instructions as they come due
+unsigned long scenarioTask(unsigned long now) {
+  if (!scenario.isRunning()) {
+    return ScenarioPlayer::IDLE_INTERVAL;
+  }
+  
+  // The show holds while paused (it catches up on its current wait afterwards)
+  if (relaysHeld()) {
+    return ScenarioPlayer::IDLE_INTERVAL;
+  }
+  
+  uint16_t callsPerHour = scenario.getCallsPerHour();
+  unsigned long nextStep = scenario.step(now);
+  if (scenario.getCallsPerHour() != callsPerHour) {
+    updateArrivalRate();
+  }
+  if (!scenario.isRunning()) {
+    stopShow();  // Reached the end of the script
+  }
+  
+  // Setting changes are picked up by applySettingChanges(), started calls need the ringers now
+  scheduler.wakeTask(ringerTaskId);
+  return nextStep;
+}
+
+// Display - anything on the status screen may have changed
+void onDisplayEvent(const EventBus::Event& event) {
+  (void)event;
+  displayManager.invalidate();
+  scheduler.wakeTask(displayTaskId);
+}
+
+// Ringer power - the active call count only moves when a call starts or ends
+void onPowerEvent(const EventBus::Event& event) {
+  (void)event;
+  scheduler.wakeTask(outputTaskId);
+}
+
+// Status LED - follows whether any bell is ringing
+void onStatusLedEvent(const EventBus::Event& event) {
+  (void)event;
+  scheduler.wakeTask(statusLedTaskId);
+}
+
+// Push any settings changed from the encoder/menu into the ringer manager
+void applySettingChanges() {
+  bool changed = false;
+  
   // If active relay count changed, update RingerManager
   static int lastActiveRelayCount = activeRelaySetting;
   if (lastActiveRelayCount != activeRelaySetting) {
     ringerManager.setActiveRelayCount(activeRelaySetting);
     lastActiveRelayCount = activeRelaySetting;
+    updateArrivalRate();
+    changed = true;
   }
   
-  // Update display (only when not in menu mode)
-  if (!inMenu) {
-    displayManager.update(currentTime, systemPaused, &ringerManager, maxConcurrentSetting);
+  // If concurrent limit changed, update the admission controller
+  static int lastMaxConcurrent = maxConcurrentSetting;
+  if (lastMaxConcurrent != maxConcurrentSetting) {
+    ringerManager.setMaxConcurrent(maxConcurrentSetting);
+    lastMaxConcurrent = maxConcurrentSetting;
+    changed = true;
   }
   
-  // Update ringer power control
-  updateRingerPowerControl();
-  
-  // Update status LED
-  updateStatusLED();
+  // If call timing changed, update the arrival rate
+  static int lastCallDelaySetting = maxCallDelaySetting;
+  if (lastCallDelaySetting != maxCallDelaySetting) {
+    lastCallDelaySetting = maxCallDelaySetting;
+    updateArrivalRate();
+    changed = true;
+  }
   
-  // Small delay to prevent overwhelming the system
-  delay(10);
+  // Ringer deadlines may have moved - let the ringer task recompute them
+  if (changed) {
+    scheduler.wakeTask(ringerTaskId);
+  }
+}
+
+// Paused, or the emergency stop has cut the outputs and the pause below hasn't caught up yet
+bool relaysHeld() {
+  return systemPaused || EmergencyStop::isTripped();
 }
 
+// Pause button toggles on the debounced press edge. With the emergency stop
+// the press has already cut relays and power from its interrupt by then -
+// this catches the rest of the system up.
 void checkPauseButton() {
-  bool currentButtonState = digitalRead(PAUSE_BUTTON);
-  
-  // Simple debounce: if button state changed, reset debounce timer
-  if (currentButtonState != lastPauseButtonState) {
-    lastPauseDebounce = millis();
-    pauseButtonPressed = false; // Reset press flag
+  if (EmergencyStop::isTripped()) {
+    unsigned long noticed = micros();
+    togglePause();
+    unsigned long lag = EmergencyStop::acknowledge(noticed);  // Only once the pause has cancelled every edge
+    stopCaughtUpAt = millis();
+    DebugSerial.print(F("Emergency stop: relays cut, main loop noticed "));
+    DebugSerial.print(lag);
+    DebugSerial.print(F("us later (worst "));
+    DebugSerial.print(EmergencyStop::getMaxCatchUpMicros());
+    DebugSerial.println(F("us)"));
+    return;
   }
   
-  // Check if enough time has passed for debounce
-  if ((millis() - lastPauseDebounce) > DEBOUNCE_DELAY) {
-    // If button is pressed (LOW) and we haven't processed this press yet
-    if (currentButtonState == LOW && !pauseButtonPressed) {
-      pauseButtonPressed = true; // Mark as processed
-      
-      // Toggle pause state
-      systemPaused = !systemPaused;
-      
-      if (systemPaused) {
-        // Turn off all relays immediately but don't stop the call state machines
-        // This preserves timing so calls remain unsynchronized when resumed
-        for (int i = 0; i < NUM_PHONES; i++) {
-          digitalWrite(RELAY_PINS[i], HIGH); // HIGH = inactive for active-LOW relay modules
-        }
-        displayManager.showPauseMessage();
-      } else {
-        displayManager.showResumeMessage();
-      }
-    }
-    
-    // Reset press flag when button is released
-    if (currentButtonState == HIGH) {
-      pauseButtonPressed = false;
-    }
+  // Re-arm after the resume press - released and debounced, so its bounce can't trip it
+  if (EMERGENCY_STOP && !systemPaused && !EmergencyStop::isArmed() && inputs.read(PAUSE_BUTTON) == HIGH) {
+    EmergencyStop::arm();
   }
   
-  // Update the last button state
-  lastPauseButtonState = currentButtonState;
+  if (!inputs.pressed(PAUSE_BUTTON)) {
+    return;
+  }
+  // The press that tripped the stop reaches the debouncer afterwards - it mustn't resume
+  if (stopCaughtUpAt != 0 && millis() - stopCaughtUpAt < STOP_PRESS_HOLDOFF_MS) {
+    return;
+  }
+  togglePause();
 }
 
-void updateStatusLED() {
-  unsigned long currentTime = millis();
+void togglePause() {
+  // Toggle pause state - the pause and resume screens replace the stats page
+  systemPaused = !systemPaused;
+  callStatsShown = false;
   
   if (systemPaused) {
-    // System is paused - blink at 5 Hz (100ms toggle interval)
-    if (currentTime - lastStatusLedToggle >= PAUSE_BLINK_INTERVAL) {
-      statusLedState = !statusLedState;
-      digitalWrite(STATUS_LED, statusLedState ? HIGH : LOW);
-      lastStatusLedToggle = currentTime;
-    }
+    // Relays off and line time frozen - every line resumes exactly where it was,
+    // so calls stay as spread out as they were before the pause
+    ringerManager.pause(millis());
+    displayManager.showPauseMessage();
+    relayWear.save();  // Often the last thing before the power goes off
   } else {
-    // System is running - solid ON if any phone is ringing, OFF if idle
-    int ringingPhones = ringerManager.getRingingPhoneCount();
-    bool shouldBeOn = (ringingPhones > 0);
-    
-    // Only update LED if state needs to change (avoid unnecessary writes)
-    if (statusLedState != shouldBeOn) {
-      statusLedState = shouldBeOn;
-      digitalWrite(STATUS_LED, statusLedState ? HIGH : LOW);
-    }
+    ringerManager.resume(millis());
+    displayManager.showResumeMessage();
   }
+  
+  // Ringers stop or restart stepping, power and LED follow the pause state
+  scheduler.wakeTask(ringerTaskId);
+  scheduler.wakeTask(outputTaskId);
+  scheduler.wakeTask(statusLedTaskId);
 }
 
-// Control ringer power with hang time
-void updateRingerPowerControl() {
-  unsigned long currentTime = millis();
-  
-  if (systemPaused) {
+// Control ringer power with hang time - returns how long until it needs checking again
+unsigned long updateRingerPowerControl(unsigned long currentTime) {
+  if (relaysHeld()) {
     // System paused - immediately turn off ringer power
     if (ringerPowerActive) {
       ringerPowerActive = false;
       digitalWrite(RINGER_POWER_PIN, HIGH);  // HIGH = off for active LOW
     }
-    return;
+    return OUTPUT_TASK_INTERVAL;
   }
   
   // Check if any phones are active (ringing or in active call state)
@@ -280,226 +629,125 @@ void updateRingerPowerControl() {
     // Phones are active - turn on ringer power if not already on
     if (!ringerPowerActive) {
       ringerPowerActive = true;
-      digitalWrite(RINGER_POWER_PIN, LOW);  // LOW = on for active LOW
+      EmergencyStop::writeOutput(RINGER_POWER_PIN, LOW);  // LOW = on for active LOW (refused while tripped)
     }
-    // Reset the hang timer while phones are active
+    ringerCallsActive = true;
+    return OUTPUT_TASK_INTERVAL;
+  }
+  
+  // Last call just ended (we're woken by its event) - hang time starts now
+  if (ringerCallsActive) {
+    ringerCallsActive = false;
     ringerPowerStartTime = currentTime;
-  } else {
-    // No active phones - check hang time
-    if (ringerPowerActive) {
-      if (currentTime - ringerPowerStartTime >= (ringerHangTimeSetting * 1000UL)) {
-        // Hang time expired, turn off ringer power
-        ringerPowerActive = false;
-        digitalWrite(RINGER_POWER_PIN, HIGH);  // HIGH = off for active LOW
-      }
+  }
+  
+  // No active phones - check hang time
+  if (ringerPowerActive) {
+    unsigned long hangTime = ringerHangTimeSetting * 1000UL;
+    unsigned long elapsed = currentTime - ringerPowerStartTime;
+    if (elapsed < hangTime) {
+      return min(hangTime - elapsed, OUTPUT_TASK_INTERVAL);
     }
+    // Hang time expired, turn off ringer power
+    ringerPowerActive = false;
+    digitalWrite(RINGER_POWER_PIN, HIGH);  // HIGH = off for active LOW
   }
+  return OUTPUT_TASK_INTERVAL;
 }
 
-// Check if a new call can start (respects concurrent phone limit AND active relay count)
-bool canStartNewCall() {
-  if (globalRingerManager == nullptr) {
-    return false;  // Safety check
+// Map the Call Timing setting onto a system-wide arrival rate: each active
+// line averages one call per (5s + max delay), matching the per-line model's spacing
+void updateArrivalRate() {
+  unsigned long callsPerHour = scenario.getCallsPerHour();  // A show can set the rate directly
+  if (callsPerHour == 0) {
+    callsPerHour = (unsigned long)activeRelaySetting * 3600UL / (5UL + maxCallDelaySetting);
   }
+  ringerManager.setCallsPerHour(callsPerHour);
+}
+
+// Handle rotary encoder input
+bool handleEncoderEvents(unsigned long currentTime) {
+  EncoderManager::EncoderEvent event = encoderManager.update(currentTime);
   
-  // No calls allowed if active relays is 0
-  if (activeRelaySetting == 0) {
+  if (event == EncoderManager::NONE) {
     return false;
   }
   
-  int currentActivePhones = globalRingerManager->getActiveCallCount();
-  bool canStart = currentActivePhones < maxConcurrentSetting;
+  // The stress script owns the UI during a run - a long press aborts it
+  if (stressTest.isRunning()) {
+    if (event == EncoderManager::BUTTON_LONG_PRESS) {
+      finishStressTest();
+    }
+    return true;
+  }
+  
+  // Stress results stay up until the knob is touched
+  if (stressResultsShown || callStatsShown) {
+    stressResultsShown = false;
+    callStatsShown = false;
+    displayManager.invalidate();
+    scheduler.wakeTask(displayTaskId);
+    return true;
+  }
   
-  return canStart;
+  return handleInputEvent(event, encoderManager.getStepMultiplier());
 }
 
-// Handle rotary encoder input
-void handleEncoderEvents() {
-  EncoderManager::EncoderEvent event = encoderManager.update();
-  
-  if (event != EncoderManager::NONE) {
-    // Handle button press for menu toggle/selection
-    if (event == EncoderManager::BUTTON_PRESS) {
-      if (!inMenu) {
-        inMenu = true;
-        inAdjustmentMode = false;
-        currentMenuItem = 0;  // Start at first menu item
-        displayManager.showMenuMessage("* SETTINGS *", menuItemNames[currentMenuItem], 
-                                   "Turn: Navigate", "Press: Select/Exit");
+bool handleInputEvent(EncoderManager::EncoderEvent event, uint8_t stepMultiplier) {
+  // The menu takes turns and presses while it's open
+  if (ui.handleEvent(event, stepMultiplier)) {
+    return true;
+  }
+  
+  if (ui.isOpen()) {
+    if (event == EncoderManager::BUTTON_LONG_PRESS) {
+      // Long press on "Exit Menu" is the hidden stress test entry,
+      // anywhere else it's Menu Long-Press: Save & Exit
+      if (!ui.isAdjusting() && ui.getCurrentItem() == MENU_ITEM_COUNT - 1) {
+        startStressTest();
       } else {
-        // In menu - handle selection
-        if (inAdjustmentMode) {
-          // We're adjusting a setting - save and return to menu navigation
-          
-          // Save all settings to EEPROM when any setting is changed
-          saveSettingsToEEPROM();
-          
-          inAdjustmentMode = false;  // Exit adjustment mode but stay in menu
-          // Show the current menu item again
-          displayManager.showMenuMessage("* SETTINGS *", menuItemNames[currentMenuItem], 
-                                     "Turn: Navigate", "Press: Select/Exit");
-        } else {
-          // Not in adjustment mode - handle menu selection
-          switch (currentMenuItem) {
-            case MENU_CONCURRENT_LIMIT:
-              inAdjustmentMode = true;  // Enter adjustment mode
-              snprintf(menuBuffer2, sizeof(menuBuffer2), "Setting: %d", maxConcurrentSetting);
-              displayManager.showMessage("Max Concurrent", 
-                                         menuBuffer2,
-                                         "Turn: Adjust (1-8)", "Press: Save & Back");
-              break;
-              
-            case MENU_ACTIVE_RELAYS:
-              inAdjustmentMode = true;  // Enter adjustment mode
-              snprintf(menuBuffer2, sizeof(menuBuffer2), "Setting: %d", activeRelaySetting);
-              displayManager.showMessage("Active Phones", 
-                                         menuBuffer2,
-                                         "Turn: Adjust (0-8)", "Press: Save & Back");
-              break;
-              
-            case MENU_CALL_FREQUENCY:
-              inAdjustmentMode = true;  // Enter adjustment mode
-              snprintf(menuBuffer2, sizeof(menuBuffer2), "Max: %ds", maxCallDelaySetting);
-              displayManager.showMessage("Call Timing", 
-                                         menuBuffer2,
-                                         "Turn: +/-10s (10-1000)", "Press: Save & Back");
-              break;
-              
-            case MENU_RINGER_HANG_TIME:
-              inAdjustmentMode = true;  // Enter adjustment mode
-              snprintf(menuBuffer2, sizeof(menuBuffer2), "Setting: %ds", ringerHangTimeSetting);
-              displayManager.showMessage("Ringer Hang Time", 
-                                         menuBuffer2,
-                                         "Turn: +/-1s (0-60)", "Press: Save & Back");
-              break;
-              
-            case MENU_EXIT:
-              inMenu = false;
-              inAdjustmentMode = false;
-              displayManager.showStatus(&ringerManager, systemPaused, maxConcurrentSetting);
-              break;
-          }
-        }
+        saveAndExitMenu();
       }
-      return;
     }
-    
-    // Handle rotation events
-    if (inMenu) {
-      switch (event) {
-        case EncoderManager::CLOCKWISE:
-          if (inAdjustmentMode && currentMenuItem == MENU_CONCURRENT_LIMIT && maxConcurrentSetting < 8) {
-            // If we're adjusting concurrent limit, increment the value
-            maxConcurrentSetting++;
-            snprintf(menuBuffer2, sizeof(menuBuffer2), "Setting: %d", maxConcurrentSetting);
-            displayManager.showMessage("Max Concurrent", 
-                                       menuBuffer2,
-                                       "Turn: Adjust (1-8)", "Press: Save & Back");
-          } else if (inAdjustmentMode && currentMenuItem == MENU_ACTIVE_RELAYS && activeRelaySetting < 8) {
-            // If we're adjusting active relay count, increment the value
-            activeRelaySetting++;
-            snprintf(menuBuffer2, sizeof(menuBuffer2), "Setting: %d", activeRelaySetting);
-            displayManager.showMessage("Active Phones", 
-                                       menuBuffer2,
-                                       "Turn: Adjust (0-8)", "Press: Save & Back");
-          } else if (inAdjustmentMode && currentMenuItem == MENU_CALL_FREQUENCY && maxCallDelaySetting < 1000) {
-            // If we're adjusting call frequency, increment the value
-            maxCallDelaySetting += 10;
-            snprintf(menuBuffer2, sizeof(menuBuffer2), "Max: %ds", maxCallDelaySetting);
-            displayManager.showMessage("Call Timing", 
-                                       menuBuffer2,
-                                       "Turn: +/-10s (10-1000)", "Press: Save & Back");
-          } else if (inAdjustmentMode && currentMenuItem == MENU_RINGER_HANG_TIME && ringerHangTimeSetting < 60) {
-            // If we're adjusting ringer hang time, increment the value
-            ringerHangTimeSetting++;
-            snprintf(menuBuffer2, sizeof(menuBuffer2), "Setting: %ds", ringerHangTimeSetting);
-            displayManager.showMessage("Ringer Hang Time", 
-                                       menuBuffer2,
-                                       "Turn: +/-1s (0-60)", "Press: Save & Back");
-          } else if (!inAdjustmentMode) {
-            // Navigate to next menu item
-            currentMenuItem = (currentMenuItem + 1) % MENU_ITEM_COUNT;
-            displayManager.showMenuMessage("* SETTINGS *", menuItemNames[currentMenuItem], 
-                                       "Turn: Navigate", "Press: Select/Exit");
-          }
-          break;
-          
-        case EncoderManager::COUNTER_CLOCKWISE:
-          if (inAdjustmentMode && currentMenuItem == MENU_CONCURRENT_LIMIT && maxConcurrentSetting > 1) {
-            // If we're adjusting concurrent limit, decrement the value
-            maxConcurrentSetting--;
-            snprintf(menuBuffer2, sizeof(menuBuffer2), "Setting: %d", maxConcurrentSetting);
-            displayManager.showMessage("Max Concurrent", 
-                                       menuBuffer2,
-                                       "Turn: Adjust (1-8)", "Press: Save & Back");
-          } else if (inAdjustmentMode && currentMenuItem == MENU_ACTIVE_RELAYS && activeRelaySetting > 0) {
-            // If we're adjusting active relay count, decrement the value
-            activeRelaySetting--;
-            snprintf(menuBuffer2, sizeof(menuBuffer2), "Setting: %d", activeRelaySetting);
-            displayManager.showMessage("Active Phones", 
-                                       menuBuffer2,
-                                       "Turn: Adjust (0-8)", "Press: Save & Back");
-          } else if (inAdjustmentMode && currentMenuItem == MENU_CALL_FREQUENCY && maxCallDelaySetting > 10) {
-            // If we're adjusting call frequency, decrement the value
-            maxCallDelaySetting -= 10;
-            snprintf(menuBuffer2, sizeof(menuBuffer2), "Max: %ds", maxCallDelaySetting);
-            displayManager.showMessage("Call Timing", 
-                                       menuBuffer2,
-                                       "Turn: +/-10s (10-1000)", "Press: Save & Back");
-          } else if (inAdjustmentMode && currentMenuItem == MENU_RINGER_HANG_TIME && ringerHangTimeSetting > 0) {
-            // If we're adjusting ringer hang time, decrement the value
-            ringerHangTimeSetting--;
-            snprintf(menuBuffer2, sizeof(menuBuffer2), "Setting: %ds", ringerHangTimeSetting);
-            displayManager.showMessage("Ringer Hang Time", 
-                                       menuBuffer2,
-                                       "Turn: +/-1s (0-60)", "Press: Save & Back");
-          } else if (!inAdjustmentMode) {
-            // Navigate to previous menu item
-            currentMenuItem = (currentMenuItem - 1 + MENU_ITEM_COUNT) % MENU_ITEM_COUNT;
-            displayManager.showMenuMessage("* SETTINGS *", menuItemNames[currentMenuItem], 
-                                       "Turn: Navigate", "Press: Select/Exit");
-          }
-          break;
-          
-        case EncoderManager::BUTTON_LONG_PRESS:
-          // Menu Long-Press: Save & Exit from any menu state
-          saveAndExitMenu();
-          break;
-          
-        default:
-          break;
+    return true;
+  }
+  
+  // Not in menu - normal operation mode
+  // Encoder rotation adjusts active relay count directly
+  switch (event) {
+    case EncoderManager::BUTTON_PRESS:
+      ui.open();
+      break;
+      
+    case EncoderManager::CLOCKWISE:
+      if (activeRelaySetting < 8) {
+        activeRelaySetting++;
+        // Show brief +1 feedback and save to EEPROM
+        displayManager.showRelayAdjustmentDirection(activeRelaySetting, true);
+        saveSettingsToEEPROM();
       }
-    } else {
-      // Not in menu - normal operation mode
-      // Encoder rotation adjusts active relay count directly
-      switch (event) {
-        case EncoderManager::CLOCKWISE:
-          if (activeRelaySetting < 8) {
-            activeRelaySetting++;
-            // Show brief +1 feedback and save to EEPROM
-            displayManager.showRelayAdjustmentDirection(activeRelaySetting, true);
-            saveSettingsToEEPROM();
-          }
-          break;
-          
-        case EncoderManager::COUNTER_CLOCKWISE:
-          if (activeRelaySetting > 0) {
-            activeRelaySetting--;
-            // Show brief -1 feedback and save to EEPROM
-            displayManager.showRelayAdjustmentDirection(activeRelaySetting, false);
-            saveSettingsToEEPROM();
-          }
-          break;
-          
-        case EncoderManager::BUTTON_LONG_PRESS:
-          activateMaximumChaos();
-          break;
-          
-        default:
-          break;
+      break;
+      
+    case EncoderManager::COUNTER_CLOCKWISE:
+      if (activeRelaySetting > 0) {
+        activeRelaySetting--;
+        // Show brief -1 feedback and save to EEPROM
+        displayManager.showRelayAdjustmentDirection(activeRelaySetting, false);
+        saveSettingsToEEPROM();
       }
-    }
+      break;
+      
+    case EncoderManager::BUTTON_LONG_PRESS:
+      if (Features::CHAOS_MODE) {
+        activateMaximumChaos();
+      }
+      break;
+      
+    default:
+      break;
   }
+  
+  return true;
 }
 
 // Function to load settings from EEPROM
@@ -525,6 +773,12 @@ void saveSettingsToEEPROM() {
   settings.maxCallDelay = maxCallDelaySetting;
   settings.ringerHangTime = ringerHangTimeSetting;
   
+  // A show's changes are never saved - keep what was set before it started
+  if (scenario.isRunning()) {
+    settings = showSavedSettings;
+    settings.ringerHangTime = ringerHangTimeSetting;  // The show doesn't touch this one
+  }
+  
   SettingsManager::saveSettings(settings);
 }
 
@@ -535,9 +789,8 @@ void activateMaximumChaos() {
   activeRelaySetting = CHAOS_ACTIVE_RELAYS;
   maxCallDelaySetting = CHAOS_MIN_CALL_DELAY;
   
-  // Re-seed with maximum entropy for true chaos
-  RandomSeed<A1> chaosRNG;
-  chaosRNG.randomize();
+  // Re-seed for true chaos - the pool has been collecting since the last seed
+  ringerManager.seedRandom(EntropyPool::takeSeed());
   
   // Save chaos settings to EEPROM for persistence
   saveSettingsToEEPROM();
@@ -561,8 +814,144 @@ void saveAndExitMenu() {
   displayManager.showSaveExitMessage();
   
   // Exit menu mode and return to normal operation
-  inMenu = false;
-  inAdjustmentMode = false;
+  ui.close();
   
   // The normal status display will resume automatically via the main loop
 }
+
+// Menu "Exit Menu" item - straight back to the status screen
+void exitMenu() {
+  ui.close();
+  displayManager.showStatus(&ringerManager, systemPaused, maxConcurrentSetting);
+}
+
+// Menu "Call Stats" item - the page stays up, updated every second, until the knob is touched
+void showCallStats() {
+  ui.close();
+  callStatsShown = true;
+  scheduler.wakeTask(displayTaskId);
+}
+
+// Ringer power task sleeps through the hang time - recompute it with the new value
+void wakeOutputTask() {
+  scheduler.wakeTask(outputTaskId);
+}
+
+// Serial commands - stress test and call statistics
+void checkSerialCommands() {
+  while (DebugSerial.available() > 0) {
+    int command = DebugSerial.read();
+    if (command == STRESS_TEST_COMMAND) {
+      if (stressTest.isRunning()) {
+        finishStressTest();
+      } else {
+        startStressTest();
+      }
+    } else if (command == CALL_STATS_COMMAND) {
+      callStats.printReport(ringerManager.getClock().now());
+    }
+  }
+}
+
+// 🧪 STRESS TEST - worst case like Maximum Chaos, but nothing is saved to EEPROM
+void startStressTest() {
+  if (stressTest.isRunning()) {
+    return;
+  }
+  if (systemPaused) {
+    DebugSerial.println(F("Stress test: resume the system first"));
+    return;
+  }
+  
+  ui.close();
+  stressResultsShown = false;
+  callStatsShown = false;
+  stopShow();  // The run needs the settings to itself
+  
+  stressSavedSettings.maxConcurrent = maxConcurrentSetting;
+  stressSavedSettings.activeRelays = activeRelaySetting;
+  stressSavedSettings.maxCallDelay = maxCallDelaySetting;
+  stressSavedSettings.ringerHangTime = ringerHangTimeSetting;
+  maxConcurrentSetting = CHAOS_MAX_CONCURRENT;
+  activeRelaySetting = CHAOS_ACTIVE_RELAYS;
+  maxCallDelaySetting = CHAOS_MIN_CALL_DELAY;
+  applySettingChanges();
+  
+  // Measure this run only
+  RelayEdgeEngine::resetStats();
+  scheduler.resetStats();
+  displayManager.resetStats();
+  
+  DebugSerial.print(F("Stress test: "));
+  DebugSerial.print(StressTest::DEFAULT_DURATION / 1000);
+  DebugSerial.println(F("s run started"));
+  
+  stressTest.start(millis());
+  scheduler.wakeTask(stressTaskId);
+  scheduler.wakeTask(displayTaskId);
+}
+
+void finishStressTest() {
+  stressTest.stop();
+  unsigned long edgeLateness = RelayEdgeEngine::getMaxLatenessMicros();
+  uint16_t overruns = scheduler.getTotalOverruns();
+  
+  // Hang up the forced calls and go back to the user's settings
+  ui.close();
+  ringerManager.stopAllCalls();
+  maxConcurrentSetting = stressSavedSettings.maxConcurrent;
+  activeRelaySetting = stressSavedSettings.activeRelays;
+  maxCallDelaySetting = stressSavedSettings.maxCallDelay;
+  ringerHangTimeSetting = stressSavedSettings.ringerHangTime;
+  applySettingChanges();
+  
+  stressTest.printReport(edgeLateness, overruns);
+  unsigned long halfCycle = RelayEdgeEngine::getHalfCycleMicros();
+  DebugSerial.print(F("  Zero-cross: "));
+  if (halfCycle == 0) {
+    DebugSerial.println(F("no signal"));
+  } else {
+    DebugSerial.print(500000UL / halfCycle);
+    DebugSerial.print(F("Hz, edges batched onto "));
+    DebugSerial.print(RelayEdgeEngine::getSyncedBatches());
+    DebugSerial.println(F(" crossings"));
+  }
+  scheduler.printStatus();
+  displayManager.printStatus();
+  
+  char lines[4][21];
+  stressTest.formatSummary(lines, edgeLateness, overruns);
+  displayManager.showMessage(lines[0], lines[1], lines[2], lines[3]);
+  stressResultsShown = true;
+}
+
+// 🎭 SHOW SCRIPT - play SHOW_SCENARIO from the top, or stop it
+void applyShowSetting() {
+  if (showSetting && !scenario.isRunning()) {
+    showSavedSettings.maxConcurrent = maxConcurrentSetting;
+    showSavedSettings.activeRelays = activeRelaySetting;
+    showSavedSettings.maxCallDelay = maxCallDelaySetting;
+    if (!scenario.start(SHOW_SCENARIO, millis())) {
+      showSetting = 0;  // Script built for another player version
+      return;
+    }
+    scheduler.wakeTask(scenarioTaskId);
+  } else if (!showSetting && scenario.isRunning()) {
+    stopShow();
+  }
+}
+
+void stopShow() {
+  bool wasPlaying = scenario.isRunning() || showSetting;
+  scenario.stop();
+  showSetting = 0;
+  if (!wasPlaying) {
+    return;
+  }
+  
+  maxConcurrentSetting = showSavedSettings.maxConcurrent;
+  activeRelaySetting = showSavedSettings.activeRelays;
+  maxCallDelaySetting = showSavedSettings.maxCallDelay;
+  applySettingChanges();
+  updateArrivalRate();  // The show's rate override is gone
+}